@@ -167,6 +167,32 @@ ELSE ()
 ENDIF ()
 
 
+# ===================
+# == External BLAS ==
+# ===================
+# When enabled, CPU matrix multiplication in gemm_cpu() is done by cblas_sgemm() from OpenBLAS, BLIS, MKL, etc.
+# Use BLA_VENDOR to pick a specific library, e.g. "cmake -DENABLE_EXTERNAL_BLAS=ON -DBLA_VENDOR=OpenBLAS ..."
+CMAKE_DEPENDENT_OPTION (ENABLE_EXTERNAL_BLAS "Use an external BLAS library for CPU matrix multiplication" OFF "" OFF)
+IF (ENABLE_EXTERNAL_BLAS)
+	FIND_PACKAGE (BLAS QUIET)
+	FIND_PATH (cblas_include NAMES cblas.h mkl_cblas.h
+				HINTS ENV MKLROOT ENV OPENBLAS_HOME ENV BLIS_HOME
+				PATH_SUFFIXES include include/openblas include/blis include/mkl openblas blis mkl)
+	IF (BLAS_FOUND AND cblas_include)
+		MESSAGE (STATUS "Found BLAS: ${BLAS_LIBRARIES}")
+		MESSAGE (STATUS "Found CBLAS include: ${cblas_include}")
+		INCLUDE_DIRECTORIES (${cblas_include})
+		ADD_COMPILE_DEFINITIONS (DARKNET_USE_CBLAS)
+		IF (NOT EXISTS "${cblas_include}/cblas.h")
+			ADD_COMPILE_DEFINITIONS (DARKNET_USE_MKL_CBLAS)
+		ENDIF ()
+		SET (DARKNET_LINK_LIBS ${DARKNET_LINK_LIBS} BLAS::BLAS)
+	ELSE ()
+		MESSAGE (WARNING "External BLAS requested but not found. Darknet will use the built-in GEMM kernels.")
+	ENDIF ()
+ENDIF ()
+
+
 # ============
 # == Timing ==
 # ============
@@ -198,6 +198,85 @@ void partial(char *cfgfile, char *weightfile, char *outfile, int max)
 }
 
 
+/** Convert between the classic .weights format and the memory-mapped format from @ref save_mapped_weights().  The
+ * direction depends on the format of the input file.  Each tensor is written directly from the network, so the only
+ * memory needed is the network itself, and a mapped input file is never copied.
+ *
+ * @since 2026-10-17
+ */
+void convert_weights(int argc, char *argv[])
+{
+	TAT(TATPARMS);
+
+	if (argc < 5)
+	{
+		throw std::invalid_argument("usage: " + std::string(argv[0]) + " convert <cfg> <input weights> <output weights>");
+	}
+
+	const char * cfgfile	= argv[2];
+	const char * weightfile	= argv[3];
+	const char * outfile	= argv[4];
+
+	Darknet::CfgAndState::get().gpu_index = -1;
+	Darknet::Network net = parse_network_cfg_custom(cfgfile, 1, 1);
+
+	// remember which layers use batch norm, since loading mapped weights removes it from convolutional layers
+	std::vector<bool> batch_normalize(net.n, false);
+	for (int i = 0; i < net.n; ++i)
+	{
+		batch_normalize[i] = (net.layers[i].type == Darknet::ELayerType::CONVOLUTIONAL and net.layers[i].batch_normalize);
+	}
+
+	load_weights(&net, weightfile);
+
+	if (not net.details->mapped_weights)
+	{
+		// classic --> mapped (batch norm is folded by save_mapped_weights())
+		save_mapped_weights(net, outfile);
+		free_network(net);
+		return;
+	}
+
+	// mapped --> classic
+	std::vector<int> identity_batch_normalize;
+	for (int i = 0; i < net.n; ++i)
+	{
+		Darknet::Layer & l = net.layers[i];
+		if (batch_normalize[i] and l.share_layer == nullptr and not l.batch_normalize)
+		{
+			// the batch norm was folded into the weights, so save an identity batch norm to match the .cfg file
+			l.scales			= (float*)xcalloc(l.n, sizeof(float));
+			l.rolling_mean		= (float*)xcalloc(l.n, sizeof(float));
+			l.rolling_variance	= (float*)xcalloc(l.n, sizeof(float));
+			fill_cpu(l.n, 1.0f, l.scales, 1);
+			fill_cpu(l.n, 1.0f - 0.00001f, l.rolling_variance, 1); // fuse_conv_batchnorm() uses sqrt(variance + .00001)
+			l.batch_normalize = 1;
+			identity_batch_normalize.push_back(i);
+		}
+		if (l.type == Darknet::ELayerType::SHORTCUT and l.nweights > 0 and l.weights_normalization != NO_NORMALIZATION)
+		{
+			Darknet::display_warning_msg("layer #" + std::to_string(i) + " uses weights_normalization, which was already applied to the mapped weights\n");
+		}
+	}
+
+	save_weights(net, const_cast<char *>(outfile));
+
+	// free_network() skips the batch norm of layers with mapped weights, so the identity buffers are freed here
+	for (const int i : identity_batch_normalize)
+	{
+		Darknet::Layer & l = net.layers[i];
+		free(l.scales);
+		free(l.rolling_mean);
+		free(l.rolling_variance);
+		l.scales			= nullptr;
+		l.rolling_mean		= nullptr;
+		l.rolling_variance	= nullptr;
+	}
+
+	free_network(net);
+}
+
+
 void rescale_net(char *cfgfile, char *weightfile, char *outfile)
 {
 	TAT(TATPARMS);
@@ -532,6 +611,7 @@ int main(int argc, char **argv)
 		else if (cfg_and_state.command == "3d")				{ Darknet::composite_3d(argv[2], argv[3], argv[4], (argc > 5) ? atof(argv[5]) : 0); }
 		else if (cfg_and_state.command == "average")		{ average			(argc, argv);	}
 		else if (cfg_and_state.command == "cfglayers")		{ Darknet::cfg_layers();			}
+		else if (cfg_and_state.command == "convert")		{ convert_weights	(argc, argv);	}
 		else if (cfg_and_state.command == "denormalize")	{ denormalize_net	(argv[2], argv[3], argv[4]); }
 		else if (cfg_and_state.command == "detector")		{ run_detector		(argc, argv);	}
 		else if (cfg_and_state.command == "help")			{ Darknet::display_usage();			}
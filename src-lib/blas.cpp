@@ -424,6 +424,46 @@ void copy_cpu(int N, float *X, int INCX, float *Y, int INCY)
 	for(i = 0; i < N; ++i) Y[i*INCY] = X[i*INCX];
 }
 
+void nchw_to_nhwc(const float *src, float *dst, int batch, int c, int h, int w)
+{
+	TAT(TATPARMS);
+
+	const int spatial = h * w;
+	#pragma omp parallel for
+	for (int b = 0; b < batch; ++b)
+	{
+		const float * in = src + static_cast<size_t>(b) * c * spatial;
+		float * out = dst + static_cast<size_t>(b) * c * spatial;
+		for (int k = 0; k < c; ++k)
+		{
+			for (int i = 0; i < spatial; ++i)
+			{
+				out[i * c + k] = in[k * spatial + i];
+			}
+		}
+	}
+}
+
+void nhwc_to_nchw(const float *src, float *dst, int batch, int c, int h, int w)
+{
+	TAT(TATPARMS);
+
+	const int spatial = h * w;
+	#pragma omp parallel for
+	for (int b = 0; b < batch; ++b)
+	{
+		const float * in = src + static_cast<size_t>(b) * c * spatial;
+		float * out = dst + static_cast<size_t>(b) * c * spatial;
+		for (int k = 0; k < c; ++k)
+		{
+			for (int i = 0; i < spatial; ++i)
+			{
+				out[k * spatial + i] = in[i * c + k];
+			}
+		}
+	}
+}
+
 void mult_add_into_cpu(int N, float *X, float *Y, float *Z)
 {
 	TAT(TATPARMS);
@@ -21,6 +21,10 @@ void mul_cpu(int N, float *X, int INCX, float *Y, int INCY);
 
 void axpy_cpu(int N, float ALPHA, float *X, int INCX, float *Y, int INCY);
 void copy_cpu(int N, float *X, int INCX, float *Y, int INCY);
+
+/// Convert planar (NCHW) data to channels-last (NHWC), or back again.  @since 2026-10-17
+void nchw_to_nhwc(const float *src, float *dst, int batch, int c, int h, int w);
+void nhwc_to_nchw(const float *src, float *dst, int batch, int c, int h, int w);
 void scal_cpu(int N, float ALPHA, float *X, int INCX);
 void scal_add_cpu(int N, float ALPHA, float BETA, float *X, int INCX);
 void fill_cpu(int N, float ALPHA, float * X, int INCX);
@@ -222,6 +222,154 @@ namespace
 		}
 	}
 
+
+	/** Greedy per-class NMS shared by @ref do_nms_sort() and @ref diounms_sort().  The results are identical to sorting
+	 * all the detections once per class and comparing every pair, but:
+	 *
+	 * @li detections are placed in per-class buckets once, so classes without any candidates cost nothing,
+	 * @li each bucket is sorted on its own, which is much smaller than sorting all the detections,
+	 * @li boxes are also sorted by their left edge so only those which overlap horizontally need to be compared.
+	 *
+	 * The horizontal pruning is only used when @p thresh is not negative, since all of the metrics (IoU, DIoU, and the
+	 * DIoU-NMS variant) are then guaranteed to be at or below the threshold for boxes which do not overlap.
+	 */
+	template <typename Metric>
+	static inline void bucketed_nms(Darknet::Detection * dets, const int total, const int classes, const float thresh, Metric metric)
+	{
+		TAT(TATPARMS);
+
+		struct Candidate
+		{
+			int det;		///< index into @p dets
+			float left;
+			float right;
+			float top;
+			float bot;
+		};
+
+		std::vector<std::vector<int>> buckets(classes);
+		for (int i = 0; i < total; ++i)
+		{
+			for (int k = 0; k < classes; ++k)
+			{
+				if (dets[i].prob[k] != 0.0f)
+				{
+					buckets[k].push_back(i);
+				}
+			}
+		}
+
+		const bool prune = (thresh >= 0.0f);
+
+		std::vector<Candidate> candidates;	// in order of decreasing probability
+		std::vector<int> by_left;			// indexes into "candidates" sorted by the left edge
+		std::vector<float> lefts;
+
+		for (int k = 0; k < classes; ++k)
+		{
+			auto & bucket = buckets[k];
+			const int count = static_cast<int>(bucket.size());
+			if (count < 2)
+			{
+				continue;
+			}
+
+			// highest probability first; ties are broken by index so the results are deterministic
+			std::sort(bucket.begin(), bucket.end(),
+					[&dets, k](const int lhs, const int rhs) -> bool
+					{
+						if (dets[lhs].prob[k] != dets[rhs].prob[k])
+						{
+							return dets[rhs].prob[k] < dets[lhs].prob[k];
+						}
+						return lhs < rhs;
+					});
+
+			candidates.resize(count);
+			by_left.resize(count);
+			lefts.resize(count);
+			float max_width = 0.0f;
+			for (int r = 0; r < count; ++r)
+			{
+				const Darknet::Box & b = dets[bucket[r]].bbox;
+				auto & c = candidates[r];
+				c.det	= bucket[r];
+				c.left	= b.x - b.w / 2.0f;
+				c.right	= b.x + b.w / 2.0f;
+				c.top	= b.y - b.h / 2.0f;
+				c.bot	= b.y + b.h / 2.0f;
+				max_width = std::max(max_width, c.right - c.left);
+				by_left[r] = r;
+			}
+			std::sort(by_left.begin(), by_left.end(),
+					[&candidates](const int lhs, const int rhs) -> bool
+					{
+						return candidates[lhs].left < candidates[rhs].left;
+					});
+			for (int idx = 0; idx < count; ++idx)
+			{
+				lefts[idx] = candidates[by_left[idx]].left;
+			}
+
+			for (int r = 0; r < count; ++r)
+			{
+				const auto & a = candidates[r];
+				if (dets[a.det].prob[k] == 0.0f)
+				{
+					continue;
+				}
+
+				int first = 0;
+				int last = count;
+				if (prune)
+				{
+					// anything starting further left than this cannot reach the left edge of "a"; the small margin
+					// protects against rounding since widths were computed from the rounded edges
+					const float lowest = a.left - max_width - std::abs(max_width) * 1.0e-5f - 1.0e-6f;
+					first	= std::lower_bound(lefts.begin(), lefts.end(), lowest) - lefts.begin();
+					last	= std::lower_bound(lefts.begin(), lefts.end(), a.right) - lefts.begin();
+				}
+
+				for (int idx = first; idx < last; ++idx)
+				{
+					const int other = by_left[idx];
+					if (other <= r)
+					{
+						continue; // only lower-probability boxes can be suppressed
+					}
+
+					const auto & b = candidates[other];
+					if (dets[b.det].prob[k] == 0.0f)
+					{
+						continue;
+					}
+
+					if (prune and (b.right <= a.left or b.bot <= a.top or b.top >= a.bot))
+					{
+						continue;
+					}
+
+					if (metric(dets[a.det].bbox, dets[b.det].bbox) > thresh)
+					{
+						dets[b.det].prob[k] = 0.0f;
+					}
+				}
+			}
+		}
+
+		// the original implementation left the detections sorted by the probability of the last class
+		if (classes > 0)
+		{
+			for (int i = 0; i < total; ++i)
+			{
+				dets[i].sort_class = classes - 1;
+			}
+			sort_box_detections(dets, total);
+		}
+
+		return;
+	}
+
 } // anonymous namespace
 
 
@@ -844,33 +992,11 @@ void do_nms_sort(detection * dets, int total, int classes, float thresh)
 	}
 	total = k + 1;
 
-	for (k = 0; k < classes; ++k)
-	{
-		for (int i = 0; i < total; ++i)
-		{
-			dets[i].sort_class = k;
-		}
-
-		sort_box_detections(dets, total);
-
-		for (int i = 0; i < total; ++i)
-		{
-			//printf("  k = %d, \t i = %d \n", k, i);
-			if (dets[i].prob[k] == 0.0f)
+	bucketed_nms(dets, total, classes, thresh,
+			[](const Darknet::Box & a, const Darknet::Box & b) -> float
 			{
-				continue;
-			}
-			Darknet::Box a = dets[i].bbox;
-			for (int j = i + 1; j < total; ++j)
-			{
-				Darknet::Box b = dets[j].bbox;
-				if (box_iou(a, b) > thresh)
-				{
-					dets[j].prob[k] = 0.0f;
-				}
-			}
-		}
-	}
+				return box_iou(a, b);
+			});
 
 	return;
 }
@@ -937,43 +1063,19 @@ void diounms_sort(detection *dets, int total, int classes, float thresh, NMS_KIN
 
 //	std::cout << "diounms total is " << total << std::endl;
 
-	for (k = 0; k < classes; ++k)
-	{
-		for (int i = 0; i < total; ++i)
-		{
-			dets[i].sort_class = k;
-		}
-
-		sort_box_detections(dets, total);
-
-		for (int i = 0; i < total; ++i)
-		{
-			if (dets[i].prob[k] == 0)
+	bucketed_nms(dets, total, classes, thresh,
+			[nms_kind, beta1](const Darknet::Box & a, const Darknet::Box & b) -> float
 			{
-				continue;
-			}
-			Darknet::Box a = dets[i].bbox;
-			for (int j = i + 1; j < total; ++j)
-			{
-				Darknet::Box b = dets[j].bbox;
-				if (box_iou(a, b) > thresh && nms_kind == CORNERS_NMS)
-				{
-					dets[j].prob[k] = 0;
-				}
-				else if (box_diou(a, b) > thresh && nms_kind == GREEDY_NMS)
+				switch (nms_kind)
 				{
-					dets[j].prob[k] = 0;
-				}
-				else
-				{
-					if (box_diounms(a, b, beta1) > thresh && nms_kind == DIOU_NMS)
-					{
-						dets[j].prob[k] = 0;
-					}
+					case CORNERS_NMS:	return box_iou(a, b);
+					case GREEDY_NMS:	return box_diou(a, b);
+					case DIOU_NMS:		return box_diounms(a, b, beta1);
+					default:			return -FLT_MAX; // other kinds never suppress anything
 				}
-			}
-		}
-	}
+			});
+
+	return;
 }
 
 
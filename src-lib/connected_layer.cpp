@@ -43,7 +43,7 @@ size_t get_connected_workspace_size(const Darknet::Layer & l)
 	return 0;
 }
 
-Darknet::Layer make_connected_layer(int batch, int steps, int inputs, int outputs, ACTIVATION activation, int batch_normalize)
+Darknet::Layer make_connected_layer(int batch, int steps, int inputs, int outputs, ACTIVATION activation, int batch_normalize, int train)
 {
 	TAT(TATPARMS);
 
@@ -52,6 +52,11 @@ Darknet::Layer make_connected_layer(int batch, int steps, int inputs, int output
 	Darknet::Layer l = { (Darknet::ELayerType)0 };
 	l.type = Darknet::ELayerType::CONNECTED;
 
+#ifdef GPU
+	// the GPU code copies the gradients and updates between the host and the device, so these are always allocated
+	train = 1;
+#endif
+
 	l.inputs = inputs;
 	l.outputs = outputs;
 	l.batch= batch;
@@ -72,10 +77,12 @@ Darknet::Layer make_connected_layer(int batch, int steps, int inputs, int output
 	l.dilation = 1;
 
 	l.output = (float*)xcalloc(total_batch * outputs, sizeof(float));
-	l.delta = (float*)xcalloc(total_batch * outputs, sizeof(float));
-
-	l.weight_updates = (float*)xcalloc(inputs * outputs, sizeof(float));
-	l.bias_updates = (float*)xcalloc(outputs, sizeof(float));
+	if (train)
+	{
+		l.delta = (float*)xcalloc(total_batch * outputs, sizeof(float));
+		l.weight_updates = (float*)xcalloc(inputs * outputs, sizeof(float));
+		l.bias_updates = (float*)xcalloc(outputs, sizeof(float));
+	}
 
 	l.weights = (float*)xcalloc(outputs * inputs, sizeof(float));
 	l.biases = (float*)xcalloc(outputs, sizeof(float));
@@ -96,21 +103,28 @@ Darknet::Layer make_connected_layer(int batch, int steps, int inputs, int output
 
 	if(batch_normalize){
 		l.scales = (float*)xcalloc(outputs, sizeof(float));
-		l.scale_updates = (float*)xcalloc(outputs, sizeof(float));
 		for(i = 0; i < outputs; ++i){
 			l.scales[i] = 1;
 		}
 
-		l.mean = (float*)xcalloc(outputs, sizeof(float));
-		l.mean_delta = (float*)xcalloc(outputs, sizeof(float));
-		l.variance = (float*)xcalloc(outputs, sizeof(float));
-		l.variance_delta = (float*)xcalloc(outputs, sizeof(float));
+		if (train)
+		{
+			l.scale_updates = (float*)xcalloc(outputs, sizeof(float));
+
+			l.mean = (float*)xcalloc(outputs, sizeof(float));
+			l.mean_delta = (float*)xcalloc(outputs, sizeof(float));
+			l.variance = (float*)xcalloc(outputs, sizeof(float));
+			l.variance_delta = (float*)xcalloc(outputs, sizeof(float));
+		}
 
 		l.rolling_mean = (float*)xcalloc(outputs, sizeof(float));
 		l.rolling_variance = (float*)xcalloc(outputs, sizeof(float));
 
-		l.x = (float*)xcalloc(total_batch * outputs, sizeof(float));
-		l.x_norm = (float*)xcalloc(total_batch * outputs, sizeof(float));
+		if (train)
+		{
+			l.x = (float*)xcalloc(total_batch * outputs, sizeof(float));
+			l.x_norm = (float*)xcalloc(total_batch * outputs, sizeof(float));
+		}
 	}
 
 #ifdef GPU
@@ -2,7 +2,7 @@
 
 #include "darknet_internal.hpp"
 
-Darknet::Layer make_connected_layer(int batch, int steps, int inputs, int outputs, ACTIVATION activation, int batch_normalize);
+Darknet::Layer make_connected_layer(int batch, int steps, int inputs, int outputs, ACTIVATION activation, int batch_normalize, int train);
 size_t get_connected_workspace_size(const Darknet::Layer & l);
 
 void forward_connected_layer(Darknet::Layer & l, Darknet::NetworkState state);
@@ -3,11 +3,45 @@
 #include "gemm.hpp"
 #include "darknet_internal.hpp"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 namespace
 {
 	static auto & cfg_and_state = Darknet::CfgAndState::get();
 
 
+	/// Rows of the INT8 weights and columns are padded to this many bytes, the width of one AVX2 register.
+	static inline int int8_row_size(const int k)
+	{
+		return (k + 31) / 32 * 32;
+	}
+
+
+	/// The quantized input is followed by the INT8 columns, which start on a 64-byte boundary.
+	static inline size_t int8_columns_offset(const Darknet::Layer & l)
+	{
+		return (static_cast<size_t>(l.inputs) + 63) / 64 * 64;
+	}
+
+
+	/// Bytes of workspace used by @ref forward_convolutional_layer_int8() for the quantized input and its columns.
+	static inline size_t get_int8_workspace_size(const Darknet::Layer & l)
+	{
+		return int8_columns_offset(l) + static_cast<size_t>(l.out_h) * l.out_w * int8_row_size(l.size * l.size * l.c);
+	}
+
+
+	/// Bytes of workspace used by @ref winograd_convolution() for the transformed input and the 16 products.
+	static inline size_t get_winograd_workspace_size(const int filters, const int channels, const int out_h, const int out_w)
+	{
+		const size_t tiles = static_cast<size_t>((out_h + 1) / 2) * ((out_w + 1) / 2);
+
+		return 16 * (static_cast<size_t>(channels) + filters) * tiles * sizeof(float);
+	}
+
+
 	inline void binarize_cpu(float *input, int n, float *binary)
 	{
 		TAT_COMMENT(TATPARMS, "2024-05-14 inlined");
@@ -170,6 +204,554 @@ namespace
 
 		return weights;
 	}
+
+
+	/** Accumulate one kernel row of a depthwise convolution into the interior columns [x, x_end) of an output row.
+	 * "Interior" means every tap lands inside the input row, so no bounds checks are needed.
+	 *
+	 * @since 2026-10-17
+	 */
+	inline void depthwise_interior_row(float * out_row, const float * in_row, const float * weights, const int ksize, const int dilation, const int pad, const int stride_x, int x, const int x_end)
+	{
+		TAT_COMMENT(TATPARMS, "hot loop");
+
+#if defined(__AVX2__)
+		if (stride_x == 1)
+		{
+			for (; x + 8 <= x_end; x += 8)
+			{
+				__m256 acc = _mm256_loadu_ps(out_row + x);
+				for (int kx = 0; kx < ksize; ++kx)
+				{
+					const __m256 in = _mm256_loadu_ps(in_row + x + kx * dilation - pad);
+					acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_set1_ps(weights[kx]), in));
+				}
+				_mm256_storeu_ps(out_row + x, acc);
+			}
+		}
+		else if (stride_x == 2)
+		{
+			// load 16 consecutive inputs and keep the even ones; stop one vector early so the odd tail never leaves the row
+			for (; x + 8 < x_end; x += 8)
+			{
+				__m256 acc = _mm256_loadu_ps(out_row + x);
+				for (int kx = 0; kx < ksize; ++kx)
+				{
+					const float * src = in_row + 2 * x + kx * dilation - pad;
+					const __m256 lo = _mm256_loadu_ps(src);
+					const __m256 hi = _mm256_loadu_ps(src + 8);
+					const __m256 even = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0))), _MM_SHUFFLE(3, 1, 2, 0)));
+					acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_set1_ps(weights[kx]), even));
+				}
+				_mm256_storeu_ps(out_row + x, acc);
+			}
+		}
+#endif
+
+		for (; x < x_end; ++x)
+		{
+			float sum = out_row[x];
+			const float * src = in_row + x * stride_x - pad;
+			for (int kx = 0; kx < ksize; ++kx)
+			{
+				sum += weights[kx] * src[kx * dilation];
+			}
+			out_row[x] = sum;
+		}
+	}
+
+
+	/** Direct depthwise convolution, used when every group sees exactly one input channel (@p l.groups == @p l.c).
+	 * Each output plane is a sliding window over a single input plane, so this avoids running one im2col and one
+	 * degenerate M=1 GEMM per channel.  Output is accumulated into @p output, which must already be zeroed.
+	 *
+	 * @since 2026-10-17
+	 */
+	inline void forward_depthwise_convolution(const Darknet::Layer & l, const float * input, float * output, const int out_h, const int out_w)
+	{
+		TAT(TATPARMS);
+
+		const int multiplier	= l.n / l.groups; // filters per input channel
+		const int ksize			= l.size;
+		const int dilation		= l.dilation;
+		const int pad			= l.pad * l.dilation;
+		const int in_plane		= l.h * l.w;
+		const int out_plane		= out_h * out_w;
+
+		// output columns where every tap of a kernel row lands inside the input row
+		const int right = l.w - 1 + pad - (ksize - 1) * dilation;
+		const int x_lo = std::min(out_w, (pad + l.stride_x - 1) / l.stride_x);
+		const int x_hi = std::max(x_lo, std::min(out_w, right < 0 ? 0 : right / l.stride_x + 1));
+
+		const int total = l.batch * l.n;
+
+		#pragma omp parallel for
+		for (int t = 0; t < total; ++t)
+		{
+			const int b			= t / l.n;
+			const int filter	= t % l.n;
+			const float * in	= input + (b * l.c + filter / multiplier) * in_plane;
+			const float * w		= l.weights + filter * ksize * ksize;
+			float * out			= output + t * out_plane;
+
+			for (int y = 0; y < out_h; ++y)
+			{
+				float * out_row = out + y * out_w;
+
+				for (int ky = 0; ky < ksize; ++ky)
+				{
+					const int iy = y * l.stride_y - pad + ky * dilation;
+					if (iy < 0 || iy >= l.h)
+					{
+						continue; // zero padding
+					}
+
+					const float * in_row = in + iy * l.w;
+					const float * w_row = w + ky * ksize;
+
+					// left and right borders need bounds checks on every tap
+					const auto border = [&](const int x)
+					{
+						float sum = out_row[x];
+						for (int kx = 0; kx < ksize; ++kx)
+						{
+							const int ix = x * l.stride_x - pad + kx * dilation;
+							if (ix >= 0 && ix < l.w)
+							{
+								sum += w_row[kx] * in_row[ix];
+							}
+						}
+						out_row[x] = sum;
+					};
+
+					for (int x = 0; x < x_lo; ++x)
+					{
+						border(x);
+					}
+					depthwise_interior_row(out_row, in_row, w_row, ksize, dilation, pad, l.stride_x, x_lo, x_hi);
+					for (int x = x_hi; x < out_w; ++x)
+					{
+						border(x);
+					}
+				}
+			}
+		}
+	}
+
+
+	/** During inference the weights have been fused with batch-norm, so the bias and an element-wise activation can be
+	 * applied by the GEMM while each tile of the output is still in cache.  This also lets the GEMM overwrite the output
+	 * rather than accumulate into it, so the output does not need to be zeroed first.
+	 *
+	 * @since 2026-10-17
+	 */
+	inline bool use_gemm_epilogue(const Darknet::Layer & l, const Darknet::NetworkState & state)
+	{
+		TAT(TATPARMS);
+
+		return	not state.train						and
+				not l.batch_normalize				and
+				not l.xnor							and
+				not l.binary						and
+				l.activation != NORM_CHAN			and
+				l.activation != NORM_CHAN_SOFTMAX	and
+				l.activation != NORM_CHAN_SOFTMAX_MAXVAL;
+	}
+
+
+	/** Grouped convolution with many groups:  rather than letting each tiny per-group GEMM try to spread itself over
+	 * every core, run the groups themselves in parallel.  Each thread keeps its own im2col buffer since the shared
+	 * network workspace is only large enough for a single group.  See @ref use_gemm_epilogue() for @p fuse_epilogue.
+	 *
+	 * @since 2026-10-17
+	 */
+	inline void forward_grouped_convolution(const Darknet::Layer & l, float * input, float * output, const int out_h, const int out_w, const bool fuse_epilogue)
+	{
+		TAT(TATPARMS);
+
+		const int group_c	= l.c / l.groups;
+		const int m			= l.n / l.groups;
+		const int k			= l.size * l.size * group_c;
+		const int n			= out_h * out_w;
+		const bool direct	= (l.size == 1 && l.stride == 1 && l.dilation == 1);
+		const int total		= l.batch * l.groups;
+
+		#pragma omp parallel for schedule(dynamic)
+		for (int t = 0; t < total; ++t)
+		{
+			static thread_local std::vector<float> columns;
+
+			const int group	= t % l.groups;
+			float * a		= l.weights + group * l.nweights / l.groups;
+			float * im		= input + t * group_c * l.h * l.w;
+			float * c		= output + t * n * m;
+			float * b		= im;
+
+			if (not direct)
+			{
+				if (columns.size() < static_cast<size_t>(k) * n)
+				{
+					columns.resize(static_cast<size_t>(k) * n);
+				}
+				b = columns.data();
+
+				im2col_cpu_ext(im, group_c, l.h, l.w, l.size, l.size, l.pad * l.dilation, l.pad * l.dilation, l.stride_y, l.stride_x, l.dilation, l.dilation, b);
+			}
+
+			if (fuse_epilogue)
+			{
+				const Gemm_Epilogue epilogue = { true, l.biases + group * m, l.activation, false };
+				gemm_nn_fused(m, n, k, 1, a, k, b, n, c, n, epilogue);
+			}
+			else
+			{
+				gemm(0, 0, m, n, k, 1, a, k, b, n, 1, c, n);
+			}
+		}
+	}
+
+
+	/** Decide whether a grouped layer has enough groups to keep every thread busy with whole groups.
+	 *
+	 * @since 2026-10-17
+	 */
+	inline bool use_parallel_groups(const Darknet::Layer & l)
+	{
+		TAT(TATPARMS);
+
+#ifdef OPENMP
+		return l.groups > 1 && l.groups >= omp_get_max_threads();
+#else
+		return false;
+#endif
+	}
+
+
+	/** Winograd F(2x2,3x3) input transform:  each 4x4 input tile @p d becomes @p V = B^T d B.  The result is scattered
+	 * into 16 planes of @p channels x @p tiles so the per-position products can be done as 16 ordinary GEMMs.
+	 *
+	 * Works on one row of tiles at a time so every inner loop runs over consecutive tiles and can be vectorised.
+	 *
+	 * @since 2026-10-17
+	 */
+	inline void winograd_input_transform(const float * input, float * V, const int channels, const int h, const int w, const int pad, const int tiles_y, const int tiles_x)
+	{
+		TAT(TATPARMS);
+
+		const int tiles = tiles_y * tiles_x;
+		const int row_w = 2 * tiles_x + 2;
+		const size_t step = static_cast<size_t>(channels) * tiles;
+
+		#pragma omp parallel for
+		for (int ch = 0; ch < channels; ++ch)
+		{
+			static thread_local std::vector<float> buffer;
+			buffer.assign(8 * row_w, 0.0f);
+			float * d[4] = { &buffer[0], &buffer[row_w], &buffer[2 * row_w], &buffer[3 * row_w] };
+			float * t[4] = { &buffer[4 * row_w], &buffer[5 * row_w], &buffer[6 * row_w], &buffer[7 * row_w] };
+
+			const float * plane = input + ch * h * w;
+
+			// input columns which land inside the 4-row strip, and where they go once the left padding is included
+			const int x_first	= std::max(0, pad);
+			const int x_count	= std::max(0, std::min(w, row_w - pad) - std::max(0, -pad));
+
+			for (int ty = 0; ty < tiles_y; ++ty)
+			{
+				for (int i = 0; i < 4; ++i)
+				{
+					const int y = ty * 2 - pad + i;
+					std::fill_n(d[i], row_w, 0.0f);
+					if (y >= 0 && y < h && x_count > 0)
+					{
+						std::copy_n(plane + y * w + std::max(0, -pad), x_count, d[i] + x_first);
+					}
+				}
+
+				// t = B^T d
+				for (int x = 0; x < row_w; ++x)
+				{
+					t[0][x] = d[0][x] - d[2][x];
+					t[1][x] = d[1][x] + d[2][x];
+					t[2][x] = d[2][x] - d[1][x];
+					t[3][x] = d[1][x] - d[3][x];
+				}
+
+				// V = t B
+				float * dst = V + ch * tiles + ty * tiles_x;
+				for (int i = 0; i < 4; ++i)
+				{
+					const float * r = t[i];
+					float * v0 = dst + (i * 4 + 0) * step;
+					float * v1 = dst + (i * 4 + 1) * step;
+					float * v2 = dst + (i * 4 + 2) * step;
+					float * v3 = dst + (i * 4 + 3) * step;
+					for (int tx = 0; tx < tiles_x; ++tx)
+					{
+						v0[tx] = r[2 * tx + 0] - r[2 * tx + 2];
+						v1[tx] = r[2 * tx + 1] + r[2 * tx + 2];
+						v2[tx] = r[2 * tx + 2] - r[2 * tx + 1];
+						v3[tx] = r[2 * tx + 1] - r[2 * tx + 3];
+					}
+				}
+			}
+		}
+	}
+
+
+	/** Winograd F(2x2,3x3) output transform:  gathers the 16 products of each tile and writes @p Y = A^T M A, a 2x2
+	 * block of output pixels.
+	 *
+	 * @since 2026-10-17
+	 */
+	inline void winograd_output_transform(const float * M, float * output, const int filters, const int out_h, const int out_w, const int tiles_y, const int tiles_x)
+	{
+		TAT(TATPARMS);
+
+		const int tiles = tiles_y * tiles_x;
+		const size_t step = static_cast<size_t>(filters) * tiles;
+
+		#pragma omp parallel for
+		for (int f = 0; f < filters; ++f)
+		{
+			static thread_local std::vector<float> buffer;
+			buffer.resize(10 * tiles_x);
+			float * s[2][4];
+			for (int i = 0; i < 8; ++i)
+			{
+				s[i / 4][i % 4] = &buffer[i * tiles_x];
+			}
+			float * y_row = &buffer[8 * tiles_x];
+
+			float * plane = output + f * out_h * out_w;
+
+			for (int ty = 0; ty < tiles_y; ++ty)
+			{
+				const float * m = M + f * tiles + ty * tiles_x;
+
+				// s = A^T m
+				for (int j = 0; j < 4; ++j)
+				{
+					const float * m0 = m + (0 * 4 + j) * step;
+					const float * m1 = m + (1 * 4 + j) * step;
+					const float * m2 = m + (2 * 4 + j) * step;
+					const float * m3 = m + (3 * 4 + j) * step;
+					for (int tx = 0; tx < tiles_x; ++tx)
+					{
+						s[0][j][tx] = m0[tx] + m1[tx] + m2[tx];
+						s[1][j][tx] = m1[tx] - m2[tx] - m3[tx];
+					}
+				}
+
+				// Y = s A, clipped to the output since the last row/column of tiles may hang over the edge
+				for (int i = 0; i < 2 && ty * 2 + i < out_h; ++i)
+				{
+					for (int tx = 0; tx < tiles_x; ++tx)
+					{
+						y_row[2 * tx + 0] = s[i][0][tx] + s[i][1][tx] + s[i][2][tx];
+						y_row[2 * tx + 1] = s[i][1][tx] - s[i][2][tx] - s[i][3][tx];
+					}
+					std::copy_n(y_row, out_w, plane + (ty * 2 + i) * out_w);
+				}
+			}
+		}
+	}
+
+
+	/** Convolve a single image with pre-transformed Winograd weights @p U, laid out as 16 planes of
+	 * @p filters x @p channels.  The multiplications for each of the 16 tile positions form one GEMM.  The
+	 * @p workspace must hold @ref get_winograd_workspace_size() bytes.
+	 *
+	 * @since 2026-10-17
+	 */
+	inline void winograd_convolution(const float * U, const int filters, const int channels, const int h, const int w, const int pad, const float * input, float * output, const int out_h, const int out_w, float * workspace)
+	{
+		TAT(TATPARMS);
+
+		const int tiles_y = (out_h + 1) / 2;
+		const int tiles_x = (out_w + 1) / 2;
+		const int tiles = tiles_y * tiles_x;
+
+		float * V = workspace;
+		float * M = workspace + 16 * static_cast<size_t>(channels) * tiles;
+		fill_cpu(16 * filters * tiles, 0.0f, M, 1);
+
+		winograd_input_transform(input, V, channels, h, w, pad, tiles_y, tiles_x);
+
+		for (int xi = 0; xi < 16; ++xi)
+		{
+			float * a = const_cast<float *>(U) + xi * filters * channels;
+			float * b = V + xi * channels * tiles;
+			float * c = M + xi * filters * tiles;
+			gemm(0, 0, filters, tiles, channels, 1, a, channels, b, tiles, 1, c, tiles);
+		}
+
+		winograd_output_transform(M, output, filters, out_h, out_w, tiles_y, tiles_x);
+	}
+
+
+	/** Transform 3x3 weights with @p U = G g G^T.  The output is 16 planes of @p filters x @p channels.
+	 *
+	 * @since 2026-10-17
+	 */
+	inline std::vector<float> winograd_weight_transform(const float * weights, const int filters, const int channels)
+	{
+		TAT(TATPARMS);
+
+		std::vector<float> U(16 * static_cast<size_t>(filters) * channels);
+		const size_t step = static_cast<size_t>(filters) * channels;
+
+		for (int f = 0; f < filters; ++f)
+		{
+			for (int ch = 0; ch < channels; ++ch)
+			{
+				const float * g = weights + (f * channels + ch) * 9;
+
+				// t = G g
+				float t[4][3];
+				for (int j = 0; j < 3; ++j)
+				{
+					t[0][j] = g[j];
+					t[1][j] = 0.5f * (g[j] + g[3 + j] + g[6 + j]);
+					t[2][j] = 0.5f * (g[j] - g[3 + j] + g[6 + j]);
+					t[3][j] = g[6 + j];
+				}
+
+				// U = t G^T
+				float * dst = U.data() + f * channels + ch;
+				for (int i = 0; i < 4; ++i)
+				{
+					dst[(i * 4 + 0) * step] = t[i][0];
+					dst[(i * 4 + 1) * step] = 0.5f * (t[i][0] + t[i][1] + t[i][2]);
+					dst[(i * 4 + 2) * step] = 0.5f * (t[i][0] - t[i][1] + t[i][2]);
+					dst[(i * 4 + 3) * step] = t[i][2];
+				}
+			}
+		}
+
+		return U;
+	}
+
+
+	/** Compare Winograd against a direct convolution on a small random input, using the first few filters of the layer.
+	 * @returns the largest absolute error relative to the largest reference output.
+	 *
+	 * @since 2026-10-17
+	 */
+	inline float winograd_relative_error(const Darknet::Layer & l, const std::vector<float> & U)
+	{
+		TAT(TATPARMS);
+
+		const int filters	= std::min(l.n, 8);
+		const int h			= 6;
+		const int w			= 6;
+		const int out_h		= h + 2 * l.pad - 2;
+		const int out_w		= w + 2 * l.pad - 2;
+		if (out_h <= 0 || out_w <= 0)
+		{
+			return 0.0f;
+		}
+
+		// only keep the sampled filters from each of the 16 planes
+		std::vector<float> U_sample(16 * static_cast<size_t>(filters) * l.c);
+		for (int xi = 0; xi < 16; ++xi)
+		{
+			std::copy_n(U.data() + static_cast<size_t>(xi) * l.n * l.c, filters * l.c, U_sample.data() + static_cast<size_t>(xi) * filters * l.c);
+		}
+
+		std::mt19937 rng(1234);
+		std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+		std::vector<float> input(static_cast<size_t>(l.c) * h * w);
+		for (auto & v : input)
+		{
+			v = distribution(rng);
+		}
+
+		std::vector<float> output(static_cast<size_t>(filters) * out_h * out_w);
+		std::vector<float> workspace(get_winograd_workspace_size(filters, l.c, out_h, out_w) / sizeof(float));
+		winograd_convolution(U_sample.data(), filters, l.c, h, w, l.pad, input.data(), output.data(), out_h, out_w, workspace.data());
+
+		float max_error = 0.0f;
+		float max_value = 0.0f;
+		for (int f = 0; f < filters; ++f)
+		{
+			for (int y = 0; y < out_h; ++y)
+			{
+				for (int x = 0; x < out_w; ++x)
+				{
+					double sum = 0.0;
+					for (int ch = 0; ch < l.c; ++ch)
+					{
+						const float * g = l.weights + (f * l.c + ch) * 9;
+						for (int ky = 0; ky < 3; ++ky)
+						{
+							const int iy = y - l.pad + ky;
+							for (int kx = 0; kx < 3; ++kx)
+							{
+								const int ix = x - l.pad + kx;
+								if (iy >= 0 && iy < h && ix >= 0 && ix < w)
+								{
+									sum += g[ky * 3 + kx] * input[(ch * h + iy) * w + ix];
+								}
+							}
+						}
+					}
+					max_value = std::max(max_value, static_cast<float>(std::fabs(sum)));
+					max_error = std::max(max_error, static_cast<float>(std::fabs(sum - output[(f * out_h + y) * out_w + x])));
+				}
+			}
+		}
+
+		return max_value > 0.0f ? max_error / max_value : max_error;
+	}
+
+	/// Bias, activation, and the optional assisted excitation and antialiasing which follow every forward convolution.
+	static inline void finish_forward_convolutional_layer(Darknet::Layer & l, Darknet::NetworkState state, const bool fuse_epilogue)
+	{
+		TAT(TATPARMS);
+
+		// when the epilogue was fused the bias and activation have already been applied by the GEMM
+		if (not fuse_epilogue)
+		{
+			if(l.batch_normalize){
+				forward_batchnorm_layer(l, state);
+			}
+			else {
+				add_bias(l.output, l.biases, l.batch, l.n, l.out_h*l.out_w);
+			}
+
+			//activate_array(l.output, m*n*l.batch, l.activation);
+			if (l.activation == SWISH) activate_array_swish(l.output, l.outputs*l.batch, l.activation_input, l.output);
+			else if (l.activation == MISH) activate_array_mish(l.output, l.outputs*l.batch, l.activation_input, l.output);
+			else if (l.activation == HARD_MISH) activate_array_hard_mish(l.output, l.outputs*l.batch, l.activation_input, l.output);
+			else if (l.activation == NORM_CHAN) activate_array_normalize_channels(l.output, l.outputs*l.batch, l.batch, l.out_c, l.out_w*l.out_h, l.output);
+			else if (l.activation == NORM_CHAN_SOFTMAX) activate_array_normalize_channels_softmax(l.output, l.outputs*l.batch, l.batch, l.out_c, l.out_w*l.out_h, l.output, 0);
+			else if (l.activation == NORM_CHAN_SOFTMAX_MAXVAL) activate_array_normalize_channels_softmax(l.output, l.outputs*l.batch, l.batch, l.out_c, l.out_w*l.out_h, l.output, 1);
+			else activate_array_cpu_custom(l.output, l.outputs*l.batch, l.activation);
+		}
+
+		if(l.binary || l.xnor) swap_binary(&l);
+
+		//visualize_convolutional_layer(l, "conv_visual", NULL);
+		//cv::waitKey(0);
+
+		if (l.assisted_excitation && state.train)
+		{
+			assisted_excitation_forward(l, state);
+		}
+
+		if (l.antialiasing)
+		{
+			Darknet::NetworkState s = { 0 };
+			s.train = state.train;
+			s.workspace = state.workspace;
+			s.net = state.net;
+			s.input = l.output;
+			forward_convolutional_layer(*(l.input_layer), s);
+			//simple_copy_ongpu(l.outputs*l.batch, l.output, l.input_antialiasing);
+			memcpy(l.output, l.input_layer->output, l.input_layer->outputs * l.input_layer->batch * sizeof(float));
+		}
+	}
 }
 
 
@@ -282,6 +864,16 @@ size_t get_convolutional_workspace_size(const Darknet::Layer & l)
 		workspace_size = workspace_size16;
 	}
 
+	// the CPU-only Winograd and INT8 paths use the same workspace for their scratch buffers
+	if (l.winograd_weights)
+	{
+		workspace_size = std::max(workspace_size, get_winograd_workspace_size(l.n, l.c, l.out_h, l.out_w));
+	}
+	if (l.weights_int8)
+	{
+		workspace_size = std::max(workspace_size, get_int8_workspace_size(l));
+	}
+
 	return workspace_size;
 }
 
@@ -735,6 +1327,55 @@ void free_convolutional_batchnorm(Darknet::Layer *l)
 }
 
 
+bool prepare_winograd_convolution(Darknet::Layer & l)
+{
+	TAT(TATPARMS);
+
+	// largest error (relative to the largest output) accepted before a layer falls back to im2col + GEMM
+	const float tolerance = 1.0e-3f;
+
+	if (l.winograd_weights)
+	{
+		free(l.winograd_weights);
+		l.winograd_weights = nullptr;
+	}
+
+	if (l.type		!= Darknet::ELayerType::CONVOLUTIONAL	or
+		l.size		!= 3		or
+		l.stride_x	!= 1		or
+		l.stride_y	!= 1		or
+		l.dilation	!= 1		or
+		l.groups	!= 1		or
+		l.xnor					or
+		l.binary				or
+		l.batch_normalize		or	// weights must already be fused with fuse_conv_batchnorm()
+		l.deform				or
+		l.weights_int8			or	// the INT8 path is used instead
+		l.weights	== nullptr)
+	{
+		return false;
+	}
+
+	std::vector<float> U = winograd_weight_transform(l.weights, l.n, l.c);
+
+	const float error = winograd_relative_error(l, U);
+	if (error > tolerance)
+	{
+		if (cfg_and_state.is_verbose)
+		{
+			std::cout << "layer #" << l.index << ": Winograd error " << error << " exceeds tolerance, using im2col + GEMM" << std::endl;
+		}
+		return false;
+	}
+
+	l.winograd_weights = (float *)xcalloc(U.size(), sizeof(float));
+	std::copy(U.begin(), U.end(), l.winograd_weights);
+	l.workspace_size = get_convolutional_workspace_size(l);
+
+	return true;
+}
+
+
 Darknet::Layer make_convolutional_layer(int batch, int steps, int h, int w, int c, int n, int groups, int size, int stride_x, int stride_y, int dilation, int padding, ACTIVATION activation, int batch_normalize, int binary, int xnor, int adam, int use_bin_output, int index, int antialiasing, Darknet::Layer *share_layer, int assisted_excitation, int deform, int train)
 {
 	TAT(TATPARMS);
@@ -1438,6 +2079,306 @@ void binary_align_weights(Darknet::Layer *l)
 	free(align_weights);
 }
 
+void prepare_convolutional_layer_nhwc(Darknet::Layer & l)
+{
+	TAT(TATPARMS);
+
+	if (l.weights_nhwc)
+	{
+		// already done, or shared with the network this one was cloned from
+		return;
+	}
+
+	const int size = l.size;
+	l.weights_nhwc = (float *)xcalloc(static_cast<size_t>(size) * size * l.c * l.n, sizeof(float));
+
+	for (int f = 0; f < l.n; ++f)
+	{
+		for (int ch = 0; ch < l.c; ++ch)
+		{
+			for (int ky = 0; ky < size; ++ky)
+			{
+				for (int kx = 0; kx < size; ++kx)
+				{
+					l.weights_nhwc[(static_cast<size_t>(ky * size + kx) * l.c + ch) * l.n + f] = l.weights[((f * l.c + ch) * size + ky) * size + kx];
+				}
+			}
+		}
+	}
+}
+
+
+void forward_convolutional_layer_nhwc(Darknet::Layer & l, Darknet::NetworkState state)
+{
+	TAT(TATPARMS);
+
+	const int out_h		= convolutional_out_height(l);
+	const int out_w		= convolutional_out_width(l);
+	const int pixels	= out_h * out_w;
+	const int k			= l.size * l.size * l.c;
+	const int pad		= l.pad * l.dilation;
+	const bool direct	= (l.size == 1 && l.stride_x == 1 && l.stride_y == 1 && l.pad == 0);
+
+	// one GEMM per image:  (pixels x k) patches times (k x filters) weights gives the channels-last output directly
+	const Gemm_Epilogue epilogue = { true, l.biases, l.activation, true };
+
+	for (int b = 0; b < l.batch; ++b)
+	{
+		float * im = state.input + static_cast<size_t>(b) * l.inputs;
+		float * patches = im;
+
+		if (not direct)
+		{
+			// im2col for channels-last data copies whole pixels, so every copy is l.c contiguous floats
+			patches = state.workspace;
+
+			#pragma omp parallel for
+			for (int p = 0; p < pixels; ++p)
+			{
+				const int oy = p / out_w;
+				const int ox = p % out_w;
+				float * row = patches + static_cast<size_t>(p) * k;
+
+				for (int ky = 0; ky < l.size; ++ky)
+				{
+					const int iy = oy * l.stride_y - pad + ky * l.dilation;
+					for (int kx = 0; kx < l.size; ++kx)
+					{
+						const int ix = ox * l.stride_x - pad + kx * l.dilation;
+						float * dst = row + (ky * l.size + kx) * l.c;
+						if (iy >= 0 && iy < l.h && ix >= 0 && ix < l.w)
+						{
+							memcpy(dst, im + (static_cast<size_t>(iy) * l.w + ix) * l.c, l.c * sizeof(float));
+						}
+						else
+						{
+							std::fill_n(dst, l.c, 0.0f);
+						}
+					}
+				}
+			}
+		}
+
+		gemm_nn_fused(pixels, l.n, k, 1, patches, k, l.weights_nhwc, l.n, l.output + static_cast<size_t>(b) * l.outputs, l.n, epilogue);
+	}
+}
+
+
+namespace
+{
+	/// Quantize activations to 7 bits, which is what the AVX2 @p maddubs kernel can multiply without saturation.
+	static inline void quantize_activations(const float * src, const size_t count, const float scale, const int zero_point, uint8_t * dst)
+	{
+		TAT_COMMENT(TATPARMS, "hot loop");
+
+		const float inverse = 1.0f / scale;
+		const float offset = static_cast<float>(zero_point) + 0.5f;
+		for (size_t i = 0; i < count; ++i)
+		{
+			const float q = std::min(std::max(src[i] * inverse + offset, 0.0f), 127.0f);
+			dst[i] = static_cast<uint8_t>(q);
+		}
+	}
+
+	/** im2col for quantized activations, but with one row of @p ldk bytes per output pixel so both the weights and the
+	 * columns are contiguous along K for the dot product kernels.  Padding uses the zero point, which represents 0.0f.
+	 */
+	static inline void im2col_int8(const uint8_t * im, const Darknet::Layer & l, const int out_h, const int out_w, const int ldk, uint8_t * columns)
+	{
+		TAT_COMMENT(TATPARMS, "hot loop");
+
+		const int k = l.size * l.size * l.c;
+		const uint8_t padding = static_cast<uint8_t>(l.input_int8_zero_point);
+
+		#pragma omp parallel for
+		for (int y = 0; y < out_h; ++y)
+		{
+			for (int x = 0; x < out_w; ++x)
+			{
+				uint8_t * row = columns + static_cast<size_t>(y * out_w + x) * ldk;
+				for (int ch = 0; ch < l.c; ++ch)
+				{
+					const uint8_t * plane = im + static_cast<size_t>(ch) * l.h * l.w;
+					for (int ky = 0; ky < l.size; ++ky)
+					{
+						const int iy = y * l.stride_y - l.pad + ky;
+						for (int kx = 0; kx < l.size; ++kx)
+						{
+							const int ix = x * l.stride_x - l.pad + kx;
+							*row++ = (iy >= 0 and iy < l.h and ix >= 0 and ix < l.w) ? plane[iy * l.w + ix] : padding;
+						}
+					}
+				}
+				std::fill_n(row, ldk - k, static_cast<uint8_t>(0));
+			}
+		}
+	}
+
+	/** INT8 forward pass for inference:  the input is quantized to 7 bits, convolved with the 8-bit weights using integer
+	 * dot products, and converted back to floats before the bias and activation are applied.  The output stays FP32 so
+	 * the next layer does not need to know this layer was quantized.
+	 */
+	static inline void forward_convolutional_layer_int8(Darknet::Layer & l, Darknet::NetworkState & state, const int out_h, const int out_w)
+	{
+		TAT(TATPARMS);
+
+		const int pixels	= out_h * out_w;
+		const int ldk		= int8_row_size(l.size * l.size * l.c);
+
+		// see get_int8_workspace_size()
+		uint8_t * quantized	= reinterpret_cast<uint8_t *>(state.workspace);
+		uint8_t * columns	= quantized + int8_columns_offset(l);
+
+		const Gemm_Int8_Requantize requantize = { l.input_int8_scale, l.input_int8_zero_point, l.weights_int8_scales, l.weights_int8_sums };
+		const Gemm_Epilogue epilogue = { true, l.biases, l.activation, false };
+
+		for (int b = 0; b < l.batch; ++b)
+		{
+			quantize_activations(state.input + static_cast<size_t>(b) * l.inputs, l.inputs, l.input_int8_scale, l.input_int8_zero_point, quantized);
+			im2col_int8(quantized, l, out_h, out_w, ldk, columns);
+			gemm_int8_fused(l.n, pixels, ldk, l.weights_int8, ldk, columns, ldk, l.output + static_cast<size_t>(b) * l.outputs, pixels, requantize, epilogue);
+		}
+	}
+}
+
+
+bool can_quantize_convolutional_layer(const Darknet::Layer & l)
+{
+	TAT(TATPARMS);
+
+	return
+		l.type				== Darknet::ELayerType::CONVOLUTIONAL	and
+		l.groups			== 1		and
+		l.dilation			== 1		and
+		l.share_layer		== nullptr	and
+		l.weights			!= nullptr	and
+		not l.xnor						and
+		not l.binary					and
+		not l.deform					and
+		not l.batch_normalize			and	// weights must already be fused with fuse_conv_batchnorm()
+		l.activation != NORM_CHAN		and
+		l.activation != NORM_CHAN_SOFTMAX	and
+		l.activation != NORM_CHAN_SOFTMAX_MAXVAL;
+}
+
+
+void quantize_convolutional_layer(Darknet::Layer & l, float input_min, float input_max)
+{
+	TAT(TATPARMS);
+
+	if (not can_quantize_convolutional_layer(l))
+	{
+		darknet_fatal_error(DARKNET_LOC, "layer #%d cannot be quantized", l.index);
+	}
+
+	// the range must include zero so the padding is exact
+	input_min = std::min(input_min, 0.0f);
+	input_max = std::max(input_max, 0.0f);
+	const float input_scale = std::max(input_max - input_min, 1.0e-6f) / 127.0f;
+	const int zero_point = std::min(std::max(static_cast<int>(std::lround(-input_min / input_scale)), 0), 127);
+
+	// symmetric quantization of each filter, so the weights need no zero point
+	const int k = l.size * l.size * l.c;
+	const int ldk = int8_row_size(k);
+	std::vector<float> scales(l.n);
+	std::vector<int8_t> weights(static_cast<size_t>(l.n) * ldk, 0);
+	for (int f = 0; f < l.n; ++f)
+	{
+		const float * w = l.weights + static_cast<size_t>(f) * k;
+		float max_abs = 0.0f;
+		for (int i = 0; i < k; ++i)
+		{
+			max_abs = std::max(max_abs, std::fabs(w[i]));
+		}
+		scales[f] = (max_abs > 0.0f ? max_abs / 127.0f : 1.0f);
+
+		int8_t * q = weights.data() + static_cast<size_t>(f) * ldk;
+		for (int i = 0; i < k; ++i)
+		{
+			q[i] = static_cast<int8_t>(std::min(std::max(std::lround(w[i] / scales[f]), -127L), 127L));
+		}
+	}
+
+	set_convolutional_layer_int8(l, input_scale, zero_point, scales, weights);
+}
+
+
+void set_convolutional_layer_int8(Darknet::Layer & l, float input_scale, int zero_point, const std::vector<float> & scales, const std::vector<int8_t> & weights)
+{
+	TAT(TATPARMS);
+
+	const int ldk = int8_row_size(l.size * l.size * l.c);
+	if (l.groups != 1 or scales.size() != static_cast<size_t>(l.n) or weights.size() != static_cast<size_t>(l.n) * ldk or zero_point < 0 or zero_point > 127 or not (input_scale > 0.0f))
+	{
+		darknet_fatal_error(DARKNET_LOC, "INT8 weights do not match layer #%d (n=%d, size=%d, c=%d)", l.index, l.n, l.size, l.c);
+	}
+
+	if (l.weights_int8)			free(l.weights_int8);
+	if (l.weights_int8_scales)	free(l.weights_int8_scales);
+	if (l.weights_int8_sums)	free(l.weights_int8_sums);
+
+	l.weights_int8			= (int8_t *)xcalloc(weights.size(), sizeof(int8_t));
+	l.weights_int8_scales	= (float *)xcalloc(l.n, sizeof(float));
+	l.weights_int8_sums		= (int32_t *)xcalloc(l.n, sizeof(int32_t));
+	std::copy(weights.begin(), weights.end(), l.weights_int8);
+	std::copy(scales.begin(), scales.end(), l.weights_int8_scales);
+
+	for (int f = 0; f < l.n; ++f)
+	{
+		int32_t sum = 0;
+		for (int i = 0; i < ldk; ++i)
+		{
+			sum += l.weights_int8[static_cast<size_t>(f) * ldk + i];
+		}
+		l.weights_int8_sums[f] = sum;
+	}
+
+	l.input_int8_scale		= input_scale;
+	l.input_int8_zero_point	= zero_point;
+	l.workspace_size		= get_convolutional_workspace_size(l);
+}
+
+
+bool convert_convolutional_weights_storage(Darknet::Layer & l, const Darknet::EWeightsStorage storage)
+{
+	TAT(TATPARMS);
+
+	// only layers which run on the plain im2col + GEMM path read their weights during inference
+	if (storage				== Darknet::EWeightsStorage::FP32		or
+		l.type				!= Darknet::ELayerType::CONVOLUTIONAL	or
+		l.groups			!= 1		or
+		l.share_layer		!= nullptr	or
+		l.weights			== nullptr	or
+		l.weights_half		!= nullptr	or
+		l.weights_int8		!= nullptr	or
+		l.winograd_weights	!= nullptr	or
+		l.weights_nhwc		!= nullptr	or
+		l.xnor							or
+		l.binary						or
+		l.deform						or
+		l.batch_normalize				or	// weights must already be fused with fuse_conv_batchnorm()
+		l.activation == NORM_CHAN		or
+		l.activation == NORM_CHAN_SOFTMAX	or
+		l.activation == NORM_CHAN_SOFTMAX_MAXVAL)
+	{
+		return false;
+	}
+
+	l.weights_half = (uint16_t *)xcalloc(l.nweights, sizeof(uint16_t));
+	float_to_half(l.weights, l.weights_half, l.nweights, storage == Darknet::EWeightsStorage::BF16);
+	l.weights_storage = storage;
+
+	// the FP32 weights are not needed anymore, which is the whole point
+	if (not l.weights_mapped)
+	{
+		free(l.weights);
+	}
+	l.weights = nullptr;
+
+	return true;
+}
+
+
 void forward_convolutional_layer(Darknet::Layer & l, Darknet::NetworkState state)
 {
 	TAT(TATPARMS);
@@ -1446,7 +2387,44 @@ void forward_convolutional_layer(Darknet::Layer & l, Darknet::NetworkState state
 	int out_w = convolutional_out_width(l);
 	int i, j;
 
-	fill_cpu(l.outputs*l.batch, 0, l.output, 1);
+	const bool use_int8			= (l.weights_int8 && not state.train && not l.batch_normalize);
+	const bool use_winograd		= (not use_int8 && l.winograd_weights && not state.train);
+	const bool use_depthwise	= (not use_int8 && not use_winograd && not l.xnor && l.groups > 1 && l.c == l.groups);
+	const bool use_groups		= (not use_int8 && not use_winograd && not use_depthwise && not l.xnor && use_parallel_groups(l));
+	const bool fuse_epilogue	= (use_int8 || (not use_winograd && not use_depthwise && use_gemm_epilogue(l, state)));
+
+	// Winograd, INT8, and the fused GEMM epilogue overwrite every output value, the other paths accumulate into the output
+	if (not use_winograd && not fuse_epilogue)
+	{
+		fill_cpu(l.outputs*l.batch, 0, l.output, 1);
+	}
+
+	// none of the specialised CPU paths use XNOR, so they run before the binary inputs are prepared
+	if (use_int8 || use_winograd || use_depthwise || use_groups)
+	{
+		if (use_int8)
+		{
+			forward_convolutional_layer_int8(l, state, out_h, out_w);
+		}
+		else if (use_winograd)
+		{
+			for (i = 0; i < l.batch; ++i)
+			{
+				winograd_convolution(l.winograd_weights, l.n, l.c, l.h, l.w, l.pad, state.input + i * l.inputs, l.output + i * l.outputs, out_h, out_w, state.workspace);
+			}
+		}
+		else if (use_depthwise)
+		{
+			forward_depthwise_convolution(l, state.input, l.output, out_h, out_w);
+		}
+		else if (use_groups)
+		{
+			forward_grouped_convolution(l, state.input, l.output, out_h, out_w, fuse_epilogue);
+		}
+
+		finish_forward_convolutional_layer(l, state, fuse_epilogue);
+		return;
+	}
 
 	if (l.xnor && (!l.align_bit_weights || state.train)) {
 		if (!l.align_bit_weights || state.train) {
@@ -1618,7 +2596,22 @@ void forward_convolutional_layer(Darknet::Layer & l, Darknet::NetworkState state
 
 				}
 
-				gemm(0, 0, m, n, k, 1, a, k, b, n, 1, c, n);
+				if (l.weights_half)
+				{
+					// FP16 or BF16 weights are only ever used for inference, and only without groups
+					const bool bf16 = (l.weights_storage == Darknet::EWeightsStorage::BF16);
+					const Gemm_Epilogue epilogue = { fuse_epilogue, fuse_epilogue ? l.biases : nullptr, fuse_epilogue ? l.activation : LINEAR, false };
+					gemm_nn_fused_half(m, n, k, l.weights_half, k, bf16, b, n, c, n, epilogue);
+				}
+				else if (fuse_epilogue)
+				{
+					const Gemm_Epilogue epilogue = { true, l.biases + j * m, l.activation, false };
+					gemm_nn_fused(m, n, k, 1, a, k, b, n, c, n, epilogue);
+				}
+				else
+				{
+					gemm(0, 0, m, n, k, 1, a, k, b, n, 1, c, n);
+				}
 				// bit-count to float
 			}
 			//c += n*m;
@@ -1626,43 +2619,7 @@ void forward_convolutional_layer(Darknet::Layer & l, Darknet::NetworkState state
 		}
 	}
 
-	if(l.batch_normalize){
-		forward_batchnorm_layer(l, state);
-	}
-	else {
-		add_bias(l.output, l.biases, l.batch, l.n, out_h*out_w);
-	}
-
-	//activate_array(l.output, m*n*l.batch, l.activation);
-	if (l.activation == SWISH) activate_array_swish(l.output, l.outputs*l.batch, l.activation_input, l.output);
-	else if (l.activation == MISH) activate_array_mish(l.output, l.outputs*l.batch, l.activation_input, l.output);
-	else if (l.activation == HARD_MISH) activate_array_hard_mish(l.output, l.outputs*l.batch, l.activation_input, l.output);
-	else if (l.activation == NORM_CHAN) activate_array_normalize_channels(l.output, l.outputs*l.batch, l.batch, l.out_c, l.out_w*l.out_h, l.output);
-	else if (l.activation == NORM_CHAN_SOFTMAX) activate_array_normalize_channels_softmax(l.output, l.outputs*l.batch, l.batch, l.out_c, l.out_w*l.out_h, l.output, 0);
-	else if (l.activation == NORM_CHAN_SOFTMAX_MAXVAL) activate_array_normalize_channels_softmax(l.output, l.outputs*l.batch, l.batch, l.out_c, l.out_w*l.out_h, l.output, 1);
-	else activate_array_cpu_custom(l.output, l.outputs*l.batch, l.activation);
-
-	if(l.binary || l.xnor) swap_binary(&l);
-
-	//visualize_convolutional_layer(l, "conv_visual", NULL);
-	//cv::waitKey(0);
-
-	if (l.assisted_excitation && state.train)
-	{
-		assisted_excitation_forward(l, state);
-	}
-
-	if (l.antialiasing)
-	{
-		Darknet::NetworkState s = { 0 };
-		s.train = state.train;
-		s.workspace = state.workspace;
-		s.net = state.net;
-		s.input = l.output;
-		forward_convolutional_layer(*(l.input_layer), s);
-		//simple_copy_ongpu(l.outputs*l.batch, l.output, l.input_antialiasing);
-		memcpy(l.output, l.input_layer->output, l.input_layer->outputs * l.input_layer->batch * sizeof(float));
-	}
+	finish_forward_convolutional_layer(l, state, fuse_epilogue);
 }
 
 void assisted_excitation_forward(Darknet::Layer & l, Darknet::NetworkState state)
@@ -20,12 +20,62 @@ void cuda_convert_f32_to_f16(float* input_f32, size_t size, float *output_f16);
 #endif
 void free_convolutional_batchnorm(Darknet::Layer *l);
 
+/** Pre-transform the weights of a 3x3 stride-1 convolutional layer so CPU inference can use Winograd F(2x2,3x3).
+ * Must be called after @ref fuse_conv_batchnorm().  The layer is left on the im2col + GEMM path when it does not
+ * qualify or when Winograd does not match a direct convolution closely enough.
+ *
+ * @returns @p true if the layer will use Winograd
+ *
+ * @since 2026-10-17
+ */
+bool prepare_winograd_convolution(Darknet::Layer & l);
+
+/** Whether a convolutional layer can run on the INT8 path.  Grouped, dilated, binary, and deformable layers cannot, nor
+ * layers which still have batch-norm or which normalize across channels in their activation.
+ * @since 2026-10-17
+ */
+bool can_quantize_convolutional_layer(const Darknet::Layer & l);
+
+/** Quantize the weights of a convolutional layer to 8 bits per output channel, and the expected range of its input
+ * (collected during calibration) to 7 bits, so CPU inference can use the INT8 path.  Must be called after
+ * @ref fuse_conv_batchnorm().
+ * @since 2026-10-17
+ */
+void quantize_convolutional_layer(Darknet::Layer & l, float input_min, float input_max);
+
+/** Give a convolutional layer INT8 weights which were previously created by @ref quantize_convolutional_layer(), such
+ * as when they are loaded from a file.  @p weights has @p l.n rows padded to a multiple of 32 bytes.
+ * @since 2026-10-17
+ */
+void set_convolutional_layer_int8(Darknet::Layer & l, float input_scale, int zero_point, const std::vector<float> & scales, const std::vector<int8_t> & weights);
+
+/** Replace the FP32 weights of a convolutional layer with FP16 or BF16 weights for CPU inference.  Only layers which
+ * use im2col + GEMM are converted, not the ones using Winograd, INT8, channels-last, groups, or binary weights.
+ *
+ * @returns @p true if the layer was converted
+ *
+ * @see @ref prepare_weights_storage()
+ * @since 2026-10-17
+ */
+bool convert_convolutional_weights_storage(Darknet::Layer & l, const Darknet::EWeightsStorage storage);
+
 size_t get_convolutional_workspace_size(const Darknet::Layer & l);
 Darknet::Layer make_convolutional_layer(int batch, int steps, int h, int w, int c, int n, int groups, int size, int stride_x, int stride_y, int dilation, int padding, ACTIVATION activation, int batch_normalize, int binary, int xnor, int adam, int use_bin_output, int index, int antialiasing, Darknet::Layer * share_layer, int assisted_excitation, int deform, int train);
 void denormalize_convolutional_layer(Darknet::Layer & l);
 void set_specified_workspace_limit(Darknet::Layer *l, size_t workspace_size_limit);
 void resize_convolutional_layer(Darknet::Layer * l, int w, int h);
 void forward_convolutional_layer(Darknet::Layer & l, Darknet::NetworkState state);
+
+/** Channels-last (NHWC) forward pass for inference.  The bias and activation are applied by the GEMM epilogue, so the
+ * layer must not have batch-norm left and must use an element-wise activation.
+ *
+ * @see @ref prepare_channels_last()
+ * @since 2026-10-17
+ */
+void forward_convolutional_layer_nhwc(Darknet::Layer & l, Darknet::NetworkState state);
+
+/// Re-order the weights for @ref forward_convolutional_layer_nhwc().  @since 2026-10-17
+void prepare_convolutional_layer_nhwc(Darknet::Layer & l);
 void update_convolutional_layer(Darknet::Layer & l, int batch, float learning_rate, float momentum, float decay);
 Darknet::Image *visualize_convolutional_layer(const Darknet::Layer & l, const char * window, Darknet::Image * prev_weights);
 void binarize_weights(float *weights, int n, int size, float *binary);
@@ -7,15 +7,17 @@ static void increment_layer(Darknet::Layer *l, int steps)
 
 	int num = l->outputs*l->batch*steps;
 	l->output += num;
-	l->delta += num;
-	l->x += num;
-	l->x_norm += num;
+
+	// these buffers are only allocated when training
+	if (l->delta)	l->delta += num;
+	if (l->x)		l->x += num;
+	if (l->x_norm)	l->x_norm += num;
 
 #ifdef GPU
 	l->output_gpu += num;
-	l->delta_gpu += num;
-	l->x_gpu += num;
-	l->x_norm_gpu += num;
+	if (l->delta_gpu)	l->delta_gpu += num;
+	if (l->x_gpu)		l->x_gpu += num;
+	if (l->x_norm_gpu)	l->x_norm_gpu += num;
 #endif
 }
 
@@ -210,6 +212,15 @@ void forward_crnn_layer(Darknet::Layer & l, Darknet::NetworkState state)
 		increment_layer(&self_layer, 1);
 		increment_layer(&output_layer, 1);
 	}
+
+	// the layer and sublayers are references, so rewind them for the next call
+	if (state.train)
+	{
+		l.state -= l.hidden*l.batch*l.steps;
+	}
+	increment_layer(&input_layer, -l.steps);
+	increment_layer(&self_layer, -l.steps);
+	increment_layer(&output_layer, -l.steps);
 }
 
 void backward_crnn_layer(Darknet::Layer & l, Darknet::NetworkState state)
@@ -278,6 +289,11 @@ void backward_crnn_layer(Darknet::Layer & l, Darknet::NetworkState state)
 		increment_layer(&self_layer, -1);
 		increment_layer(&output_layer, -1);
 	}
+
+	// the loop above stops one step before the start of the buffers
+	increment_layer(&input_layer, 1);
+	increment_layer(&self_layer, 1);
+	increment_layer(&output_layer, 1);
 }
 
 #ifdef GPU
@@ -124,6 +124,161 @@ namespace
 
 		return;
 	}
+
+	/** Resize the OpenCV image to match the network dimensions, and convert it from BGR to RGB.  This is the common
+	 * preprocessing used by both the single image and the batch versions of @ref Darknet::predict().
+	 *
+	 * Remember to call @ref Darknet::free_image() once the image is no longer needed.
+	 */
+	static inline Darknet::Image convert_mat_for_network(const Darknet::Network * net, const cv::Mat & mat)
+	{
+		const cv::Size network_dimensions(net->w, net->h);
+
+		cv::Mat bgr;
+		if (mat.size() != network_dimensions)
+		{
+			// Note that INTER_NEAREST gives us *speed*, not image quality.
+			//
+			// If quality matters, you'll want to resize the image yourself
+			// using INTER_AREA, INTER_CUBIC or INTER_LINEAR prior to calling
+			// predict().  See DarkHelp or OpenCV documentation for details.
+
+			cv::resize(mat, bgr, network_dimensions, cv::INTER_NEAREST);
+		}
+		else
+		{
+			bgr = mat;
+		}
+
+		// OpenCV uses BGR, but Darknet requires RGB
+		cv::Mat rgb;
+		if (bgr.channels() == 3)
+		{
+			cv::cvtColor(bgr, rgb, cv::COLOR_BGR2RGB);
+		}
+		else if (bgr.channels() == 4)
+		{
+			cv::cvtColor(bgr, rgb, cv::COLOR_BGRA2RGB);
+		}
+		else
+		{
+			// we have no idea what image format this might be
+			rgb = bgr;
+		}
+
+		return Darknet::mat_to_image(rgb);
+	}
+
+	/** Whether the image can skip @ref convert_mat_for_network() and be written directly into the network input by
+	 * @ref Darknet::bgr_mat_to_rgb_planar().
+	 */
+	static inline bool can_use_fused_preprocessing(const Darknet::Network * net, const cv::Mat & mat)
+	{
+		if (mat.depth() != CV_8U)
+		{
+			return false;
+		}
+
+		const int channels = mat.channels();
+
+		return (net->c == 3 and (channels == 3 or channels == 4)) or (net->c == 1 and channels == 1);
+	}
+
+	/** Convert the image into the network input buffer at the given image index.  The buffer must already be large
+	 * enough for the batch.
+	 */
+	static inline void prepare_network_input(Darknet::Network * net, const cv::Mat & mat, const int idx)
+	{
+		const size_t image_size = static_cast<size_t>(net->w) * net->h * net->c;
+		float * dst = net->details->input_buffer.data() + image_size * idx;
+
+		if (can_use_fused_preprocessing(net, mat))
+		{
+			Darknet::bgr_mat_to_rgb_planar(mat, dst, net->w, net->h);
+		}
+		else
+		{
+			Darknet::Image img = convert_mat_for_network(net, mat);
+			std::memcpy(dst, img.data, image_size * sizeof(float));
+			Darknet::free_image(img);
+		}
+
+		return;
+	}
+
+	/** Apply NMS and convert the old-style %Darknet detections to the new C++ predictions.  The detections are freed
+	 * before this function returns.
+	 */
+	static inline Darknet::Predictions convert_detections_to_predictions(Darknet::Network * net, Darknet::Detection * darknet_results, const int nboxes, const cv::Size & original_image_size)
+	{
+		if (net->details->non_maximal_suppression_threshold)
+		{
+			auto & layer = net->layers[net->n - 1];
+			do_nms_sort(darknet_results, nboxes, layer.classes, net->details->non_maximal_suppression_threshold);
+		}
+
+		Darknet::Predictions predictions;
+		predictions.reserve(nboxes); // this is likely too many (depends on the detection threshold) but gets us in the ballpark
+
+		for (int detection_idx = 0; detection_idx < nboxes; detection_idx ++)
+		{
+			auto & det = darknet_results[detection_idx];
+
+			/* The "det" object has an array called det.prob[].  That array is large enough for 1 entry per class in the network.
+			 * Each entry will be set to 0.0f, except for the ones that correspond to the class that was detected.  Note that it
+			 * is possible that multiple entries are non-zero!  We need to look at every entry and remember which ones are set.
+			 */
+
+			Darknet::Prediction pred;
+			pred.best_class = -1;
+
+			for (int class_idx = 0; class_idx < det.classes; class_idx ++)
+			{
+				const auto probability = det.prob[class_idx];
+				if (probability >= net->details->detection_threshold)
+				{
+					// remember this probability since it is higher than the user-specified threshold
+					pred.prob[class_idx] = probability;
+					if (pred.best_class == -1 or probability > det.prob[pred.best_class])
+					{
+						pred.best_class = class_idx;
+					}
+				}
+			}
+
+			// most of the output from Darknet/YOLO will have a confidence of 0.0f which we need to completely ignore
+			if (pred.best_class == -1)
+			{
+				continue;
+			}
+
+			// optional:  sometimes there are classes we want to completely ignore
+			if (net->details->classes_to_ignore.count(pred.best_class))
+			{
+				continue;
+			}
+
+			if (net->details->fix_out_of_bound_normalized_coordinates)
+			{
+				fix_out_of_bound_normalized_rect(det.bbox.x, det.bbox.y, det.bbox.w, det.bbox.h);
+			}
+
+			const int w = std::round(det.bbox.w * original_image_size.width				);
+			const int h = std::round(det.bbox.h * original_image_size.height			);
+			const int x = std::round(det.bbox.x * original_image_size.width	- w / 2.0f	);
+			const int y = std::round(det.bbox.y * original_image_size.height- h / 2.0f	);
+
+			pred.rect				= cv::Rect(cv::Point(x, y), cv::Size(w, h));
+			pred.normalized_point	= cv::Point2f(det.bbox.x, det.bbox.y);
+			pred.normalized_size	= cv::Size2f(det.bbox.w, det.bbox.h);
+
+			predictions.push_back(pred);
+		}
+
+		free_detections(darknet_results, nboxes);
+
+		return predictions;
+	}
 }
 
 
@@ -241,6 +396,13 @@ extern "C"
 		return;
 	}
 
+	DarknetNetworkPtr darknet_clone_neural_network(const DarknetNetworkPtr ptr)
+	{
+		TAT(TATPARMS);
+
+		return Darknet::clone_neural_network(ptr);
+	}
+
 	void darknet_clear_skipped_classes(DarknetNetworkPtr ptr)
 	{
 		TAT(TATPARMS);
@@ -1187,6 +1349,85 @@ void Darknet::free_neural_network(Darknet::NetworkPtr & ptr)
 }
 
 
+Darknet::NetworkPtr Darknet::clone_neural_network(const Darknet::NetworkPtr ptr)
+{
+	TAT(TATPARMS);
+
+	const Darknet::Network * net = reinterpret_cast<const Darknet::Network *>(ptr);
+	if (net == nullptr)
+	{
+		throw std::invalid_argument("cannot clone a neural network without a network pointer");
+	}
+
+	if (net->details == nullptr or net->details->cfg_path.empty())
+	{
+		throw std::invalid_argument("cannot clone a neural network which was not loaded from a configuration file");
+	}
+
+	// the new network allocates its own outputs and workspace, and temporarily its own weights
+	Darknet::Network * clone = (Darknet::Network*)xcalloc(1, sizeof(Darknet::Network));
+	*clone = parse_network_cfg_custom(net->details->cfg_path.string().c_str(), net->batch, 1);
+
+	if (clone->n != net->n)
+	{
+		darknet_fatal_error(DARKNET_LOC, "cloned network has %d layers but the original has %d", clone->n, net->n);
+	}
+
+	*clone->details = *net->details;
+	clone->details->shares_weights = true;
+	clone->details->output_arenas.clear();
+	clone->details->planned_layers.clear();
+	clone->details->input_buffer.clear();
+	clone->details->channels_last = false;
+	clone->details->channels_last_input.clear();
+	clone->details->scheduler.reset();
+	*clone->seen = *net->seen;
+	*clone->cur_iteration = *net->cur_iteration;
+
+	for (int idx = 0; idx < net->n; idx ++)
+	{
+		share_layer_weights(clone->layers[idx], net->layers[idx]);
+	}
+
+	// the Winograd and INT8 weights which were just shared need a larger workspace than the .cfg file describes
+	if (cfg_and_state.gpu_index < 0)
+	{
+		recalculate_workspace_size(clone);
+	}
+
+	// XNOR layers keep packed copies of the weights alongside the layer outputs, so these are rebuilt per clone
+	calculate_binary_weights(clone);
+
+	// the re-ordered channels-last weights are shared, but each clone needs its own layer functions switched over
+	if (net->details->channels_last)
+	{
+		prepare_channels_last(*clone);
+	}
+
+	// the packed LSTM gates are shared, but each clone needs its own gate buffers
+	for (int idx = 0; idx < net->n; idx ++)
+	{
+		if (net->layers[idx].lstm_gate_weights)
+		{
+			prepare_lstm_layer_inference(clone->layers[idx]);
+		}
+	}
+
+	if (not net->details->output_arenas.empty())
+	{
+		plan_inference_memory(*clone);
+	}
+
+	// each clone has its own outputs and workspaces, so it also needs its own scheduler
+	if (net->details->scheduler)
+	{
+		prepare_layer_scheduler(*clone);
+	}
+
+	return clone;
+}
+
+
 void Darknet::network_dimensions(Darknet::NetworkPtr & ptr, int & w, int & h, int & c)
 {
 	TAT(TATPARMS);
@@ -1223,44 +1464,22 @@ Darknet::Predictions Darknet::predict(const Darknet::NetworkPtr ptr, const cv::M
 		throw std::invalid_argument("cannot predict without a valid image");
 	}
 
-	const cv::Size network_dimensions(net->w, net->h);
-	const cv::Size original_image_size = mat.size();
-
-	cv::Mat bgr;
-	if (mat.size() != network_dimensions)
+	// the batch size may have been changed by a previous call to the batch version of predict()
+	if (net->batch != 1)
 	{
-		// Note that INTER_NEAREST gives us *speed*, not image quality.
-		//
-		// If quality matters, you'll want to resize the image yourself
-		// using INTER_AREA, INTER_CUBIC or INTER_LINEAR prior to calling
-		// predict().  See DarkHelp or OpenCV documentation for details.
-
-		cv::resize(mat, bgr, network_dimensions, cv::INTER_NEAREST);
-	}
-	else
-	{
-		bgr = mat;
+		set_batch_network(net, 1);
 	}
 
-	// OpenCV uses BGR, but Darknet requires RGB
-	cv::Mat rgb;
-	if (bgr.channels() == 3)
-	{
-		cv::cvtColor(bgr, rgb, cv::COLOR_BGR2RGB);
-	}
-	else if (bgr.channels() == 4)
-	{
-		cv::cvtColor(bgr, rgb, cv::COLOR_BGRA2RGB);
-	}
-	else
-	{
-		// we have no idea what image format this might be
-		rgb = bgr;
-	}
+	net->details->input_buffer.resize(static_cast<size_t>(net->w) * net->h * net->c);
+	prepare_network_input(net, mat, 0);
 
-	Darknet::Image img = mat_to_image(rgb);
+	network_predict(*net, net->details->input_buffer.data());
+
+	int nboxes = 0;
+	const float hierarchy_threshold = 0.5f;
+	auto darknet_results = get_network_boxes(net, net->w, net->h, net->details->detection_threshold, hierarchy_threshold, 0, 1, &nboxes, 0);
 
-	return predict(ptr, img, original_image_size);
+	return convert_detections_to_predictions(net, darknet_results, nboxes, mat.size());
 }
 
 
@@ -1279,95 +1498,175 @@ Darknet::Predictions Darknet::predict(Darknet::NetworkPtr ptr, Darknet::Image &
 	if (original_image_size.width	< 1) original_image_size.width	= img.w;
 	if (original_image_size.height	< 1) original_image_size.height	= img.h;
 
-	network_predict(*net, img.data); /// todo pass net by ref or pointer, not copy constructor!
+	// the batch size may have been changed by a previous call to the batch version of predict()
+	if (net->batch != 1)
+	{
+		set_batch_network(net, 1);
+	}
+
+	network_predict(*net, img.data);
 	Darknet::free_image(img);
 
 	int nboxes = 0;
 	const float hierarchy_threshold = 0.5f;
 	auto darknet_results = get_network_boxes(net, img.w, img.h, net->details->detection_threshold, hierarchy_threshold, 0, 1, &nboxes, 0);
 
-	if (net->details->non_maximal_suppression_threshold)
+	return convert_detections_to_predictions(net, darknet_results, nboxes, original_image_size);
+}
+
+
+Darknet::Predictions Darknet::predict(const Darknet::NetworkPtr ptr, const std::filesystem::path & image_filename)
+{
+	TAT(TATPARMS);
+
+	if (not std::filesystem::exists(image_filename))
 	{
-		auto & layer = net->layers[net->n - 1];
-		do_nms_sort(darknet_results, nboxes, layer.classes, net->details->non_maximal_suppression_threshold);
+		throw std::invalid_argument("cannot predict due to invalid image filename: \"" + image_filename.string() + "\"");
 	}
 
-	Predictions predictions;
-	predictions.reserve(nboxes); // this is likely too many (depends on the detection threshold) but gets us in the ballpark
+	cv::Mat mat = cv::imread(image_filename.string());
 
-	for (int detection_idx = 0; detection_idx < nboxes; detection_idx ++)
-	{
-		auto & det = darknet_results[detection_idx];
+	return predict(ptr, mat);
+}
 
-		/* The "det" object has an array called det.prob[].  That array is large enough for 1 entry per class in the network.
-		 * Each entry will be set to 0.0f, except for the ones that correspond to the class that was detected.  Note that it
-		 * is possible that multiple entries are non-zero!  We need to look at every entry and remember which ones are set.
-		 */
 
-		Prediction pred;
-		pred.best_class = -1;
+Darknet::VPredictions Darknet::predict(const Darknet::NetworkPtr ptr, const std::vector<cv::Mat> & mats)
+{
+	TAT(TATPARMS);
 
-		for (int class_idx = 0; class_idx < det.classes; class_idx ++)
-		{
-			const auto probability = det.prob[class_idx];
-			if (probability >= net->details->detection_threshold)
-			{
-				// remember this probability since it is higher than the user-specified threshold
-				pred.prob[class_idx] = probability;
-				if (pred.best_class == -1 or probability > det.prob[pred.best_class])
-				{
-					pred.best_class = class_idx;
-				}
-			}
-		}
+	Darknet::Network * net = reinterpret_cast<Darknet::Network *>(ptr);
+	if (net == nullptr)
+	{
+		throw std::invalid_argument("cannot predict without a network pointer");
+	}
 
-		// most of the output from Darknet/YOLO will have a confidence of 0.0f which we need to completely ignore
-		if (pred.best_class == -1)
-		{
-			continue;
-		}
+	VPredictions results;
+	if (mats.empty())
+	{
+		return results;
+	}
 
-		// optional:  sometimes there are classes we want to completely ignore
-		if (net->details->classes_to_ignore.count(pred.best_class))
+	for (const auto & mat : mats)
+	{
+		if (mat.empty())
 		{
-			continue;
+			throw std::invalid_argument("cannot predict without a valid image");
 		}
+	}
 
-		if (net->details->fix_out_of_bound_normalized_coordinates)
-		{
-			fix_out_of_bound_normalized_rect(det.bbox.x, det.bbox.y, det.bbox.w, det.bbox.h);
-		}
+	const int batch = static_cast<int>(mats.size());
+	if (batch > net->batch)
+	{
+		/* The layer outputs were allocated for the batch size in use when the network was created.  Resizing the
+		 * network to the same dimensions will re-allocate all the layer buffers using the new (larger) batch size.
+		 */
+		set_batch_network(net, batch);
+		resize_network(net, net->w, net->h);
+	}
+	else if (batch != net->batch)
+	{
+		// the buffers are already large enough, we only need to tell the layers how many images are in this batch
+		set_batch_network(net, batch);
+	}
+
+	// pack all of the images into a single input tensor
+	net->details->input_buffer.resize(static_cast<size_t>(net->w) * net->h * net->c * batch);
+	for (int idx = 0; idx < batch; idx ++)
+	{
+		prepare_network_input(net, mats[idx], idx);
+	}
 
-		const int w = std::round(det.bbox.w * original_image_size.width				);
-		const int h = std::round(det.bbox.h * original_image_size.height			);
-		const int x = std::round(det.bbox.x * original_image_size.width	- w / 2.0f	);
-		const int y = std::round(det.bbox.y * original_image_size.height- h / 2.0f	);
+	// a single forward pass for the entire batch
+	network_predict(*net, net->details->input_buffer.data());
 
-		pred.rect				= cv::Rect(cv::Point(x, y), cv::Size(w, h));
-		pred.normalized_point	= cv::Point2f(det.bbox.x, det.bbox.y);
-		pred.normalized_size	= cv::Size2f(det.bbox.w, det.bbox.h);
+	// split the YOLO output back into individual images
+	const float hierarchy_threshold = 0.5f;
+	results.reserve(batch);
+	for (int idx = 0; idx < batch; idx ++)
+	{
+		int nboxes = 0;
+		auto darknet_results = make_network_boxes_batch(net, net->details->detection_threshold, &nboxes, idx);
+		fill_network_boxes_batch(net, net->w, net->h, net->details->detection_threshold, hierarchy_threshold, nullptr, 1, darknet_results, 0, idx);
 
-		predictions.push_back(pred);
+		results.push_back(convert_detections_to_predictions(net, darknet_results, nboxes, mats[idx].size()));
 	}
 
-	free_detections(darknet_results, nboxes);
+	return results;
+}
 
-	return predictions;
+
+float * Darknet::bind_input(Darknet::NetworkPtr ptr)
+{
+	TAT(TATPARMS);
+
+	Darknet::Network * net = reinterpret_cast<Darknet::Network *>(ptr);
+	if (net == nullptr)
+	{
+		throw std::invalid_argument("cannot bind the input without a network pointer");
+	}
+
+	// resize() keeps the same memory from one call to the next as long as the size does not change
+	net->details->input_buffer.resize(static_cast<size_t>(net->w) * net->h * net->c * net->batch);
+
+	return net->details->input_buffer.data();
 }
 
 
-Darknet::Predictions Darknet::predict(const Darknet::NetworkPtr ptr, const std::filesystem::path & image_filename)
+void Darknet::run(Darknet::NetworkPtr ptr)
 {
 	TAT(TATPARMS);
 
-	if (not std::filesystem::exists(image_filename))
+	Darknet::Network * net = reinterpret_cast<Darknet::Network *>(ptr);
+	if (net == nullptr)
 	{
-		throw std::invalid_argument("cannot predict due to invalid image filename: \"" + image_filename.string() + "\"");
+		throw std::invalid_argument("cannot run without a network pointer");
 	}
 
-	cv::Mat mat = cv::imread(image_filename.string());
+	if (net->details->input_buffer.size() < static_cast<size_t>(net->w) * net->h * net->c * net->batch)
+	{
+		throw std::logic_error("cannot run the network without first calling bind_input()");
+	}
 
-	return predict(ptr, mat);
+	network_predict(*net, net->details->input_buffer.data());
+
+	return;
+}
+
+
+Darknet::OutputViews Darknet::outputs(const Darknet::NetworkPtr ptr)
+{
+	TAT(TATPARMS);
+
+	Darknet::Network * net = reinterpret_cast<Darknet::Network *>(ptr);
+	if (net == nullptr)
+	{
+		throw std::invalid_argument("cannot get the outputs without a network pointer");
+	}
+
+	OutputViews views;
+	for (int idx = 0; idx < net->n; idx ++)
+	{
+		Darknet::Layer & l = net->layers[idx];
+		if (l.type == Darknet::ELayerType::YOLO			or
+			l.type == Darknet::ELayerType::GAUSSIAN_YOLO	or
+			l.type == Darknet::ELayerType::REGION)
+		{
+			// the caller expects the same activated values as when lazy_class_activation is not used
+			activate_yolo_classes(l);
+
+			OutputView view;
+			view.layer_index	= idx;
+			view.data			= l.output;
+			view.w				= l.out_w;
+			view.h				= l.out_h;
+			view.c				= l.out_c;
+			view.batch			= l.batch;
+			view.size			= static_cast<size_t>(l.outputs);
+			views.push_back(view);
+		}
+	}
+
+	return views;
 }
 
 
@@ -78,6 +78,9 @@ DarknetNetworkPtr darknet_load_neural_network(const char * const cfg_filename, c
 /// This is the @p C equivalent to @ref Darknet::free_neural_network().
 void darknet_free_neural_network(DarknetNetworkPtr * ptr);
 
+/// This is the @p C equivalent to @ref Darknet::clone_neural_network().
+DarknetNetworkPtr darknet_clone_neural_network(const DarknetNetworkPtr ptr);
+
 /// This is the @p C equivalent to @ref Darknet::clear_skipped_classes().
 void darknet_clear_skipped_classes(DarknetNetworkPtr ptr);
 
@@ -365,6 +365,19 @@ namespace Darknet
 	 */
 	void free_neural_network(Darknet::NetworkPtr & ptr);
 
+	/** Create an additional inference context for a neural network that was loaded with
+	 * @ref Darknet::load_neural_network().  The new network has its own layer outputs and workspace, but the weights,
+	 * biases, and batch norm parameters point to those of the original network, so only a single copy of the weights
+	 * is kept in memory.  This way several threads can call @ref Darknet::predict() at the same time, as long as each
+	 * thread uses a different network pointer.
+	 *
+	 * The clone must be freed with @ref Darknet::free_neural_network() @em before the original network is freed.
+	 * Settings such as thresholds and class names are copied from the original network when the clone is created.
+	 *
+	 * @since 2026-10-17
+	 */
+	Darknet::NetworkPtr clone_neural_network(const Darknet::NetworkPtr ptr);
+
 	/// Get the network dimensions (width, height, channels).  @since 2024-07-25
 	void network_dimensions(Darknet::NetworkPtr & ptr, int & w, int & h, int & c);
 
@@ -393,6 +406,15 @@ namespace Darknet
 	 */
 	using Predictions = std::vector<Prediction>;
 
+	/** When several images or video frames are processed together in a single batch, the predictions for each image are
+	 * returned in a vector.  The order of the results matches the order of the images that were passed in.
+	 *
+	 * @see @ref Darknet::predict()
+	 *
+	 * @since 2026-10-17
+	 */
+	using VPredictions = std::vector<Predictions>;
+
 	/** Get %Darknet to look at the given image or video frame and return all predictions.
 	 *
 	 * This is similar to the other @ref Darknet::predict() that takes a @p Darknet::Image object as input.
@@ -423,6 +445,72 @@ namespace Darknet
 	 */
 	Predictions predict(const Darknet::NetworkPtr ptr, const std::filesystem::path & image_filename);
 
+	/** Get %Darknet to look at several images or video frames at once and return all predictions.  The images are packed
+	 * into a single input tensor so the network runs a single forward pass for the entire batch, which is much more
+	 * efficient than calling @ref Darknet::predict() once per image.  The images may be of different sizes.
+	 *
+	 * The results are returned in the same order as the images.  Each individual @ref Darknet::Predictions is identical
+	 * to what would have been returned by calling @ref Darknet::predict() on that image.
+	 *
+	 * As with the other @ref Darknet::predict() that takes a single @p cv::Mat, the images must be in the usual OpenCV
+	 * BGR format.
+	 *
+	 * @note If the number of images is larger than the batch size for which the network was created, the network buffers
+	 * are re-allocated to accommodate the larger batch.  Keep the number of images the same from one call to the next to
+	 * avoid repeated allocations.
+	 *
+	 * @since 2026-10-17
+	 */
+	VPredictions predict(const Darknet::NetworkPtr ptr, const std::vector<cv::Mat> & mats);
+
+	/** A read-only view of the output of one YOLO, Gaussian YOLO, or region layer, as returned by @ref Darknet::outputs().
+	 * The memory belongs to the network and is overwritten by the next call to @ref Darknet::run() or
+	 * @ref Darknet::predict().
+	 *
+	 * @since 2026-10-17
+	 */
+	struct OutputView
+	{
+		int layer_index; ///< Zero-based index of the layer in the network.
+		const float * data; ///< The layer output for every image in the batch.
+		int w; ///< Width of the output grid.
+		int h; ///< Height of the output grid.
+		int c; ///< Number of values per grid cell, which is the number of anchors multiplied by the values per anchor.
+		int batch; ///< Number of images in @p data.
+		size_t size; ///< Number of floats for each image, which is @p w x @p h x @p c.
+	};
+
+	/// The output views for all of the detection layers in a network, in layer order.  @since 2026-10-17
+	using OutputViews = std::vector<OutputView>;
+
+	/** Get a pointer to the network's own input buffer so callers can write the next image or batch directly into it
+	 * instead of creating a @p cv::Mat or @ref Darknet::Image for each frame.  The buffer holds @p batch planar RGB images
+	 * of the network dimensions (see @ref Darknet::network_dimensions()) with values between 0.0 and 1.0.
+	 *
+	 * The pointer remains valid until the batch size or the network dimensions change, or the network is freed.  The
+	 * @p cv::Mat versions of @ref Darknet::predict() also use this buffer and will overwrite any bound input.
+	 *
+	 * @see @ref Darknet::run()
+	 *
+	 * @since 2026-10-17
+	 */
+	float * bind_input(Darknet::NetworkPtr ptr);
+
+	/** Run the network on the input written into the buffer returned by @ref Darknet::bind_input().  Nothing is copied
+	 * or allocated.  Use @ref Darknet::outputs() to get at the raw results.
+	 *
+	 * @since 2026-10-17
+	 */
+	void run(Darknet::NetworkPtr ptr);
+
+	/** Get views into the outputs of the YOLO, Gaussian YOLO, and region layers after @ref Darknet::run() or
+	 * @ref Darknet::predict().  No data is copied.  When the .cfg file has @p lazy_class_activation=1, the YOLO class
+	 * values are activated in place before the views are returned.
+	 *
+	 * @since 2026-10-17
+	 */
+	OutputViews outputs(const Darknet::NetworkPtr ptr);
+
 	/** Annotate the given image using the predictions from @ref Darknet::predict().
 	 *
 	 * @see @ref Darknet::predict_and_annotate()
@@ -99,6 +99,7 @@ const Darknet::SArgsAndParms & Darknet::get_all_possible_arguments()
 		ArgsAndParms("average"		, ArgsAndParms::EType::kCommand	, ""),
 		ArgsAndParms("calcanchors"	, ArgsAndParms::EType::kFunction, "Recalculate YOLO anchors."),
 		ArgsAndParms("cfglayers"	, ArgsAndParms::EType::kCommand, "Display some information on all config files and layers used."),
+		ArgsAndParms("convert"		, ArgsAndParms::EType::kCommand	, "Convert .weights to or from the memory-mapped format which loads much faster."),
 		ArgsAndParms("denormalize"	, ArgsAndParms::EType::kCommand	, ""),
 		ArgsAndParms("detect"		, ArgsAndParms::EType::kCommand	, ""),
 		ArgsAndParms("detector"		, ArgsAndParms::EType::kCommand	, "Train or check neural networks."),
@@ -109,7 +110,9 @@ const Darknet::SArgsAndParms & Darknet::get_all_possible_arguments()
 		ArgsAndParms("normalize"	, ArgsAndParms::EType::kCommand	, ""),
 		ArgsAndParms("oneoff"		, ArgsAndParms::EType::kCommand	, ""),
 		ArgsAndParms("ops"			, ArgsAndParms::EType::kCommand	, ""),
+		ArgsAndParms("pack"			, ArgsAndParms::EType::kFunction, "Pack the training and validation images into dataset shards which load faster."),
 		ArgsAndParms("partial"		, ArgsAndParms::EType::kCommand	, ""),
+		ArgsAndParms("quantize"		, ArgsAndParms::EType::kFunction, "Calibrate a neural network and write INT8 weights for faster CPU inference."),
 		ArgsAndParms("recall"		, ArgsAndParms::EType::kFunction, ""),
 		ArgsAndParms("rescale"		, ArgsAndParms::EType::kCommand	, ""),
 		ArgsAndParms("reset"		, ArgsAndParms::EType::kCommand	, ""),
@@ -160,6 +163,8 @@ const Darknet::SArgsAndParms & Darknet::get_all_possible_arguments()
 		ArgsAndParms("numofclusters"		, "", 6		, "The number of YOLO anchors in the configuration. --num_of_clusters 6"	),
 		ArgsAndParms("width"				, "", 416	, "The width of the network.  --width 416"									),
 		ArgsAndParms("height"				, "", 416	, "The height of the network.  --width 416"									),
+		ArgsAndParms("workerthreads"		, "", 0		, "Number of threads used to calculate the YOLO loss while training.  Default is the number of CPU cores.  --worker_threads 8"),
+		ArgsAndParms("prefetchbatches"		, "", 2		, "Number of batches of images to load ahead of time while training.  --prefetch_batches 2"),
 		ArgsAndParms("skipclasses"			, "", " "	, "Class indexes which Darknet should skip when returning results or annotating images.  --skip-classes=2,5-8"),
 		ArgsAndParms("extoutput"			),
 		ArgsAndParms("savelabels"			),
@@ -1262,6 +1262,11 @@ Darknet::CfgFile & Darknet::CfgFile::parse_net_section()
 		net.mixup = 3;
 	}
 	net.letter_box = s.find_int("letter_box", 0);
+	net.details->channels_last_requested = (s.find_int("channels_last", 0) != 0);
+	net.details->weights_storage = Darknet::get_weights_storage_from_name(s.find_str("weights_storage", "fp32"));
+	net.details->concurrent_layers = s.find_int("concurrent_layers", 1);
+	net.details->lazy_class_activation = (s.find_int("lazy_class_activation", 0) != 0);
+	net.details->share_layer_outputs = (s.find_int("share_layer_outputs", 0) != 0);
 	net.mosaic_bound = s.find_int("mosaic_bound", 0);
 	net.contrastive = s.find_int("contrastive", 0);
 	net.contrastive_jit_flip = s.find_int("contrastive_jit_flip", 0);
@@ -1789,7 +1794,7 @@ Darknet::Layer Darknet::CfgFile::parse_connected_section(const size_t section_id
 	ACTIVATION activation = static_cast<ACTIVATION>(get_activation_from_name(s.find_str("activation", "logistic")));
 	int batch_normalize = s.find_int("batch_normalize", 0);
 
-	Darknet::Layer l = make_connected_layer(parms.batch, 1, parms.inputs, output, activation, batch_normalize);
+	Darknet::Layer l = make_connected_layer(parms.batch, 1, parms.inputs, output, activation, batch_normalize, parms.train);
 
 	return l;
 }
@@ -1840,7 +1845,7 @@ Darknet::Layer Darknet::CfgFile::parse_rnn_section(const size_t section_idx)
 
 	ACTIVATION activation = static_cast<ACTIVATION>(get_activation_from_name(s.find_str("activation", "logistic")));
 
-	Darknet::Layer l = make_rnn_layer(parms.batch, parms.inputs, hidden, output, parms.time_steps, activation, batch_normalize, logistic);
+	Darknet::Layer l = make_rnn_layer(parms.batch, parms.inputs, hidden, output, parms.time_steps, activation, batch_normalize, logistic, parms.train);
 
 	l.shortcut = s.find_int("shortcut", 0);
 
@@ -1888,7 +1893,7 @@ Darknet::Layer Darknet::CfgFile::parse_lstm_section(const size_t section_idx)
 	int output			= s.find_int("output"			, 1);
 	int batch_normalize	= s.find_int("batch_normalize"	, 0);
 
-	Darknet::Layer l = make_lstm_layer(parms.batch, parms.inputs, output, parms.time_steps, batch_normalize);
+	Darknet::Layer l = make_lstm_layer(parms.batch, parms.inputs, output, parms.time_steps, batch_normalize, parms.train);
 
 	return l;
 }
@@ -0,0 +1,351 @@
+#include "darknet_internal.hpp"
+
+
+namespace
+{
+	static auto & cfg_and_state = Darknet::CfgAndState::get();
+
+
+	/// Marks a dataset shard written by @ref Darknet::DatasetShard::write().
+	static const char dataset_shard_signature[16] = "DARKNET-SHARD-1";
+
+
+	/// The fixed-size header at the start of a dataset shard.
+	struct Shard_Header
+	{
+		char		signature[16];
+		uint64_t	images;			///< number of entries in the index
+		uint64_t	index_offset;	///< position of the index, an array of @ref Shard_Index_Entry
+		uint64_t	names_offset;	///< position of the image and annotation filenames, which are not terminated
+		uint64_t	names_size;		///< number of bytes used by the filenames
+	};
+
+
+	/// One entry in the index of a dataset shard.  The names are relative to @ref Shard_Header::names_offset.
+	struct Shard_Index_Entry
+	{
+		uint64_t	image_offset;
+		uint64_t	image_size;
+		uint64_t	boxes_offset;
+		uint64_t	number_of_boxes;
+		uint64_t	image_name_offset;
+		uint64_t	image_name_size;
+		uint64_t	annotation_name_offset;
+		uint64_t	annotation_name_size;
+	};
+
+	static_assert(sizeof(Darknet::DatasetShard::Box) == 20, "the shard file format expects 20-byte bounding boxes");
+
+
+	/// @{ The shards opened by @ref Darknet::use_dataset_shards().
+	static std::shared_mutex shards_mutex;
+	static std::vector<std::unique_ptr<Darknet::DatasetShard>> open_shards;
+	static std::set<std::filesystem::path> open_shard_filenames;
+	static std::atomic<bool> any_open_shards = false;
+	/// @}
+
+
+	/// Pad the output so the next record starts on an 8-byte boundary.
+	static inline void pad_shard(std::ofstream & ofs)
+	{
+		TAT(TATPARMS);
+
+		static const char zeros[8] = {0};
+		const auto position = static_cast<uint64_t>(ofs.tellp());
+		if (position % 8)
+		{
+			ofs.write(zeros, 8 - position % 8);
+		}
+
+		return;
+	}
+}
+
+
+Darknet::DatasetShard::DatasetShard(const std::filesystem::path & fn) :
+	filename(fn)
+{
+	TAT(TATPARMS);
+
+	uint64_t size = 0;
+	mapping = Darknet::map_file(filename.string().c_str(), size);
+	const uint8_t * base = static_cast<const uint8_t *>(mapping.get());
+
+	if (size < sizeof(Shard_Header))
+	{
+		darknet_fatal_error(DARKNET_LOC, "%s is too small to be a Darknet dataset shard", filename.string().c_str());
+	}
+
+	const Shard_Header & header = *reinterpret_cast<const Shard_Header *>(base);
+	if (std::memcmp(header.signature, dataset_shard_signature, sizeof(dataset_shard_signature)) != 0)
+	{
+		darknet_fatal_error(DARKNET_LOC, "%s is not a Darknet dataset shard", filename.string().c_str());
+	}
+
+	if (header.index_offset > size or
+		header.images > (size - header.index_offset) / sizeof(Shard_Index_Entry) or
+		header.names_offset > size or
+		header.names_size > size - header.names_offset)
+	{
+		darknet_fatal_error(DARKNET_LOC, "the dataset shard %s is truncated or corrupt", filename.string().c_str());
+	}
+
+	const Shard_Index_Entry * index = reinterpret_cast<const Shard_Index_Entry *>(base + header.index_offset);
+	const char * names = reinterpret_cast<const char *>(base + header.names_offset);
+
+	entries.reserve(header.images);
+	images.reserve(header.images);
+	annotations.reserve(header.images);
+
+	for (size_t idx = 0; idx < header.images; idx ++)
+	{
+		const Shard_Index_Entry & e = index[idx];
+		if (e.image_offset > size												or
+			e.image_size > size - e.image_offset								or
+			e.boxes_offset > size												or
+			e.number_of_boxes > (size - e.boxes_offset) / sizeof(Box)			or
+			e.image_name_offset > header.names_size								or
+			e.image_name_size > header.names_size - e.image_name_offset			or
+			e.annotation_name_offset > header.names_size						or
+			e.annotation_name_size > header.names_size - e.annotation_name_offset)
+		{
+			darknet_fatal_error(DARKNET_LOC, "the dataset shard %s is corrupt (image #%lu)", filename.string().c_str(), idx);
+		}
+
+		Entry entry;
+		entry.image				= base + e.image_offset;
+		entry.image_size		= e.image_size;
+		entry.boxes				= reinterpret_cast<const Box *>(base + e.boxes_offset);
+		entry.number_of_boxes	= e.number_of_boxes;
+		entries.push_back(entry);
+
+		images		[std::string(names + e.image_name_offset		, e.image_name_size			)] = idx;
+		annotations	[std::string(names + e.annotation_name_offset	, e.annotation_name_size	)] = idx;
+	}
+
+	return;
+}
+
+
+const Darknet::DatasetShard::Entry * Darknet::DatasetShard::find_image(const std::string & image_filename) const
+{
+	TAT(TATPARMS);
+
+	auto iter = images.find(image_filename);
+	if (iter == images.end())
+	{
+		return nullptr;
+	}
+
+	return &entries[iter->second];
+}
+
+
+const Darknet::DatasetShard::Entry * Darknet::DatasetShard::find_annotations(const std::string & annotation_filename) const
+{
+	TAT(TATPARMS);
+
+	auto iter = annotations.find(annotation_filename);
+	if (iter == annotations.end())
+	{
+		return nullptr;
+	}
+
+	return &entries[iter->second];
+}
+
+
+void Darknet::DatasetShard::write(const std::filesystem::path & filename, const VStr & image_filenames)
+{
+	TAT(TATPARMS);
+
+	std::ofstream ofs(filename, std::ios::binary | std::ios::trunc);
+	if (not ofs.good())
+	{
+		darknet_fatal_error(DARKNET_LOC, "failed to create the dataset shard %s", filename.string().c_str());
+	}
+
+	// the header is written again once the positions of the index and the names are known
+	Shard_Header header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.signature, dataset_shard_signature, sizeof(dataset_shard_signature));
+	ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+	std::vector<Shard_Index_Entry> index;
+	index.reserve(image_filenames.size());
+	std::string names;
+	std::vector<char> buffer;
+
+	for (const auto & image_filename : image_filenames)
+	{
+		std::ifstream ifs(image_filename, std::ios::binary | std::ios::ate);
+		if (not ifs.good())
+		{
+			darknet_fatal_error(DARKNET_LOC, "failed to open image file \"%s\"", image_filename.c_str());
+		}
+		buffer.resize(ifs.tellg());
+		ifs.seekg(0);
+		ifs.read(buffer.data(), buffer.size());
+		if (buffer.empty() or not ifs.good())
+		{
+			darknet_fatal_error(DARKNET_LOC, "failed to read image file \"%s\"", image_filename.c_str());
+		}
+
+		char annotation_filename[4096];
+		replace_image_to_label(image_filename.c_str(), annotation_filename);
+
+		int count = 0;
+		box_label * labels = read_boxes(annotation_filename, &count);
+		std::vector<Box> boxes(count);
+		for (int i = 0; i < count; i ++)
+		{
+			boxes[i].id	= labels[i].id;
+			boxes[i].x	= labels[i].x;
+			boxes[i].y	= labels[i].y;
+			boxes[i].w	= labels[i].w;
+			boxes[i].h	= labels[i].h;
+		}
+		free(labels);
+
+		Shard_Index_Entry entry;
+		entry.image_offset				= ofs.tellp();
+		entry.image_size				= buffer.size();
+		ofs.write(buffer.data(), buffer.size());
+		pad_shard(ofs);
+
+		entry.boxes_offset				= ofs.tellp();
+		entry.number_of_boxes			= boxes.size();
+		ofs.write(reinterpret_cast<const char *>(boxes.data()), boxes.size() * sizeof(Box));
+		pad_shard(ofs);
+
+		entry.image_name_offset			= names.size();
+		entry.image_name_size			= image_filename.size();
+		names += image_filename;
+		entry.annotation_name_offset	= names.size();
+		entry.annotation_name_size		= std::strlen(annotation_filename);
+		names += annotation_filename;
+
+		index.push_back(entry);
+
+		if (index.size() % 1000 == 0)
+		{
+			std::cout << "\rpacked " << index.size() << " of " << image_filenames.size() << " images" << std::flush;
+		}
+	}
+
+	header.images		= index.size();
+	header.names_offset	= ofs.tellp();
+	header.names_size	= names.size();
+	ofs.write(names.data(), names.size());
+	pad_shard(ofs);
+
+	header.index_offset	= ofs.tellp();
+	ofs.write(reinterpret_cast<const char *>(index.data()), index.size() * sizeof(Shard_Index_Entry));
+
+	ofs.seekp(0);
+	ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	ofs.close();
+
+	if (ofs.fail())
+	{
+		darknet_fatal_error(DARKNET_LOC, "failed to write the dataset shard %s", filename.string().c_str());
+	}
+
+	std::cout << "\rpacked " << index.size() << " images into " << filename.string() << std::endl;
+
+	return;
+}
+
+
+void Darknet::use_dataset_shards(const std::string & shards)
+{
+	TAT(TATPARMS);
+
+	std::stringstream ss(shards);
+	std::string name;
+	while (std::getline(ss, name, ','))
+	{
+		name = Darknet::trim(name);
+		if (name.empty())
+		{
+			continue;
+		}
+
+		const std::filesystem::path filename = std::filesystem::weakly_canonical(name);
+
+		if (true)
+		{
+			std::shared_lock lock(shards_mutex);
+			if (open_shard_filenames.count(filename))
+			{
+				continue;
+			}
+		}
+
+		auto shard = std::make_unique<Darknet::DatasetShard>(filename);
+
+		if (cfg_and_state.is_verbose)
+		{
+			std::cout << "Using " << shard->size() << " images from the dataset shard " << filename.string() << std::endl;
+		}
+
+		std::unique_lock lock(shards_mutex);
+		if (open_shard_filenames.insert(filename).second)
+		{
+			open_shards.push_back(std::move(shard));
+			any_open_shards = true;
+		}
+	}
+
+	return;
+}
+
+
+const Darknet::DatasetShard::Entry * Darknet::find_image_in_dataset_shards(const char * image_filename)
+{
+	TAT(TATPARMS);
+
+	if (not any_open_shards or image_filename == nullptr)
+	{
+		return nullptr;
+	}
+
+	const std::string name(image_filename);
+
+	std::shared_lock lock(shards_mutex);
+	for (const auto & shard : open_shards)
+	{
+		const auto entry = shard->find_image(name);
+		if (entry)
+		{
+			return entry;
+		}
+	}
+
+	return nullptr;
+}
+
+
+const Darknet::DatasetShard::Entry * Darknet::find_annotations_in_dataset_shards(const char * annotation_filename)
+{
+	TAT(TATPARMS);
+
+	if (not any_open_shards or annotation_filename == nullptr)
+	{
+		return nullptr;
+	}
+
+	const std::string name(annotation_filename);
+
+	std::shared_lock lock(shards_mutex);
+	for (const auto & shard : open_shards)
+	{
+		const auto entry = shard->find_annotations(name);
+		if (entry)
+		{
+			return entry;
+		}
+	}
+
+	return nullptr;
+}
@@ -0,0 +1,99 @@
+/* Darknet/YOLO:  https://github.com/hank-ai/darknet
+ * Copyright 2026 Stephane Charette
+ */
+
+#pragma once
+
+#ifndef __cplusplus
+#error "The Darknet/YOLO project requires a C++ compiler."
+#endif
+
+/** @file
+ * Packed dataset shards, which store the images and annotations of a training or validation list in one large file.
+ */
+
+#include "darknet.hpp"
+
+
+namespace Darknet
+{
+	/** A packed dataset shard written by @ref Darknet::DatasetShard::write().  The file contains the encoded image
+	 * files exactly as they were on disk (so augmentation still works with the original image), the bounding boxes
+	 * from the matching .txt annotation files as binary arrays, and an index.  The whole file is memory-mapped, so
+	 * training reads one large file instead of opening two small files for every image it loads.
+	 *
+	 * Shards are used by listing them in the @p shards=... line of the .data file.  The images and annotations are
+	 * then found by their original filenames, see @ref use_dataset_shards().
+	 *
+	 * @since 2026-10-17
+	 */
+	class DatasetShard final
+	{
+		public:
+
+			/// One bounding box, as read from a .txt annotation file.
+			struct Box
+			{
+				int32_t id;
+				float x;
+				float y;
+				float w;
+				float h;
+			};
+
+			/// The image and annotations for one of the images in the shard.
+			struct Entry
+			{
+				const uint8_t * image;	///< the encoded image file, such as JPG or PNG
+				size_t image_size;		///< number of bytes in @ref image
+				const Box * boxes;		///< the bounding boxes from the annotation file
+				size_t number_of_boxes;	///< number of entries in @ref boxes
+			};
+
+			/// Memory-map an existing shard and read the index.
+			DatasetShard(const std::filesystem::path & filename);
+
+			/// Find the image with the given filename.  Returns @p nullptr if the image is not in this shard.
+			const Entry * find_image(const std::string & image_filename) const;
+
+			/// Find the image whose annotations are in the given .txt file.  Returns @p nullptr if it is not in this shard.
+			const Entry * find_annotations(const std::string & annotation_filename) const;
+
+			/// The number of images in the shard.
+			size_t size() const { return entries.size(); }
+
+			/** Create a new shard from the images in @p image_filenames and their matching .txt annotation files.  The
+			 * annotations are found the same way as when training, see @ref replace_image_to_label().
+			 */
+			static void write(const std::filesystem::path & filename, const VStr & image_filenames);
+
+		private:
+
+			std::filesystem::path filename;
+
+			/// Keeps the file mapped for as long as the shard exists.
+			std::shared_ptr<void> mapping;
+
+			std::vector<Entry> entries;
+
+			/// @{ Index into @ref entries.
+			std::unordered_map<std::string, size_t> images;
+			std::unordered_map<std::string, size_t> annotations;
+			/// @}
+	};
+
+
+	/** Open the shards listed in the @p shards=... line of the .data file, separated by commas.  Once a shard is open,
+	 * @ref load_rgb_mat_image() and @ref read_boxes() read from it instead of the individual files.  Shards which are
+	 * already open are skipped, so this can be called every time the .data file is read.
+	 *
+	 * @since 2026-10-17
+	 */
+	void use_dataset_shards(const std::string & shards);
+
+
+	/// @{ Find an image or its annotations in the open shards.  Returns @p nullptr if not found.  @since 2026-10-17
+	const DatasetShard::Entry * find_image_in_dataset_shards(const char * image_filename);
+	const DatasetShard::Entry * find_annotations_in_dataset_shards(const char * annotation_filename);
+	/// @}
+}
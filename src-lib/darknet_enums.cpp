@@ -488,3 +488,50 @@ std::string Darknet::to_string(const EYoloPoint type)
 
 	darknet_fatal_error(DARKNET_LOC, "unknown YOLO point type #%d", static_cast<int>(type));
 }
+
+
+const Darknet::NamesAndWeightsStorage & Darknet::all_names_and_weights_storage()
+{
+	TAT(TATPARMS);
+
+	const static NamesAndWeightsStorage m =
+	{
+		{"fp32"	, EWeightsStorage::FP32	},
+		{"fp16"	, EWeightsStorage::FP16	},
+		{"bf16"	, EWeightsStorage::BF16	},
+	};
+
+	return m;
+}
+
+
+Darknet::EWeightsStorage Darknet::get_weights_storage_from_name(const std::string & name)
+{
+	TAT(TATPARMS);
+
+	const auto & m = all_names_and_weights_storage();
+
+	if (m.count(name) == 0)
+	{
+		darknet_fatal_error(DARKNET_LOC, "weights storage \"%s\" is not supported", name.c_str());
+	}
+
+	return m.at(name);
+}
+
+
+std::string Darknet::to_string(const EWeightsStorage storage)
+{
+	TAT(TATPARMS);
+
+	const auto & m = all_names_and_weights_storage();
+	for (const auto & [k, v] : m)
+	{
+		if (storage == v)
+		{
+			return k;
+		}
+	}
+
+	darknet_fatal_error(DARKNET_LOC, "unknown weights storage #%d", static_cast<int>(storage));
+}
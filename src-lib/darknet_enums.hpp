@@ -243,4 +243,23 @@ namespace Darknet
 	EYoloPoint get_yolo_point_types_from_name(const std::string & name);
 	std::string to_string(const EYoloPoint type);
 	/// @}
+
+	/** How the weights of convolutional layers are stored for CPU inference.  Set with @p weights_storage in the
+	 * @p [net] section of the .cfg file.
+	 * @see @ref prepare_weights_storage()
+	 * @since 2026-10-17
+	 */
+	enum class EWeightsStorage
+	{
+		FP32,	///< default, the weights are used as they were loaded
+		FP16,	///< IEEE half precision, converted with F16C when the CPU supports it
+		BF16,	///< bfloat16, the upper half of a float
+	};
+
+	/// @{ Convert between names and weights storage.  @since 2026-10-17
+	using NamesAndWeightsStorage = std::map<std::string, EWeightsStorage>;
+	const NamesAndWeightsStorage & all_names_and_weights_storage();
+	EWeightsStorage get_weights_storage_from_name(const std::string & name);
+	std::string to_string(const EWeightsStorage storage);
+	/// @}
 };
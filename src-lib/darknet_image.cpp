@@ -1,5 +1,9 @@
 #include "darknet_internal.hpp"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 
 namespace
 {
@@ -835,6 +839,66 @@ Darknet::Image Darknet::mat_to_image(const cv::Mat & mat)
 }
 
 
+void Darknet::bgr_mat_to_rgb_planar(const cv::Mat & mat, float * output, const int w, const int h)
+{
+	TAT(TATPARMS);
+
+	const int channels = mat.channels();
+	if (mat.empty() or mat.depth() != CV_8U or (channels != 1 and channels != 3 and channels != 4))
+	{
+		throw std::invalid_argument("expected a non-empty 8-bit image with 1, 3, or 4 channels");
+	}
+	if (output == nullptr or w < 1 or h < 1)
+	{
+		throw std::invalid_argument("invalid output buffer or dimensions");
+	}
+
+	const int planes = (channels == 1 ? 1 : 3);
+	const size_t plane_size = static_cast<size_t>(w) * h;
+	const float scale = 1.0f / 255.0f;
+
+	// nearest neighbour, same source pixels as cv::resize() with cv::INTER_NEAREST
+	std::vector<int> x_offset(w);
+	for (int x = 0; x < w; ++x)
+	{
+		x_offset[x] = std::min(static_cast<int>(x * static_cast<double>(mat.cols) / w), mat.cols - 1) * channels;
+	}
+
+	#pragma omp parallel for
+	for (int y = 0; y < h; ++y)
+	{
+		const int src_y = std::min(static_cast<int>(y * static_cast<double>(mat.rows) / h), mat.rows - 1);
+		const uint8_t * src = mat.ptr<uint8_t>(src_y);
+
+		for (int p = 0; p < planes; ++p)
+		{
+			// plane #0 is red, which OpenCV stores as the 3rd byte of each BGR or BGRA pixel
+			const int k = (planes == 1 ? 0 : 2 - p);
+			float * dst = output + p * plane_size + static_cast<size_t>(y) * w;
+			const int * xo = x_offset.data();
+
+			int x = 0;
+#if defined(__AVX2__)
+			const __m256 scale8 = _mm256_set1_ps(scale);
+			for (; x + 8 <= w; x += 8)
+			{
+				const __m256i bytes = _mm256_setr_epi32(
+					src[xo[x + 0] + k], src[xo[x + 1] + k], src[xo[x + 2] + k], src[xo[x + 3] + k],
+					src[xo[x + 4] + k], src[xo[x + 5] + k], src[xo[x + 6] + k], src[xo[x + 7] + k]);
+				_mm256_storeu_ps(dst + x, _mm256_mul_ps(_mm256_cvtepi32_ps(bytes), scale8));
+			}
+#endif
+			for (; x < w; ++x)
+			{
+				dst[x] = src[xo[x] + k] * scale;
+			}
+		}
+	}
+
+	return;
+}
+
+
 Darknet::Image Darknet::bgr_mat_to_rgb_image(const cv::Mat & mat)
 {
 	TAT(TATPARMS);
@@ -58,6 +58,16 @@ namespace Darknet
 	 */
 	Darknet::Image bgr_mat_to_rgb_image(const cv::Mat & mat);
 
+	/** Fused pre-processing used by @ref Darknet::predict().  In a single pass over the image, this resizes an 8-bit
+	 * OpenCV image (nearest neighbour), swaps @p BGR or @p BGRA to @p RGB, converts to planar floats, and normalizes the
+	 * values between @p 0.0 and @p 1.0.  Single-channel images remain single-channel.  Nothing is allocated:  the
+	 * results are written to @p output which must have room for @p w x @p h x @p 3 floats (or @p w x @p h for
+	 * greyscale images).
+	 *
+	 * @since 2026-10-17
+	 */
+	void bgr_mat_to_rgb_planar(const cv::Mat & mat, float * output, const int w, const int h);
+
 	/** Convert the usual @ref Darknet::Image format to OpenCV @p cv::Mat.  The mat object will be in @p RGB format,
 	 * not @p BGR.
 	 *
@@ -0,0 +1,153 @@
+#include "darknet_internal.hpp"
+
+
+namespace
+{
+	static auto & cfg_and_state = Darknet::CfgAndState::get();
+}
+
+
+Darknet::ImageCache & Darknet::ImageCache::get()
+{
+	TAT(TATPARMS);
+
+	static ImageCache cache;
+
+	return cache;
+}
+
+
+Darknet::ImageCache::ImageCache() :
+	max_bytes(0),
+	max_dimension(0),
+	bytes(0),
+	hits(0),
+	misses(0)
+{
+	TAT(TATPARMS);
+
+	return;
+}
+
+
+void Darknet::ImageCache::configure(const size_t budget, const int dimension)
+{
+	TAT(TATPARMS);
+
+	std::lock_guard lock(mutex);
+
+	max_bytes		= budget;
+	max_dimension	= dimension;
+	bytes			= 0;
+	hits			= 0;
+	misses			= 0;
+	lru.clear();
+	images.clear();
+
+	if (cfg_and_state.is_verbose and max_bytes > 0)
+	{
+		std::cout << "Caching up to " << (max_bytes / 1024 / 1024) << " MiB of decoded images";
+		if (max_dimension > 0)
+		{
+			std::cout << ", shrunk to at most " << max_dimension << " pixels";
+		}
+		std::cout << std::endl;
+	}
+
+	return;
+}
+
+
+cv::Mat Darknet::ImageCache::load(const char * filename, const int channels)
+{
+	TAT(TATPARMS);
+
+	if (max_bytes == 0)
+	{
+		return load_rgb_mat_image(filename, channels);
+	}
+
+	const std::string name(filename);
+
+	std::unique_lock lock(mutex);
+
+	auto iter = images.find(name);
+	if (iter != images.end())
+	{
+		hits ++;
+		lru.splice(lru.begin(), lru, iter->second);
+		return iter->second->mat;
+	}
+
+	misses ++;
+	const int dimension = max_dimension;
+
+	// decoding is slow, so other threads can use the cache in the meantime
+	lock.unlock();
+
+	cv::Mat mat = load_rgb_mat_image(filename, channels);
+	if (dimension > 0 and std::max(mat.cols, mat.rows) > dimension)
+	{
+		const double scale = static_cast<double>(dimension) / std::max(mat.cols, mat.rows);
+		const cv::Size size(
+			std::max(1, static_cast<int>(std::round(mat.cols * scale))),
+			std::max(1, static_cast<int>(std::round(mat.rows * scale))));
+
+		cv::Mat smaller;
+		cv::resize(mat, smaller, size, 0, 0, cv::INTER_AREA);
+		mat = smaller;
+	}
+
+	const size_t mat_bytes = mat.total() * mat.elemSize() + name.size() + sizeof(Cached_Image);
+
+	lock.lock();
+
+	// another thread may have loaded the same image, or the image is larger than the entire cache
+	if (images.count(name) == 0 and mat_bytes <= max_bytes)
+	{
+		lru.push_front({name, mat, mat_bytes});
+		images[name] = lru.begin();
+		bytes += mat_bytes;
+		evict();
+	}
+
+	return mat;
+}
+
+
+void Darknet::ImageCache::evict()
+{
+	TAT(TATPARMS);
+
+	while (bytes > max_bytes and not lru.empty())
+	{
+		const Cached_Image & oldest = lru.back();
+		bytes -= oldest.bytes;
+		images.erase(oldest.filename);
+		lru.pop_back();
+	}
+
+	return;
+}
+
+
+Darknet::ImageCache::Stats Darknet::ImageCache::stats(const bool reset)
+{
+	TAT(TATPARMS);
+
+	std::lock_guard lock(mutex);
+
+	Stats s;
+	s.hits		= hits;
+	s.misses	= misses;
+	s.images	= lru.size();
+	s.bytes		= bytes;
+
+	if (reset)
+	{
+		hits	= 0;
+		misses	= 0;
+	}
+
+	return s;
+}
@@ -0,0 +1,95 @@
+/* Darknet/YOLO:  https://github.com/hank-ai/darknet
+ * Copyright 2026 Stephane Charette
+ */
+
+#pragma once
+
+#ifndef __cplusplus
+#error "The Darknet/YOLO project requires a C++ compiler."
+#endif
+
+/** @file
+ * Cache of decoded training images.
+ */
+
+#include "darknet.hpp"
+
+
+namespace Darknet
+{
+	/** Keeps recently decoded training images in memory so they do not need to be read and decoded again at every
+	 * epoch.  When the cache is full, the images which have not been used for the longest time are removed.
+	 *
+	 * The cache is disabled until @ref configure() is called with a memory budget.  During training this comes from the
+	 * @p image_cache=... line of the .data file (in MiB), and the optional @p image_cache_scale=... line which shrinks
+	 * the cached images to at most that many times the network dimensions.
+	 *
+	 * The cached images are shared with the caller, which must not modify them.  The images are not copied, so the
+	 * cache and the data loading threads use the same memory.
+	 *
+	 * @since 2026-10-17
+	 */
+	class ImageCache final
+	{
+		public:
+
+			/// Counters returned by @ref stats().
+			struct Stats
+			{
+				size_t hits;
+				size_t misses;
+				size_t images;	///< number of images in the cache
+				size_t bytes;	///< memory used by the images in the cache
+			};
+
+			/// Get a reference to the cache shared by all the data loading threads.
+			static ImageCache & get();
+
+			ImageCache(const ImageCache &) = delete;
+			ImageCache & operator=(const ImageCache &) = delete;
+
+			/** Set the memory budget in bytes, or @p 0 to disable the cache.  When @p max_dimension is larger than zero,
+			 * images which are wider or taller than this are shrunk before they are cached.  This empties the cache.
+			 */
+			void configure(const size_t max_bytes, const int max_dimension);
+
+			/// Returns @p true if @ref configure() has been called with a memory budget.
+			bool enabled() const { return max_bytes > 0; }
+
+			/** Get the image from the cache, or load it with @ref load_rgb_mat_image() and add it to the cache.  The
+			 * returned image must not be modified.
+			 */
+			cv::Mat load(const char * filename, const int channels);
+
+			/// Get the counters.  When @p reset is @p true, the hit and miss counters are set back to zero.
+			Stats stats(const bool reset);
+
+		private:
+
+			ImageCache();
+
+			/// Remove the least recently used images until the cache fits within @ref max_bytes.  Call with @ref mutex locked.
+			void evict();
+
+			struct Cached_Image
+			{
+				std::string filename;
+				cv::Mat mat;
+				size_t bytes;
+			};
+
+			/// Memory budget in bytes, or @p 0 when the cache is disabled.
+			std::atomic<size_t> max_bytes;
+
+			std::mutex mutex;
+
+			/// @{ Protected by @ref mutex.  The most recently used image is at the front of @ref lru.
+			int max_dimension;
+			size_t bytes;
+			size_t hits;
+			size_t misses;
+			std::list<Cached_Image> lru;
+			std::unordered_map<std::string, std::list<Cached_Image>::iterator> images;
+			/// @}
+	};
+}
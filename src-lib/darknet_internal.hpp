@@ -32,6 +32,8 @@
 #include <optional>
 #include <random>
 #include <regex>
+#include <shared_mutex>
+#include <unordered_map>
 
 // 3rd-party lib headers
 #include <opencv2/opencv.hpp>
@@ -73,7 +75,11 @@ namespace Darknet
 		int i;				///< The entry index into the W x H output array for the given YOLO layer.
 		int obj_index;		///< The index into the YOLO output array -- as obtained from @ref yolo_entry_index() -- which is used to get the objectness value.  E.g., a value of @p "l.output[obj_index] == 0.999f" would indicate that there is an object at this location.
 	};
-	using Output_Object_Cache = std::list<Output_Object>;
+	/** Contiguous so the candidates found while scanning the YOLO output do not each need a separate allocation.  The
+	 * network keeps one of these in @ref Darknet::NetworkDetails::output_object_cache which is cleared (but not freed)
+	 * between images.
+	 */
+	using Output_Object_Cache = std::vector<Output_Object>;
 
 	class CfgLine;
 	class CfgSection;
@@ -307,6 +313,14 @@ typedef struct box_label {
 void free_layer_custom(Darknet::Layer & l, int keep_cudnn_desc);
 void free_layer(Darknet::Layer & l);
 
+/** Replace the parameters (weights, biases, scales, rolling mean and variance) of @p dst with pointers to those owned by
+ * @p src.  Sublayers are handled recursively.  @see @ref Darknet::clone_neural_network()  @since 2026-10-17
+ */
+void share_layer_weights(Darknet::Layer & dst, const Darknet::Layer & src);
+
+/// Forget the parameters set by @ref share_layer_weights() so they are not freed twice.  @since 2026-10-17
+void release_shared_layer_weights(Darknet::Layer & l);
+
 // dark_cuda.h
 void cuda_pull_array(float *x_gpu, float *x, size_t n);
 void cuda_pull_array_async(float *x_gpu, float *x, size_t n);
@@ -339,6 +353,10 @@ int get_yolo_detections_v3(Darknet::Network * net, int w, int h, int netw, int n
 #include "darknet_utils.hpp"
 #include "darknet_image.hpp"
 #include "darknet_network.hpp"
+#include "darknet_scheduler.hpp"
+#include "darknet_worker_pool.hpp"
+#include "darknet_dataset_shard.hpp"
+#include "darknet_image_cache.hpp"
 #include "image_opencv.hpp"
 #include "Timing.hpp"
 #include "darknet_cfg.hpp"
@@ -234,6 +234,7 @@ namespace Darknet
 		float scale_x_y;
 		int objectness_smooth;
 		int new_coords;
+		int yolo_classes_pending; ///< the class values in @p output have not been through the logistic activation, see @ref activate_yolo_classes()
 		int show_details;
 		float max_delta;
 		float uc_normalizer;
@@ -260,6 +261,19 @@ namespace Darknet
 		int new_lda;
 		int bit_align;
 
+		float *winograd_weights; ///< 3x3 weights pre-transformed for Winograd, see @ref prepare_winograd_convolution()
+		float *weights_nhwc; ///< weights as a (size x size x c) by n matrix for channels-last inference, see @ref prepare_channels_last()
+		int8_t *weights_int8; ///< per-channel 8-bit weights with rows padded to a multiple of 32, see @ref quantize_convolutional_layer()
+		float *weights_int8_scales; ///< one scale per row of @ref weights_int8
+		int32_t *weights_int8_sums; ///< sum of each row of @ref weights_int8
+		float input_int8_scale; ///< the input is quantized to 7 bits as round(x / input_int8_scale) + input_int8_zero_point
+		int input_int8_zero_point;
+		uint16_t *weights_half; ///< FP16 or BF16 copy of the weights which replaces @p weights, see @ref convert_convolutional_weights_storage()
+		Darknet::EWeightsStorage weights_storage; ///< format of @ref weights_half, or @p FP32 when the layer uses @p weights
+		bool weights_mapped; ///< @p weights, @p biases, and the batch norm parameters point into a memory-mapped file, see @ref save_mapped_weights()
+		float *lstm_gate_weights; ///< the eight gate sublayers of an LSTM layer packed into one matrix for inference, see @ref prepare_lstm_layer_inference()
+		float *lstm_gate_biases; ///< the combined biases of the four gates in @ref lstm_gate_weights
+
 		float *col_image;
 		float * delta;
 		float * output;
@@ -313,6 +327,8 @@ namespace Darknet
 		float *c_cpu;
 		float *stored_c_cpu;
 		float *dc_cpu;
+		float *gates_cpu; ///< output of the four LSTM gates during inference, see @ref lstm_gate_weights
+		float *gates_input_cpu; ///< the input and the previous hidden state, which are multiplied by @ref lstm_gate_weights
 
 		float *binary_input;
 		uint32_t *bin_re_packed_input;
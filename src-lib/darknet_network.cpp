@@ -4,6 +4,102 @@
 namespace
 {
 	static auto & cfg_and_state = Darknet::CfgAndState::get();
+
+	/** Check whether layer @p idx has a channels-last implementation.
+	 * @returns an empty string if it does, otherwise the reason why it does not.
+	 */
+	static inline std::string channels_last_unsupported(const Darknet::Network & net, const int idx)
+	{
+		TAT(TATPARMS);
+
+		const Darknet::Layer & l = net.layers[idx];
+
+		const auto element_wise = [](const ACTIVATION a)
+		{
+			return a != NORM_CHAN and a != NORM_CHAN_SOFTMAX and a != NORM_CHAN_SOFTMAX_MAXVAL;
+		};
+
+		if (idx == net.n - 1 and l.type != Darknet::ELayerType::YOLO)
+		{
+			return "is the network output but is not a YOLO layer";
+		}
+
+		if (l.type == Darknet::ELayerType::YOLO)
+		{
+			// YOLO outputs are planar, so no other layer may read them
+			for (int j = idx + 1; j < net.n; ++j)
+			{
+				const Darknet::Layer & other = net.layers[j];
+				bool reads_output = (j == idx + 1 and other.type != Darknet::ELayerType::ROUTE);
+				if (other.input_layers)
+				{
+					reads_output = reads_output or std::find(other.input_layers, other.input_layers + other.n, idx) != other.input_layers + other.n;
+				}
+				if (reads_output)
+				{
+					return "is read by layer #" + std::to_string(j);
+				}
+			}
+		}
+
+		switch (l.type)
+		{
+			case Darknet::ELayerType::CONVOLUTIONAL:
+			{
+				if (l.groups != 1)				return "uses groups";
+				if (l.batch_normalize)			return "has batch-norm which was not fused";
+				if (l.xnor or l.binary)			return "uses binary weights";
+				if (l.weights_int8)				return "uses INT8 weights";
+				if (l.antialiasing)				return "uses antialiasing";
+				if (l.deform)					return "is deformable";
+				if (l.assisted_excitation)		return "uses assisted excitation";
+				if (not element_wise(l.activation))	return "normalizes across channels";
+				return "";
+			}
+			case Darknet::ELayerType::MAXPOOL:
+			{
+				if (l.maxpool_depth)			return "pools across channels";
+				if (l.antialiasing)				return "uses antialiasing";
+				return "";
+			}
+			case Darknet::ELayerType::ROUTE:
+			{
+				for (int i = 0; i < l.n; ++i)
+				{
+					const Darknet::Layer & input = net.layers[l.input_layers[i]];
+					if (input.out_w != l.out_w or input.out_h != l.out_h) return "combines layers of different sizes";
+				}
+				return "";
+			}
+			case Darknet::ELayerType::UPSAMPLE:
+			{
+				if (l.reverse)					return "downsamples";
+				return "";
+			}
+			case Darknet::ELayerType::SHORTCUT:
+			{
+				if (l.nweights > 0)				return "uses weights";
+				for (int i = 0; i < l.n; ++i)
+				{
+					if (l.input_sizes[i] != l.outputs) return "adds layers of different sizes";
+				}
+				if (not element_wise(l.activation))	return "normalizes across channels";
+				return "";
+			}
+			case Darknet::ELayerType::DROPOUT:
+			{
+				return "";
+			}
+			case Darknet::ELayerType::YOLO:
+			{
+				return "";
+			}
+			default:
+			{
+				return "has no channels-last implementation";
+			}
+		}
+	}
 }
 
 
@@ -25,6 +121,19 @@ Darknet::NetworkDetails::NetworkDetails()
 	annotate_draw_bb						= true;
 	annotate_draw_label						= true;
 
+	shares_weights							= false;
+
+	channels_last_requested					= false;
+	channels_last							= false;
+
+	weights_storage							= Darknet::EWeightsStorage::FP32;
+
+	concurrent_layers						= 1;
+
+	lazy_class_activation					= false;
+
+	share_layer_outputs						= false;
+
 	return;
 }
 
@@ -232,6 +341,20 @@ void forward_network(Darknet::Network & net, Darknet::NetworkState state)
 
 	state.workspace = net.workspace;
 
+	if (net.details and net.details->channels_last and not state.train)
+	{
+		// the layers have been switched to channels-last data, so the input image is converted once here
+		net.details->channels_last_input.resize(static_cast<size_t>(net.inputs) * net.batch);
+		nchw_to_nhwc(state.input, net.details->channels_last_input.data(), net.batch, net.c, net.h, net.w);
+		state.input = net.details->channels_last_input.data();
+	}
+
+	if (net.details and net.details->scheduler and not state.train)
+	{
+		net.details->scheduler->forward(net, state);
+		return;
+	}
+
 	for (int i = 0; i < net.n; ++i)
 	{
 		state.index = i;
@@ -628,6 +751,11 @@ int resize_network(Darknet::Network * net, int w, int h)
 	}
 #endif
 
+	// shared output buffers cannot be resized in place, so each layer gets its own output until the plan is redone
+	const bool memory_was_planned = (net->details and not net->details->output_arenas.empty());
+	const bool was_scheduled = (net->details and net->details->scheduler);
+	release_inference_memory(*net);
+
 	//if(w == net->w && h == net->h) return 0;
 	net->w = w;
 	net->h = h;
@@ -729,10 +857,256 @@ int resize_network(Darknet::Network * net, int w, int h)
 	}
 	printf("Workspace begins at %p\n", net->workspace);
 
+	if (memory_was_planned)
+	{
+		plan_inference_memory(*net);
+	}
+
+	// the dependencies and workspaces both depend on the layer outputs
+	if (was_scheduled)
+	{
+		prepare_layer_scheduler(*net);
+	}
+
 	return 0;
 }
 
 
+void plan_inference_memory(Darknet::Network & net)
+{
+	TAT(TATPARMS);
+
+	if (net.details == nullptr or cfg_and_state.gpu_index >= 0 or net.n < 2)
+	{
+		return;
+	}
+
+	release_inference_memory(net);
+
+	for (int i = 0; i < net.n; ++i)
+	{
+		const Darknet::Layer & l = net.layers[i];
+		switch (l.type)
+		{
+			case Darknet::ELayerType::CONVOLUTIONAL:
+			case Darknet::ELayerType::CONNECTED:
+			case Darknet::ELayerType::MAXPOOL:
+			case Darknet::ELayerType::LOCAL_AVGPOOL:
+			case Darknet::ELayerType::AVGPOOL:
+			case Darknet::ELayerType::SOFTMAX:
+			case Darknet::ELayerType::DROPOUT:
+			case Darknet::ELayerType::ROUTE:
+			case Darknet::ELayerType::SHORTCUT:
+			case Darknet::ELayerType::SCALE_CHANNELS:
+			case Darknet::ELayerType::SAM:
+			case Darknet::ELayerType::REGION:
+			case Darknet::ELayerType::YOLO:
+			case Darknet::ELayerType::GAUSSIAN_YOLO:
+			case Darknet::ELayerType::REORG:
+			case Darknet::ELayerType::UPSAMPLE:
+			{
+				break;
+			}
+			default:
+			{
+				// recurrent layers keep state from one call to the next, and others are only used for training
+				return;
+			}
+		}
+
+		if (l.output == nullptr or l.output_pinned or l.share_layer)
+		{
+			return;
+		}
+	}
+
+	// dropout layers do not have their own output, they point to the output of the previous layer
+	Darknet::VInt owner(net.n);
+	for (int i = 0; i < net.n; ++i)
+	{
+		owner[i] = i;
+		if (net.layers[i].type == Darknet::ELayerType::DROPOUT and i > 0)
+		{
+			owner[i] = owner[i - 1];
+		}
+	}
+
+	// find the last layer which reads each output
+	Darknet::VInt last_use(net.n);
+	for (int i = 0; i < net.n; ++i)
+	{
+		last_use[i] = i;
+	}
+	for (int i = 1; i < net.n; ++i)
+	{
+		const Darknet::Layer & l = net.layers[i];
+
+		last_use[owner[i - 1]] = i;
+
+		if (l.type == Darknet::ELayerType::ROUTE or l.type == Darknet::ELayerType::SHORTCUT)
+		{
+			for (int j = 0; j < l.n; ++j)
+			{
+				const int idx = l.input_layers[j];
+				last_use[owner[idx]] = std::max(last_use[owner[idx]], i);
+			}
+		}
+		if (l.type == Darknet::ELayerType::SHORTCUT or
+			l.type == Darknet::ELayerType::SAM or
+			l.type == Darknet::ELayerType::SCALE_CHANNELS)
+		{
+			last_use[owner[l.index]] = std::max(last_use[owner[l.index]], i);
+		}
+	}
+
+	// outputs which are read after the network has run must keep their own buffer
+	std::vector<bool> persistent(net.n, false);
+	persistent[owner[net.n - 1]] = true;
+	for (int i = 0; i < net.n; ++i)
+	{
+		const auto type = net.layers[i].type;
+		if (type == Darknet::ELayerType::YOLO or
+			type == Darknet::ELayerType::GAUSSIAN_YOLO or
+			type == Darknet::ELayerType::REGION)
+		{
+			persistent[owner[i]] = true;
+		}
+	}
+
+	// greedy assignment in execution order; an arena becomes available again once the last reader of its output has run
+	std::vector<size_t> arena_size;	// in floats
+	Darknet::VInt arena_busy_until;	// index of the last layer reading the current arena contents
+	Darknet::VInt assigned(net.n, -1);
+	for (int i = 0; i < net.n; ++i)
+	{
+		const Darknet::Layer & l = net.layers[i];
+		if (owner[i] != i or persistent[i])
+		{
+			continue;
+		}
+
+		const size_t size = static_cast<size_t>(l.outputs) * l.batch;
+
+		// prefer the smallest free arena which is already large enough, otherwise grow the largest free arena
+		int best = -1;
+		for (int a = 0; a < (int)arena_size.size(); ++a)
+		{
+			if (arena_busy_until[a] >= i)
+			{
+				continue;
+			}
+			if (best == -1)
+			{
+				best = a;
+				continue;
+			}
+			const bool fits		= arena_size[a]		>= size;
+			const bool best_fits	= arena_size[best]	>= size;
+			if ((fits and not best_fits) or
+				(fits and best_fits and arena_size[a] < arena_size[best]) or
+				(not fits and not best_fits and arena_size[a] > arena_size[best]))
+			{
+				best = a;
+			}
+		}
+
+		if (best == -1)
+		{
+			best = arena_size.size();
+			arena_size.push_back(0);
+			arena_busy_until.push_back(-1);
+		}
+
+		arena_size[best] = std::max(arena_size[best], size);
+		arena_busy_until[best] = last_use[i];
+		assigned[i] = best;
+	}
+
+	size_t original_bytes = 0;
+	size_t planned_bytes = 0;
+	for (int i = 0; i < net.n; ++i)
+	{
+		if (assigned[i] >= 0)
+		{
+			original_bytes += sizeof(float) * net.layers[i].outputs * net.layers[i].batch;
+		}
+	}
+
+	for (const auto & size : arena_size)
+	{
+		net.details->output_arenas.push_back((float*)xcalloc(size, sizeof(float)));
+		planned_bytes += size * sizeof(float);
+	}
+
+	for (int i = 0; i < net.n; ++i)
+	{
+		Darknet::Layer & l = net.layers[i];
+		if (assigned[i] >= 0)
+		{
+			free(l.output);
+			l.output = net.details->output_arenas[assigned[i]];
+			net.details->planned_layers.push_back(i);
+		}
+		else if (owner[i] != i)
+		{
+			l.output = net.layers[owner[i]].output;
+		}
+
+		if (l.type == Darknet::ELayerType::SHORTCUT)
+		{
+			// shortcut layers keep a copy of the output pointers they read
+			for (int j = 0; j < l.n; ++j)
+			{
+				l.layers_output[j] = net.layers[l.input_layers[j]].output;
+			}
+		}
+	}
+	net.output = get_network_output(net);
+
+	if (cfg_and_state.is_verbose)
+	{
+		// size_to_IEC_string() uses a static buffer, so only call it once per statement
+		std::cout << "Layer outputs planned into " << arena_size.size() << " shared buffers: " << size_to_IEC_string(original_bytes);
+		std::cout << " -> " << size_to_IEC_string(planned_bytes) << std::endl;
+	}
+
+	return;
+}
+
+
+void release_inference_memory(Darknet::Network & net)
+{
+	TAT(TATPARMS);
+
+	if (net.details == nullptr or net.details->output_arenas.empty())
+	{
+		return;
+	}
+
+	for (const int idx : net.details->planned_layers)
+	{
+		net.layers[idx].output = nullptr;
+	}
+	for (int i = 1; i < net.n; ++i)
+	{
+		Darknet::Layer & l = net.layers[i];
+		if (l.type == Darknet::ELayerType::DROPOUT)
+		{
+			l.output = net.layers[i - 1].output;
+		}
+	}
+
+	for (auto & ptr : net.details->output_arenas)
+	{
+		free(ptr);
+	}
+	net.details->output_arenas.clear();
+	net.details->planned_layers.clear();
+
+	return;
+}
+
+
 int get_network_output_size(Darknet::Network & net)
 {
 	TAT(TATPARMS);
@@ -1168,11 +1542,13 @@ void fill_network_boxes(Darknet::Network * net, int w, int h, float thresh, floa
 	int prev_classes = -1;
 	for (int j = 0; j < net->n; ++j)
 	{
-		const Darknet::Layer & l = net->layers[j];
+		Darknet::Layer & l = net->layers[j];
 		switch (l.type)
 		{
 			case Darknet::ELayerType::YOLO:
 			{
+				activate_yolo_classes(l);
+
 				/// @todo V3 JAZZ:  most of the time is spent in this function
 				dets += get_yolo_detections(l, w, h, net->w, net->h, thresh, map, relative, dets, letter);
 
@@ -1226,9 +1602,11 @@ void fill_network_boxes_batch(Darknet::Network * net, int w, int h, float thresh
 	int prev_classes = -1;
 	for (int j = 0; j < net->n; ++j)
 	{
-		const Darknet::Layer & l = net->layers[j];
+		Darknet::Layer & l = net->layers[j];
 		if (l.type == Darknet::ELayerType::YOLO)
 		{
+			activate_yolo_classes(l);
+
 			int count = get_yolo_detections_batch(l, w, h, net->w, net->h, thresh, map, relative, dets, letter, batch);
 			dets += count;
 			if (prev_classes < 0)
@@ -1271,7 +1649,11 @@ detection * get_network_boxes(DarknetNetworkPtr ptr, int w, int h, float thresh,
 #else
 	// With V3 Jazz, we now create a "cache" list to track objects in the output array.
 
-	Darknet::Output_Object_Cache cache;
+	// the cache is owned by the network so the memory is re-used from one image to the next
+	Darknet::Output_Object_Cache local_cache;
+	Darknet::Output_Object_Cache & cache = (net->details ? net->details->output_object_cache : local_cache);
+	cache.clear();
+
 	Darknet::Detection * dets = make_network_boxes_v3(net, thresh, num, cache);
 	fill_network_boxes_v3(net, w, h, thresh, hier, map, relative, dets, letter, cache);
 #endif
@@ -1586,8 +1968,17 @@ void free_network(Darknet::Network & net)
 {
 	TAT(TATPARMS);
 
+	release_inference_memory(net);
+
+	const bool shares_weights = (net.details and net.details->shares_weights);
+
 	for (int i = 0; i < net.n; ++i)
 	{
+		if (shares_weights)
+		{
+			// weights belong to the network from which this one was cloned
+			release_shared_layer_weights(net.layers[i]);
+		}
 		free_layer(net.layers[i]);
 	}
 	free(net.layers);
@@ -1777,6 +2168,194 @@ void fuse_conv_batchnorm(Darknet::Network & net)
 }
 
 
+void prepare_winograd_weights(Darknet::Network & net)
+{
+	TAT(TATPARMS);
+
+	if (cfg_and_state.gpu_index >= 0 or (net.details and net.details->channels_last))
+	{
+		return;
+	}
+
+	int count = 0;
+	for (int j = 0; j < net.n; ++j)
+	{
+		if (prepare_winograd_convolution(net.layers[j]))
+		{
+			count ++;
+		}
+	}
+
+	if (count > 0)
+	{
+		// the transformed tiles are stored in the workspace
+		recalculate_workspace_size(&net);
+	}
+
+	if (cfg_and_state.is_verbose and count > 0)
+	{
+		std::cout << "Winograd F(2x2,3x3) enabled for " << count << " convolutional layer" << (count == 1 ? "" : "s") << std::endl;
+	}
+
+	return;
+}
+
+
+void prepare_channels_last(Darknet::Network & net)
+{
+	TAT(TATPARMS);
+
+	if (net.details == nullptr or not net.details->channels_last_requested or net.details->channels_last or cfg_and_state.gpu_index >= 0)
+	{
+		return;
+	}
+
+	// every layer needs a channels-last implementation, otherwise the whole network stays planar
+	for (int idx = 0; idx < net.n; ++idx)
+	{
+		const std::string reason = channels_last_unsupported(net, idx);
+		if (not reason.empty())
+		{
+			if (cfg_and_state.is_verbose)
+			{
+				std::cout << "Channels-last layout is not used: layer #" << idx << " (" << Darknet::to_string(net.layers[idx].type) << ") " << reason << std::endl;
+			}
+			return;
+		}
+	}
+
+	for (int idx = 0; idx < net.n; ++idx)
+	{
+		Darknet::Layer & l = net.layers[idx];
+		switch (l.type)
+		{
+			case Darknet::ELayerType::CONVOLUTIONAL:
+			{
+				prepare_convolutional_layer_nhwc(l);
+				l.forward = forward_convolutional_layer_nhwc;
+				break;
+			}
+			case Darknet::ELayerType::MAXPOOL:	l.forward = forward_maxpool_layer_nhwc;		break;
+			case Darknet::ELayerType::ROUTE:	l.forward = forward_route_layer_nhwc;		break;
+			case Darknet::ELayerType::UPSAMPLE:	l.forward = forward_upsample_layer_nhwc;	break;
+			case Darknet::ELayerType::YOLO:		l.forward = forward_yolo_layer_nhwc;		break;
+			default:
+			{
+				// shortcut and dropout are element-wise, so the planar implementation works as-is
+				break;
+			}
+		}
+	}
+
+	net.details->channels_last = true;
+
+	if (cfg_and_state.is_verbose)
+	{
+		std::cout << "Using channels-last layout for CPU inference" << std::endl;
+	}
+
+	return;
+}
+
+
+void prepare_weights_storage(Darknet::Network & net)
+{
+	TAT(TATPARMS);
+
+	if (net.details == nullptr												or
+		net.details->weights_storage == Darknet::EWeightsStorage::FP32	or
+		net.details->channels_last											or
+		cfg_and_state.gpu_index >= 0)
+	{
+		return;
+	}
+
+	// layers which lend their weights to other layers must keep the FP32 weights
+	std::vector<bool> is_shared(net.n, false);
+	for (int idx = 0; idx < net.n; ++idx)
+	{
+		const Darknet::Layer * share_layer = net.layers[idx].share_layer;
+		if (share_layer and share_layer >= net.layers and share_layer < net.layers + net.n)
+		{
+			is_shared[share_layer - net.layers] = true;
+		}
+	}
+
+	int count = 0;
+	size_t bytes_saved = 0;
+	for (int idx = 0; idx < net.n; ++idx)
+	{
+		Darknet::Layer & l = net.layers[idx];
+		if (not is_shared[idx] and convert_convolutional_weights_storage(l, net.details->weights_storage))
+		{
+			count ++;
+			bytes_saved += l.nweights * (sizeof(float) - sizeof(uint16_t));
+		}
+	}
+
+	if (cfg_and_state.is_verbose and count > 0)
+	{
+		std::cout
+			<< "Storing weights as " << Darknet::to_string(net.details->weights_storage)
+			<< " for " << count << " convolutional layer" << (count == 1 ? "" : "s")
+			<< " (" << size_to_IEC_string(bytes_saved) << " saved)" << std::endl;
+	}
+
+	return;
+}
+
+
+void prepare_lstm_inference(Darknet::Network & net)
+{
+	TAT(TATPARMS);
+
+	if (cfg_and_state.gpu_index >= 0)
+	{
+		return;
+	}
+
+	int count = 0;
+	for (int idx = 0; idx < net.n; ++idx)
+	{
+		if (prepare_lstm_layer_inference(net.layers[idx]))
+		{
+			count ++;
+		}
+	}
+
+	if (cfg_and_state.is_verbose and count > 0)
+	{
+		std::cout << "Using fused gates for " << count << " LSTM layer" << (count == 1 ? "" : "s") << std::endl;
+	}
+
+	return;
+}
+
+
+void prepare_network_for_inference(Darknet::Network & net, const bool share_layer_outputs)
+{
+	TAT(TATPARMS);
+
+	// the batchnorm must be fused before the weights are binarized, transformed, converted to channels-last, or stored
+	// with fewer bits, and the scheduler needs to know which outputs share memory
+	fuse_conv_batchnorm(net);
+	calculate_binary_weights(&net);
+	prepare_channels_last(net);
+	prepare_winograd_weights(net);
+	prepare_weights_storage(net);
+	prepare_lstm_inference(net);
+
+	if (share_layer_outputs)
+	{
+		plan_inference_memory(net);
+	}
+
+	prepare_layer_scheduler(net);
+
+	return;
+}
+
+
 void forward_blank_layer(Darknet::Layer & l, Darknet::NetworkState state)
 {
 	return;
@@ -9,6 +9,8 @@
 
 namespace Darknet
 {
+	class LayerScheduler;
+
 	/** A place to store other details related to the neural network which we cannot easily add to the usual
 	 * @ref Darknet::Network structure.  These are typically C++ objects, or things added post %Darknet V3 (2024-08).
 	 *
@@ -139,6 +141,101 @@ namespace Darknet
 			 * @since 2024-10-07
 			 */
 			SInt classes_to_ignore;
+
+			/** Set when this network was created by @ref Darknet::clone_neural_network().  The weights, biases, and
+			 * batch norm parameters of every layer are then owned by the original network and must not be freed here.
+			 *
+			 * @since 2026-10-17
+			 */
+			bool shares_weights;
+
+			/** Shared buffers used as layer outputs once @ref plan_inference_memory() has run.  Each buffer is used by
+			 * several layers whose outputs are never needed at the same time.  Empty if the network was not planned.
+			 *
+			 * @since 2026-10-17
+			 */
+			std::vector<float *> output_arenas;
+
+			/// Index of every layer whose @p output points into one of the @ref output_arenas.  @since 2026-10-17
+			VInt planned_layers;
+
+			/** Network input re-used on every call to @ref Darknet::predict() so images can be converted directly into
+			 * the format expected by the first layer without allocating a new image for each frame.
+			 *
+			 * @see @ref Darknet::bgr_mat_to_rgb_planar()
+			 * @since 2026-10-17
+			 */
+			std::vector<float> input_buffer;
+
+			/** Candidate objects found in the YOLO output layers.  Re-used for every image so the memory is only
+			 * allocated once.
+			 *
+			 * @see @ref get_network_boxes()
+			 * @since 2026-10-17
+			 */
+			Output_Object_Cache output_object_cache;
+
+			/** Set by the @p channels_last=1 option in the @p [net] section of the .cfg file.
+			 *
+			 * @see @ref prepare_channels_last()
+			 * @since 2026-10-17
+			 */
+			bool channels_last_requested;
+
+			/** Set when every layer has been switched to channels-last (NHWC) data for CPU inference.
+			 *
+			 * @see @ref prepare_channels_last()
+			 * @since 2026-10-17
+			 */
+			bool channels_last;
+
+			/// The network input converted to channels-last.  @since 2026-10-17
+			std::vector<float> channels_last_input;
+
+			/** Set by the @p weights_storage=fp16 or @p weights_storage=bf16 option in the @p [net] section of the .cfg
+			 * file.  Defaults to @p fp32.
+			 *
+			 * @see @ref prepare_weights_storage()
+			 * @since 2026-10-17
+			 */
+			Darknet::EWeightsStorage weights_storage;
+
+			/** Keeps the memory-mapped weights file alive while any layer (including in cloned networks) points into it.
+			 *
+			 * @see @ref save_mapped_weights()
+			 * @since 2026-10-17
+			 */
+			std::shared_ptr<void> mapped_weights;
+
+			/** Set by the @p concurrent_layers=N option in the @p [net] section of the .cfg file.  The maximum number of
+			 * independent layers which may run at the same time during CPU inference.  Defaults to @p 1.
+			 *
+			 * @see @ref prepare_layer_scheduler()
+			 * @since 2026-10-17
+			 */
+			int concurrent_layers;
+
+			/** Set by the @p lazy_class_activation=1 option in the @p [net] section of the .cfg file.  During CPU
+			 * inference the @p [yolo] layers then only activate the coordinates and objectness.  The class values are
+			 * only activated for the cells which pass the objectness threshold.  Defaults to @p false.
+			 *
+			 * @see @ref activate_yolo_classes()
+			 * @since 2026-10-17
+			 */
+			bool lazy_class_activation;
+
+			/** Set by the @p share_layer_outputs=1 option in the @p [net] section of the .cfg file.  When the network is
+			 * loaded for inference, layers whose outputs are no longer needed then share memory with later layers.  Most
+			 * layer outputs are overwritten during the forward pass, so only set this when the caller reads nothing but
+			 * the detection layers.  Defaults to @p false.
+			 *
+			 * @see @ref plan_inference_memory()
+			 * @since 2026-10-17
+			 */
+			bool share_layer_outputs;
+
+			/// Runs independent layers at the same time, see @ref prepare_layer_scheduler().  @since 2026-10-17
+			std::shared_ptr<Darknet::LayerScheduler> scheduler;
 	};
 
 
@@ -348,6 +445,30 @@ Darknet::Image get_network_image(Darknet::Network & net);
 Darknet::Image get_network_image_layer(Darknet::Network & net, int i);
 void visualize_network(Darknet::Network & net);
 int resize_network(Darknet::Network * net, int w, int h);
+
+/// Re-allocate the network workspace after the workspace needed by one of the layers has changed.
+int recalculate_workspace_size(Darknet::Network * net);
+
+/** Inference-only memory optimization.  Determines when each layer output is last read (including references from
+ * @p [route], @p [shortcut], @p [sam], and @p [scale_channels] layers) and assigns the outputs to a small number of
+ * shared buffers.  Outputs of YOLO layers and the final layer are never shared since they are read once the network
+ * has finished running.  Nothing is done if the network contains layer types which keep state between calls, or
+ * when running on a GPU.  Networks loaded with @ref load_network_custom() only call this when the .cfg file has
+ * @p share_layer_outputs=1 in the @p [net] section.
+ *
+ * @note The network cannot be used for training once this has been called.
+ *
+ * @see @ref release_inference_memory()
+ * @since 2026-10-17
+ */
+void plan_inference_memory(Darknet::Network & net);
+
+/** Undo @ref plan_inference_memory().  Planned layers are left with a @p nullptr output, so the caller must either
+ * allocate new outputs (such as @ref resize_network()) or free the network.
+ *
+ * @since 2026-10-17
+ */
+void release_inference_memory(Darknet::Network & net);
 void set_batch_network(Darknet::Network * net, int b);
 int get_network_input_size(Darknet::Network & net);
 
@@ -362,11 +483,71 @@ void ema_apply(Darknet::Network & net);
 void reject_similar_weights(Darknet::Network & net, float sim_threshold);
 
 float *network_predict(Darknet::Network & net, float *input);
+Darknet::Detection * make_network_boxes_batch(Darknet::Network * net, float thresh, int *num, int batch);
+void fill_network_boxes_batch(Darknet::Network * net, int w, int h, float thresh, float hier, int *map, int relative, Darknet::Detection *dets, int letter, int batch);
 det_num_pair* network_predict_batch(Darknet::Network *net, Darknet::Image im, int batch_size, int w, int h, float thresh, float hier, int *map, int relative, int letter);
 void free_batch_detections(det_num_pair *det_num_pairs, int n);
 void fuse_conv_batchnorm(Darknet::Network & net);
 
+/** Pre-transform the weights of every 3x3 stride-1 convolutional layer so CPU inference can use Winograd instead of
+ * im2col + GEMM.  Call this after @ref fuse_conv_batchnorm() on networks that are only used for inference.  Does
+ * nothing when running on a GPU.
+ *
+ * @since 2026-10-17
+ */
+void prepare_winograd_weights(Darknet::Network & net);
+
+/** Switch a network which is only used for CPU inference to channels-last (NHWC) data when the @p [net] section of
+ * the .cfg file has @p channels_last=1.  The input is converted once at the start of @ref forward_network(), and each
+ * YOLO layer converts its own input back to planar data in @ref forward_yolo_layer_nhwc().  The network stays planar if
+ * any layer does not have a channels-last implementation.  Call this after @ref fuse_conv_batchnorm().
+ *
+ * @since 2026-10-17
+ */
+void prepare_channels_last(Darknet::Network & net);
+
+/** Store the weights of convolutional layers as FP16 or BF16 when the @p [net] section of the .cfg file has
+ * @p weights_storage=fp16 or @p weights_storage=bf16.  This halves the memory used by those weights, and the amount of
+ * memory bandwidth needed to read them during CPU inference.  The weights are expanded back to FP32 while they are
+ * packed for the GEMM micro-kernel.  Call this after @ref prepare_channels_last() and @ref prepare_winograd_weights(),
+ * since channels-last networks and layers which use Winograd must keep their FP32 weights.
+ *
+ * @since 2026-10-17
+ */
+void prepare_weights_storage(Darknet::Network & net);
+
+/** Pack the gates of every LSTM layer for CPU inference, see @ref prepare_lstm_layer_inference().  Only call this for
+ * networks which will not be trained, since the packed weights are not updated.  Nothing is done when running on a GPU.
+ *
+ * @since 2026-10-17
+ */
+void prepare_lstm_inference(Darknet::Network & net);
+
+/** Get a network which has just been loaded ready for inference.  This runs @ref fuse_conv_batchnorm(),
+ * @ref calculate_binary_weights(), @ref prepare_channels_last(), @ref prepare_winograd_weights(),
+ * @ref prepare_weights_storage(), @ref prepare_lstm_inference(), optionally @ref plan_inference_memory(), and
+ * @ref prepare_layer_scheduler() in the order they require.  Set @p share_layer_outputs when the network is never used
+ * for anything else, since the outputs of most layers are overwritten once @ref plan_inference_memory() has run.  The
+ * network cannot be trained once this has been called.
+ *
+ * @since 2026-10-17
+ */
+void prepare_network_for_inference(Darknet::Network & net, const bool share_layer_outputs = false);
+
 float validate_detector_map(const char * datacfg, const char * cfgfile, const char * weightfile, float thresh_calc_avg_iou, const float iou_thresh, const int map_points, int letter_box, Darknet::Network *existing_net);
+
+/** Calibrate the activation ranges of a network on a list of images, write a copy of the weights with an INT8 section
+ * for the CPU, and report the change in mAP.  This is @p "darknet detector quantize".
+ * @since 2026-10-17
+ */
+void quantize_detector(const char * datacfg, const char * cfgfile, const char * weightfile, const char * outfile, float thresh, float iou_thresh, int map_points, int letter_box);
+
+/** Write the images and annotations of the @p train and @p valid lists into dataset shards, see
+ * @ref Darknet::DatasetShard.  This is @p "darknet detector pack".
+ * @since 2026-10-17
+ */
+void pack_detector_dataset(const char * datacfg);
+
 void train_detector(const char *datacfg, const char *cfgfile, const char *weightfile, int *gpus, int ngpus, int clear, int dont_show, int calc_map, float thresh, float iou_thresh, int mjpeg_port, int show_imgs, int benchmark_layers, const char* chart_path);
 void test_detector(const char *datacfg, const char *cfgfile, const char *weightfile, const char *filename, float thresh, float hier_thresh, int dont_show, int ext_output, int save_labels, const char *outfile, int letter_box, int benchmark_layers);
 int network_width(Darknet::Network *net);
@@ -0,0 +1,357 @@
+#include "darknet_internal.hpp"
+
+
+namespace
+{
+	static auto & cfg_and_state = Darknet::CfgAndState::get();
+
+
+	/** Layer types which only read the previous layer, or the layers named in @p input_layers and @p index.  Other
+	 * types are either only used for training, keep state from one call to the next, or may read other layers.
+	 */
+	static inline bool can_schedule_layer(const Darknet::Layer & l)
+	{
+		TAT(TATPARMS);
+
+		switch (l.type)
+		{
+			case Darknet::ELayerType::CONVOLUTIONAL:
+			case Darknet::ELayerType::CONNECTED:
+			case Darknet::ELayerType::MAXPOOL:
+			case Darknet::ELayerType::LOCAL_AVGPOOL:
+			case Darknet::ELayerType::AVGPOOL:
+			case Darknet::ELayerType::SOFTMAX:
+			case Darknet::ELayerType::DROPOUT:
+			case Darknet::ELayerType::ROUTE:
+			case Darknet::ELayerType::SHORTCUT:
+			case Darknet::ELayerType::SCALE_CHANNELS:
+			case Darknet::ELayerType::SAM:
+			case Darknet::ELayerType::REGION:
+			case Darknet::ELayerType::YOLO:
+			case Darknet::ELayerType::GAUSSIAN_YOLO:
+			case Darknet::ELayerType::REORG:
+			case Darknet::ELayerType::UPSAMPLE:
+			{
+				return true;
+			}
+			default:
+			{
+				return false;
+			}
+		}
+	}
+
+
+	/// The layers whose output is read by layer @p idx.
+	static inline std::set<int> get_layer_inputs(const Darknet::Network & net, const int idx)
+	{
+		TAT(TATPARMS);
+
+		const Darknet::Layer & l = net.layers[idx];
+
+		std::set<int> inputs;
+		if (idx > 0 and l.type != Darknet::ELayerType::ROUTE)
+		{
+			inputs.insert(idx - 1);
+		}
+		if (l.type == Darknet::ELayerType::ROUTE or l.type == Darknet::ELayerType::SHORTCUT)
+		{
+			inputs.insert(l.input_layers, l.input_layers + l.n);
+		}
+		if (l.type == Darknet::ELayerType::SHORTCUT or
+			l.type == Darknet::ELayerType::SAM or
+			l.type == Darknet::ELayerType::SCALE_CHANNELS)
+		{
+			inputs.insert(l.index);
+		}
+
+		return inputs;
+	}
+}
+
+
+Darknet::LayerScheduler::LayerScheduler(const Darknet::Network & net, const int threads) :
+	current_net(nullptr),
+	running(0),
+	completed(0),
+	omp_threads(1),
+	stop(false)
+{
+	TAT(TATPARMS);
+
+	// the buffer each layer writes into; dropout layers write into the output of the previous layer
+	VInt owner(net.n);
+	for (int i = 0; i < net.n; ++i)
+	{
+		owner[i] = i;
+		if (net.layers[i].type == Darknet::ELayerType::DROPOUT and i > 0)
+		{
+			owner[i] = owner[i - 1];
+		}
+	}
+
+	std::vector<std::set<int>> waits_for(net.n);
+	std::vector<std::set<int>> readers(net.n);
+	for (int i = 0; i < net.n; ++i)
+	{
+		for (const int idx : get_layer_inputs(net, i))
+		{
+			waits_for[i].insert(idx);
+			readers[owner[idx]].insert(i);
+		}
+	}
+
+	// a layer which re-uses a shared output buffer must wait until the previous contents have been read
+	std::map<const float *, int> last_writer;
+	for (int i = 0; i < net.n; ++i)
+	{
+		if (owner[i] != i)
+		{
+			continue;
+		}
+
+		const float * buffer = net.layers[i].output;
+		auto iter = last_writer.find(buffer);
+		if (iter != last_writer.end())
+		{
+			const int previous = iter->second;
+			waits_for[i].insert(previous);
+			for (const int reader : readers[previous])
+			{
+				if (reader != i)
+				{
+					waits_for[i].insert(reader);
+				}
+			}
+		}
+		last_writer[buffer] = i;
+	}
+
+	successors.resize(net.n);
+	dependencies.resize(net.n, 0);
+	input_layer.resize(net.n, -1);
+	for (int i = 0; i < net.n; ++i)
+	{
+		input_layer[i] = i - 1;
+		for (const int idx : waits_for[i])
+		{
+			successors[idx].push_back(i);
+			dependencies[i] ++;
+		}
+	}
+
+	size_t workspace_size = 0;
+	for (int i = 0; i < net.n; ++i)
+	{
+		workspace_size = std::max(workspace_size, net.layers[i].workspace_size);
+	}
+
+	workspaces.resize(std::max(1, threads));
+	for (size_t id = 1; id < workspaces.size(); ++id)
+	{
+		workspaces[id].resize(workspace_size / sizeof(float) + 1);
+	}
+
+	return;
+}
+
+
+Darknet::LayerScheduler::~LayerScheduler()
+{
+	TAT(TATPARMS);
+
+	{
+		std::lock_guard lock(mutex);
+		stop = true;
+	}
+	cv.notify_all();
+
+	for (auto & worker : workers)
+	{
+		cfg_and_state.del_thread_name(worker);
+		worker.join();
+	}
+
+	return;
+}
+
+
+bool Darknet::LayerScheduler::has_independent_layers() const
+{
+	TAT(TATPARMS);
+
+	// when every layer waits for the one before it, the layers can only run in index order
+	for (size_t i = 1; i < successors.size(); ++i)
+	{
+		const auto & v = successors[i - 1];
+		if (std::find(v.begin(), v.end(), static_cast<int>(i)) == v.end())
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+void Darknet::LayerScheduler::forward(Darknet::Network & network, Darknet::NetworkState network_state)
+{
+	TAT(TATPARMS);
+
+#ifdef OPENMP
+	const int max_threads = omp_get_max_threads();
+#else
+	const int max_threads = 1;
+#endif
+
+	{
+		std::lock_guard lock(mutex);
+
+		current_net		= &network;
+		current_state	= network_state;
+		remaining		= dependencies;
+		running			= 0;
+		completed		= 0;
+		omp_threads		= max_threads;
+		ready.clear();
+		for (int i = 0; i < network.n; ++i)
+		{
+			if (remaining[i] == 0)
+			{
+				ready.insert(i);
+			}
+		}
+
+		while (workers.size() + 1 < workspaces.size())
+		{
+			const size_t id = workers.size() + 1;
+			workers.emplace_back(&LayerScheduler::run, this, id);
+			cfg_and_state.set_thread_name(workers.back(), "layer scheduler thread #" + std::to_string(id));
+		}
+	}
+	cv.notify_all();
+
+	// the calling thread runs layers as well
+	run(0);
+
+#ifdef OPENMP
+	omp_set_num_threads(max_threads);
+#endif
+
+	return;
+}
+
+
+void Darknet::LayerScheduler::run(const size_t id)
+{
+	TAT(TATPARMS);
+
+	std::unique_lock lock(mutex);
+
+	while (true)
+	{
+		cv.wait(lock, [&]()
+		{
+			return stop or not ready.empty() or (id == 0 and completed == current_net->n);
+		});
+
+		if (stop or (id == 0 and completed == current_net->n))
+		{
+			break;
+		}
+
+		const int idx = *ready.begin();
+		ready.erase(ready.begin());
+		running ++;
+
+		// share the OpenMP threads between the layers which are running or about to run
+		const int threads = std::max(1, omp_threads / (running + static_cast<int>(ready.size())));
+
+		Darknet::NetworkState s = current_state;
+		s.index = idx;
+		if (input_layer[idx] >= 0)
+		{
+			s.input = current_net->layers[input_layer[idx]].output;
+		}
+		if (id > 0)
+		{
+			s.workspace = workspaces[id].data();
+		}
+		Darknet::Layer & l = current_net->layers[idx];
+
+		lock.unlock();
+
+#ifdef OPENMP
+		omp_set_num_threads(threads);
+#else
+		(void)threads;
+#endif
+		l.forward(l, s);
+
+		lock.lock();
+
+		running --;
+		completed ++;
+		for (const int successor : successors[idx])
+		{
+			remaining[successor] --;
+			if (remaining[successor] == 0)
+			{
+				ready.insert(successor);
+			}
+		}
+
+		cv.notify_all();
+	}
+
+	return;
+}
+
+
+void prepare_layer_scheduler(Darknet::Network & net)
+{
+	TAT(TATPARMS);
+
+	if (net.details == nullptr)
+	{
+		return;
+	}
+
+	net.details->scheduler.reset();
+
+	if (net.details->concurrent_layers < 2 or cfg_and_state.gpu_index >= 0 or net.n < 2)
+	{
+		return;
+	}
+
+	for (int idx = 0; idx < net.n; ++idx)
+	{
+		if (not can_schedule_layer(net.layers[idx]))
+		{
+			if (cfg_and_state.is_verbose)
+			{
+				std::cout << "Layers will run in order: layer #" << idx << " (" << Darknet::to_string(net.layers[idx].type) << ") cannot be scheduled" << std::endl;
+			}
+			return;
+		}
+	}
+
+	auto scheduler = std::make_shared<Darknet::LayerScheduler>(net, net.details->concurrent_layers);
+	if (not scheduler->has_independent_layers())
+	{
+		if (cfg_and_state.is_verbose)
+		{
+			std::cout << "Layers will run in order: every layer depends on the previous one" << std::endl;
+		}
+		return;
+	}
+
+	net.details->scheduler = scheduler;
+
+	if (cfg_and_state.is_verbose)
+	{
+		std::cout << "Running up to " << net.details->concurrent_layers << " independent layers at the same time" << std::endl;
+	}
+
+	return;
+}
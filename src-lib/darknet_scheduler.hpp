@@ -0,0 +1,97 @@
+/* Darknet/YOLO:  https://github.com/hank-ai/darknet
+ * Copyright 2026 Stephane Charette
+ */
+
+#pragma once
+
+#ifndef __cplusplus
+#error "The Darknet/YOLO project requires a C++ compiler."
+#endif
+
+/** @file
+ * Run independent layers of a neural network at the same time during CPU inference.
+ */
+
+#include "darknet.hpp"
+
+
+namespace Darknet
+{
+	/** Runs the layers of a network used for CPU inference as a dependency graph instead of strictly in index order.
+	 * Branches which do not depend on each other -- such as the parallel maxpools in an SPP block, or the separate YOLO
+	 * heads -- can then run at the same time.
+	 *
+	 * The dependencies come from the previous layer (every layer except @p [route] reads it), the input layers of
+	 * @p [route] and @p [shortcut] layers, and the @p from layer of @p [sam] and @p [scale_channels] layers.  When the
+	 * outputs have been assigned to shared buffers by @ref plan_inference_memory(), a layer also waits for every reader
+	 * of the previous output stored in the same buffer.
+	 *
+	 * Idle threads take the lowest-numbered layer which is ready to run.  The OpenMP threads are divided between the
+	 * layers which are running or ready, so a layer which runs alone still uses every thread.
+	 *
+	 * @see @ref prepare_layer_scheduler()
+	 * @since 2026-10-17
+	 */
+	class LayerScheduler final
+	{
+		public:
+
+			/// Build the dependency graph.  The worker threads are only started the first time @ref forward() is called.
+			LayerScheduler(const Darknet::Network & net, const int threads);
+
+			/// Stop and join the worker threads.
+			~LayerScheduler();
+
+			LayerScheduler(const LayerScheduler &) = delete;
+			LayerScheduler & operator=(const LayerScheduler &) = delete;
+
+			/// Returns @p true if at least two layers can run at the same time.
+			bool has_independent_layers() const;
+
+			/// Run every layer of the network.  Returns once the last layer has finished.
+			void forward(Darknet::Network & net, Darknet::NetworkState state);
+
+		private:
+
+			/// Take ready layers and run them until @ref forward() has finished (@p id zero) or the scheduler is stopped.
+			void run(const size_t id);
+
+			/// Layers which must wait for each layer to finish.
+			std::vector<VInt> successors;
+
+			/// Number of layers each layer must wait for.
+			VInt dependencies;
+
+			/// The layer whose output becomes @p state.input, or @p -1 for the network input.
+			VInt input_layer;
+
+			/// Workspace for each worker thread.  The thread calling @ref forward() uses the network workspace.
+			std::vector<std::vector<float>> workspaces;
+
+			std::vector<std::thread> workers;
+
+			std::mutex mutex;
+			std::condition_variable cv;
+
+			/// @{ State of the call to @ref forward() which is running.  Protected by @ref mutex.
+			Darknet::Network * current_net;
+			Darknet::NetworkState current_state;
+			VInt remaining;
+			std::set<int> ready;
+			int running;
+			int completed;
+			int omp_threads;
+			bool stop;
+			/// @}
+	};
+}
+
+
+/** Use a @ref Darknet::LayerScheduler for CPU inference when the @p [net] section of the .cfg file has
+ * @p concurrent_layers=2 or more.  Nothing is done when running on a GPU, when the network contains layer types
+ * which might read other layers, or when no two layers are independent.  Call this after @ref plan_inference_memory(),
+ * and again whenever the layer outputs change.
+ *
+ * @since 2026-10-17
+ */
+void prepare_layer_scheduler(Darknet::Network & net);
@@ -1,6 +1,16 @@
 #include "Chart.hpp"
 #include "darknet_internal.hpp"
 
+#ifdef WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 
 namespace
 {
@@ -374,6 +384,63 @@ std::string Darknet::get_command_output(const std::string & cmd)
 }
 
 
+std::shared_ptr<void> Darknet::map_file(const char * filename, uint64_t & size)
+{
+	TAT(TATPARMS);
+
+#ifdef WIN32
+	HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		file_error(filename, DARKNET_LOC);
+	}
+
+	LARGE_INTEGER file_size;
+	GetFileSizeEx(file, &file_size);
+	size = file_size.QuadPart;
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (mapping == nullptr)
+	{
+		darknet_fatal_error(DARKNET_LOC, "failed to map file %s (error %lu)", filename, GetLastError());
+	}
+
+	void * addr = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+	CloseHandle(mapping);
+	if (addr == nullptr)
+	{
+		darknet_fatal_error(DARKNET_LOC, "failed to map file %s (error %lu)", filename, GetLastError());
+	}
+
+	return std::shared_ptr<void>(addr, [](void * ptr) { UnmapViewOfFile(ptr); });
+#else
+	const int fd = open(filename, O_RDONLY);
+	if (fd < 0)
+	{
+		file_error(filename, DARKNET_LOC);
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0)
+	{
+		close(fd);
+		darknet_fatal_error(DARKNET_LOC, "failed to get the size of file %s: %s", filename, strerror(errno));
+	}
+	size = st.st_size;
+
+	void * addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED)
+	{
+		darknet_fatal_error(DARKNET_LOC, "failed to map file %s: %s", filename, strerror(errno));
+	}
+
+	return std::shared_ptr<void>(addr, [size](void * ptr) { munmap(ptr, size); });
+#endif
+}
+
+
 void Darknet::cfg_layers()
 {
 	TAT(TATPARMS);
@@ -38,5 +38,13 @@ namespace Darknet
 
 	std::string get_command_output(const std::string & cmd);
 
+	/** Map the entire file into memory.  The mapping is private:  the pages are shared with every other process which
+	 * maps the same file, and code which modifies the contents (such as training with memory-mapped weights) gets its
+	 * own copy of the pages it touches.  The file is unmapped when the last copy of the returned pointer is destroyed.
+	 *
+	 * @since 2026-10-17
+	 */
+	std::shared_ptr<void> map_file(const char * filename, uint64_t & size);
+
 	void cfg_layers();
 }
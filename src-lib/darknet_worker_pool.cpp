@@ -0,0 +1,174 @@
+#include "darknet_internal.hpp"
+
+
+namespace
+{
+	static auto & cfg_and_state = Darknet::CfgAndState::get();
+}
+
+
+Darknet::WorkerPool & Darknet::WorkerPool::get()
+{
+	TAT(TATPARMS);
+
+	static WorkerPool pool([]()
+	{
+		int threads = cfg_and_state.get("workerthreads", 0);
+		if (threads < 1)
+		{
+			threads = std::max(1U, std::thread::hardware_concurrency());
+		}
+
+		// the thread which calls run() also runs tasks
+		return static_cast<size_t>(threads - 1);
+	}());
+
+	return pool;
+}
+
+
+Darknet::WorkerPool::WorkerPool(const size_t threads) :
+	stop(false)
+{
+	TAT(TATPARMS);
+
+	workers.reserve(threads);
+	for (size_t idx = 0; idx < threads; idx ++)
+	{
+		workers.emplace_back(&WorkerPool::worker, this);
+		cfg_and_state.set_thread_name(workers.back(), "worker pool thread #" + std::to_string(idx + 1));
+	}
+
+	if (cfg_and_state.is_verbose)
+	{
+		std::cout << "Started " << threads << " worker pool thread" << (threads == 1 ? "" : "s") << std::endl;
+	}
+
+	return;
+}
+
+
+Darknet::WorkerPool::~WorkerPool()
+{
+	TAT(TATPARMS);
+
+	{
+		std::lock_guard lock(mutex);
+		stop = true;
+	}
+	cv_work.notify_all();
+
+	for (auto & worker : workers)
+	{
+		cfg_and_state.del_thread_name(worker);
+		worker.join();
+	}
+
+	return;
+}
+
+
+void Darknet::WorkerPool::run(const size_t count, const std::function<void(const size_t)> & task)
+{
+	TAT(TATPARMS);
+
+	if (count == 0)
+	{
+		return;
+	}
+
+	Job job;
+	job.task	= &task;
+	job.count	= count;
+	job.next	= 0;
+	job.done	= 0;
+
+	std::unique_lock lock(mutex);
+
+	if (count > 1 and not workers.empty())
+	{
+		jobs.push_back(&job);
+		cv_work.notify_all();
+	}
+
+	size_t idx = 0;
+	while (take_task(job, idx))
+	{
+		run_task(job, idx, lock);
+	}
+
+	// the workers may still be running the last few tasks
+	cv_done.wait(lock, [&]() { return job.done == job.count; });
+
+	return;
+}
+
+
+bool Darknet::WorkerPool::take_task(Job & job, size_t & idx)
+{
+	TAT(TATPARMS);
+
+	if (job.next >= job.count)
+	{
+		return false;
+	}
+
+	idx = job.next ++;
+
+	if (job.next == job.count)
+	{
+		// nothing left to hand out, so the job no longer needs to be seen by the workers
+		auto iter = std::find(jobs.begin(), jobs.end(), &job);
+		if (iter != jobs.end())
+		{
+			jobs.erase(iter);
+		}
+	}
+
+	return true;
+}
+
+
+void Darknet::WorkerPool::run_task(Job & job, const size_t idx, std::unique_lock<std::mutex> & lock)
+{
+	TAT(TATPARMS);
+
+	lock.unlock();
+	(*job.task)(idx);
+	lock.lock();
+
+	job.done ++;
+	if (job.done == job.count)
+	{
+		cv_done.notify_all();
+	}
+
+	return;
+}
+
+
+void Darknet::WorkerPool::worker()
+{
+	TAT(TATPARMS);
+
+	std::unique_lock lock(mutex);
+
+	while (true)
+	{
+		cv_work.wait(lock, [&]() { return stop or not jobs.empty(); });
+
+		if (stop)
+		{
+			break;
+		}
+
+		Job & job = *jobs.front();
+		size_t idx = 0;
+		if (take_task(job, idx))
+		{
+			run_task(job, idx, lock);
+		}
+	}
+
+	return;
+}
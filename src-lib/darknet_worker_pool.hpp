@@ -0,0 +1,91 @@
+/* Darknet/YOLO:  https://github.com/hank-ai/darknet
+ * Copyright 2026 Stephane Charette
+ */
+
+#pragma once
+
+#ifndef __cplusplus
+#error "The Darknet/YOLO project requires a C++ compiler."
+#endif
+
+/** @file
+ * Library-wide pool of worker threads for CPU work which is split into independent tasks.
+ */
+
+#include "darknet.hpp"
+
+
+namespace Darknet
+{
+	/** A set of threads which is started once and re-used for the life of the process, instead of creating and joining
+	 * new threads every time some work needs to be split up.  This is used to calculate the loss of the YOLO layers
+	 * during training.
+	 *
+	 * The number of threads comes from the @p --worker_threads CLI option, or the number of CPU cores when not set.
+	 *
+	 * Several threads may call @ref run() at the same time, such as when training on multiple GPUs.  The tasks are then
+	 * taken from the oldest job first.  The thread which calls @ref run() also runs tasks from its own job, so a job
+	 * always makes progress even when every worker is busy.
+	 *
+	 * @since 2026-10-17
+	 */
+	class WorkerPool final
+	{
+		public:
+
+			/// Get a reference to the pool used by %Darknet.  The threads are started the first time this is called.
+			static WorkerPool & get();
+
+			/// Stop and join the worker threads.
+			~WorkerPool();
+
+			WorkerPool(const WorkerPool &) = delete;
+			WorkerPool & operator=(const WorkerPool &) = delete;
+
+			/** Call @p task once for every index from zero to @p count - 1, and return once all of them have finished.
+			 * Each index is given to whichever thread is free next.  The tasks must not call @ref run().
+			 */
+			void run(const size_t count, const std::function<void(const size_t)> & task);
+
+			/// The number of worker threads, not counting the threads which call @ref run().
+			size_t size() const { return workers.size(); }
+
+		private:
+
+			/// The tasks started by one call to @ref run().
+			struct Job
+			{
+				const std::function<void(const size_t)> * task;
+				size_t count;
+				size_t next;
+				size_t done;
+			};
+
+			/// Start @p threads workers.
+			WorkerPool(const size_t threads);
+
+			/// Get the next task index from @p job.  Returns @p false once all the tasks have been taken.  Call with @ref mutex locked.
+			bool take_task(Job & job, size_t & idx);
+
+			/// Run the task and update the job.  Called with @ref mutex locked, which is released while the task runs.
+			void run_task(Job & job, const size_t idx, std::unique_lock<std::mutex> & lock);
+
+			/// Loop used by each worker thread.
+			void worker();
+
+			std::vector<std::thread> workers;
+
+			std::mutex mutex;
+
+			/// Signalled when a job is added or the pool is stopped.
+			std::condition_variable cv_work;
+
+			/// Signalled when a task finishes.
+			std::condition_variable cv_done;
+
+			/// @{ Protected by @ref mutex.
+			std::deque<Job *> jobs;
+			bool stop;
+			/// @}
+	};
+}
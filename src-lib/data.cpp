@@ -23,7 +23,8 @@ namespace
 
 
 	/** Flags to indicate to individual data loading threads what they should do.  @p 0 is stop, and @p 1 is go.
-	 * These flags are normally @p 0 and then are set to @p 1 by @ref run_image_loading_control_thread().
+	 * These flags are normally @p 0 and then are set to @p 1 by @ref run_image_loading_control_thread().  Protected by
+	 * @ref data_loading_mutex.
 	 *
 	 * (Was @p std::vector<bool> but that individual bit handling, and we only have a few threads.)
 	 *
@@ -32,13 +33,84 @@ namespace
 	static std::vector<int> data_loading_per_thread_flag;
 
 
-	/// @{ @todo: delete these once the code is cleaned up
-	static const std::chrono::milliseconds thread_wait_ms(5); ///< @todo DELETE THIS! :(
-	static load_args * args_swap = NULL; ///< @todo I wish I better understood how/why this exists...
-	static std::mutex args_swap_mutex; // used to protect access to args_swap
+	/** The arguments given to each data loading thread.  Protected by @ref data_loading_mutex.
+	 *
+	 * @since 2024-04-10
+	 */
+	static load_args * args_swap = NULL;
+
+
+	/// @{ Used to wake up the data loading threads, and to tell the control thread when they are done.  @since 2026-10-17
+	static std::mutex data_loading_mutex;
+	static std::condition_variable data_loading_start_cv;
+	static std::condition_variable data_loading_done_cv;
+	/// @}
+
+
+	/** How often threads waiting for images wake up to check @p cfg_and_state.must_immediately_exit, which is set
+	 * without notifying anyone.  Everything else is signalled through the condition variables.
+	 *
+	 * @since 2026-10-17
+	 */
+	static const std::chrono::milliseconds exit_check_interval(250);
+
+
+	/// @{ The queue of batches loaded ahead of time by @ref Darknet::start_image_prefetching().  @since 2026-10-17
+	static std::thread prefetch_thread;
+	static std::deque<data> prefetched_batches;
+	static size_t prefetch_depth = 1;
+	static bool prefetch_must_stop = false;
+	static std::mutex prefetch_mutex;
+	static std::condition_variable prefetch_cv;
+	/// @}
+
+
+	/// @{ Time spent in each stage of loading the training images, see @ref Darknet::get_image_loading_stats().  @since 2026-10-17
+	static std::atomic<uint64_t> stats_batches		= 0;
+	static std::atomic<uint64_t> stats_images		= 0;
+	static std::atomic<uint64_t> stats_decode_ns	= 0;
+	static std::atomic<uint64_t> stats_augment_ns	= 0;
+	static std::atomic<uint64_t> stats_pack_ns		= 0;
+	static std::atomic<uint64_t> stats_wait_ns		= 0;
 	/// @}
 
 
+	/// Nanoseconds since @p start.
+	static inline uint64_t nanoseconds_since(const std::chrono::high_resolution_clock::time_point & start)
+	{
+		TAT(TATPARMS);
+
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+
+	static inline bool data_loading_must_exit()
+	{
+		TAT(TATPARMS);
+
+		return image_data_loading_threads_must_exit or cfg_and_state.must_immediately_exit;
+	}
+
+
+	static inline void set_box_label(box_label & b, const int track_id, const int id, const float x, const float y, const float w, const float h)
+	{
+		TAT(TATPARMS);
+
+		b.track_id	= track_id;
+		b.id		= id;
+		b.x			= x;
+		b.y			= y;
+		b.h			= h;
+		b.w			= w;
+		b.left		= x - w / 2.0f;
+		b.right		= x + w / 2.0f;
+		b.top		= y - h / 2.0f;
+		b.bottom	= y + h / 2.0f;
+
+		return;
+	}
+
+
 	static inline data concat_datas(data *d, int n)
 	{
 		TAT(TATPARMS);
@@ -158,6 +230,25 @@ box_label *read_boxes(char *filename, int *n)
 {
 	TAT(TATPARMS);
 
+	const int max_obj_img = 4000;// 30000;
+	const int img_hash = (custom_hash(filename) % max_obj_img)*max_obj_img;
+
+	const Darknet::DatasetShard::Entry * packed = Darknet::find_annotations_in_dataset_shards(filename);
+	if (packed)
+	{
+		// the boxes were already parsed when the dataset shard was created
+		const int count = static_cast<int>(packed->number_of_boxes);
+		box_label * boxes = (box_label*)xcalloc(std::max(1, count), sizeof(box_label));
+		for (int i = 0; i < count; ++i)
+		{
+			const auto & b = packed->boxes[i];
+			set_box_label(boxes[i], i + img_hash, b.id, b.x, b.y, b.w, b.h);
+		}
+		*n = count;
+
+		return boxes;
+	}
+
 	box_label* boxes = (box_label*)xcalloc(1, sizeof(box_label));
 	FILE *file = fopen(filename, "r");
 	if (!file)
@@ -165,8 +256,6 @@ box_label *read_boxes(char *filename, int *n)
 		darknet_fatal_error(DARKNET_LOC, "failed to open annotation file \"%s\"", filename);
 	}
 
-	const int max_obj_img = 4000;// 30000;
-	const int img_hash = (custom_hash(filename) % max_obj_img)*max_obj_img;
 	float x, y, h, w;
 	int id;
 	int count = 0;
@@ -175,16 +264,7 @@ box_label *read_boxes(char *filename, int *n)
 //		std::cout << "x=" << x << " y=" << y << " w=" << w << " h=" << h << std::endl;
 
 		boxes = (box_label*)xrealloc(boxes, (count + 1) * sizeof(box_label));
-		boxes[count].track_id = count + img_hash;
-		boxes[count].id = id;
-		boxes[count].x = x;
-		boxes[count].y = y;
-		boxes[count].h = h;
-		boxes[count].w = w;
-		boxes[count].left   = x - w / 2.0f;
-		boxes[count].right  = x + w / 2.0f;
-		boxes[count].top    = y - h / 2.0f;
-		boxes[count].bottom = y + h / 2.0f;
+		set_box_label(boxes[count], count + img_hash, id, x, y, w, h);
 		++count;
 	}
 
@@ -710,10 +790,15 @@ data load_data_detection(int n, char **paths, int m, int w, int h, int c, int bo
 		// about to load multiple images ("n"), usually batch size divided by the number of loading threads
 		for (int i = 0; i < n; ++i)
 		{
+			const auto image_start = std::chrono::high_resolution_clock::now();
+
 			float *truth = (float*)xcalloc(truth_size * boxes, sizeof(float));
 			const char *filename = random_paths[i];
 
-			cv::Mat src = load_rgb_mat_image(filename, c);
+			cv::Mat src = Darknet::ImageCache::get().load(filename, c);
+
+			const uint64_t decode_ns = nanoseconds_since(image_start);
+			stats_decode_ns += decode_ns;
 
 			const int oh = src.rows;	// original height
 			const int ow = src.cols;	// original width
@@ -995,6 +1080,9 @@ data load_data_detection(int n, char **paths, int m, int w, int h, int c, int bo
 			}
 
 			free(truth);
+
+			stats_augment_ns += nanoseconds_since(image_start) - decode_ns;
+			stats_images ++;
 		}
 
 		if (random_paths)
@@ -1055,53 +1143,49 @@ void Darknet::image_loading_loop(const int idx, load_args args)
 
 	cfg_and_state.set_thread_name("image loading loop #" + std::to_string(idx));
 
-	const int number_of_threads	= args.threads;	// typically will be 6
-	const int number_of_images	= args.n;		// typically will be 64 (batch size)
+	std::unique_lock lock(data_loading_mutex);
 
-	// calculate the number of images this thread needs to load at once
-	// e.g., 64 batch size / 6 threads = 10 or 11 images per thread
-	args.n = (idx + 1) * number_of_images / number_of_threads - idx * number_of_images / number_of_threads;
-
-	while (image_data_loading_threads_must_exit == false and
-			cfg_and_state.must_immediately_exit == false)
+	while (true)
 	{
-		/// @todo get rid of this busy-loop
-
 		// wait until the control thread tells us we can load the next set of images
+		data_loading_start_cv.wait_for(lock, exit_check_interval, [&]()
+		{
+			return data_loading_must_exit() or data_loading_per_thread_flag[idx] != 0;
+		});
+
+		if (data_loading_must_exit())
+		{
+			break;
+		}
+
 		if (data_loading_per_thread_flag[idx] == 0)
 		{
-			std::this_thread::sleep_for(thread_wait_ms);
 			continue;
 		}
 
 		// if we get here, then the control thread has told us to load the next image
-
-		args_swap_mutex.lock();
 		load_args args_local = args_swap[idx];
-		args_swap_mutex.unlock();
 
+		lock.unlock();
 		Darknet::load_single_image_data(args_local);
+		lock.lock();
 
 		data_loading_per_thread_flag[idx] = 0;
+		data_loading_done_cv.notify_all();
 	}
 
+	lock.unlock();
+
 	cfg_and_state.del_thread_name();
 
 	return;
 }
 
 
-void Darknet::run_image_loading_control_thread(load_args args)
+data Darknet::load_batch_of_images(load_args args)
 {
-	/* NOTE:  This is normally started on a new thread!  For example, you might see this:
-	 *
-	 *		std::thread t(Darknet::run_image_loading_control_thread, args);
-	 */
-
 	TAT(TATPARMS);
 
-	cfg_and_state.set_thread_name("image loading control thread");
-
 	if (args.threads == 0)
 	{
 		args.threads = 1;
@@ -1109,9 +1193,10 @@ void Darknet::run_image_loading_control_thread(load_args args)
 	const int number_of_threads	= args.threads;	// typically will be 6
 	const int number_of_images	= args.n;		// typically will be 64 (batch size)
 
-	data * out = args.d;
 	data * buffers = (data*)xcalloc(number_of_threads, sizeof(data));
 
+	std::unique_lock lock(data_loading_mutex);
+
 	// create the secondary threads
 	if (data_loading_threads.empty())
 	{
@@ -1128,6 +1213,10 @@ void Darknet::run_image_loading_control_thread(load_args args)
 			data_loading_threads.emplace_back(image_loading_loop, idx, args);
 		}
 	}
+	else if (data_loading_threads.size() != static_cast<size_t>(number_of_threads))
+	{
+		darknet_fatal_error(DARKNET_LOC, "%d image loading threads were requested, but %lu are running; call stop_image_loading_threads() when the number of threads changes", number_of_threads, data_loading_threads.size());
+	}
 
 	// tell each thread that we want more images, and where they can be stored
 	for (int idx = 0; idx < number_of_threads; ++idx)
@@ -1135,27 +1224,25 @@ void Darknet::run_image_loading_control_thread(load_args args)
 		args.d = buffers + idx;
 		args.n = (idx + 1) * number_of_images / number_of_threads - idx * number_of_images / number_of_threads;
 
-		args_swap_mutex.lock();
 		args_swap[idx] = args;
-		args_swap_mutex.unlock();
-
 		data_loading_per_thread_flag[idx] = 1;
 	}
+	data_loading_start_cv.notify_all();
 
-	// wait for the loading threads to be done
-	for (int idx = 0; idx < number_of_threads; ++idx)
+	// wait for the loading threads to be done -- each loading thread resets its flag to zero once the images are ready
+	while (not data_loading_must_exit() and
+			std::any_of(data_loading_per_thread_flag.begin(), data_loading_per_thread_flag.end(), [](const int flag) { return flag != 0; }))
 	{
-		while (image_data_loading_threads_must_exit == false and
-				cfg_and_state.must_immediately_exit == false and
-				data_loading_per_thread_flag[idx] != 0) // the loading thread will reset this flag to zero once it is ready
-		{
-			std::this_thread::sleep_for(thread_wait_ms);
-		}
+		data_loading_done_cv.wait_for(lock, exit_check_interval);
 	}
 
+	lock.unlock();
+
 	// process the results
-	*out = concat_datas(buffers, number_of_threads);
-	out->shallow = 0;
+	const auto pack_start = std::chrono::high_resolution_clock::now();
+
+	data out = concat_datas(buffers, number_of_threads);
+	out.shallow = 0;
 
 	for (int idx = 0; idx < number_of_threads; ++idx)
 	{
@@ -1164,19 +1251,183 @@ void Darknet::run_image_loading_control_thread(load_args args)
 	}
 	free(buffers);
 
+	stats_pack_ns += nanoseconds_since(pack_start);
+	stats_batches ++;
+
+	return out;
+}
+
+
+void Darknet::run_image_loading_control_thread(load_args args)
+{
+	/* NOTE:  This is normally started on a new thread!  For example, you might see this:
+	 *
+	 *		std::thread t(Darknet::run_image_loading_control_thread, args);
+	 */
+
+	TAT(TATPARMS);
+
+	cfg_and_state.set_thread_name("image loading control thread");
+
+	*args.d = load_batch_of_images(args);
+
 	cfg_and_state.del_thread_name();
 
 	return;
 }
 
 
+void Darknet::start_image_prefetching(load_args args, const int depth)
+{
+	TAT(TATPARMS);
+
+	// any batches which have already been loaded used the previous arguments
+	stop_image_prefetching();
+
+	prefetch_depth		= std::max(1, depth);
+	prefetch_must_stop	= false;
+
+	prefetch_thread = std::thread([args]()
+	{
+		cfg_and_state.set_thread_name("image prefetching thread");
+
+		std::unique_lock lock(prefetch_mutex);
+
+		while (true)
+		{
+			// wait until there is room in the queue for another batch
+			prefetch_cv.wait_for(lock, exit_check_interval, []()
+			{
+				return prefetch_must_stop or data_loading_must_exit() or prefetched_batches.size() < prefetch_depth;
+			});
+
+			if (prefetch_must_stop or data_loading_must_exit())
+			{
+				break;
+			}
+
+			if (prefetched_batches.size() >= prefetch_depth)
+			{
+				continue;
+			}
+
+			lock.unlock();
+			data d = load_batch_of_images(args);
+			lock.lock();
+
+			if (prefetch_must_stop)
+			{
+				Darknet::free_data(d);
+				break;
+			}
+
+			prefetched_batches.push_back(d);
+			prefetch_cv.notify_all();
+		}
+
+		lock.unlock();
+
+		cfg_and_state.del_thread_name();
+	});
+
+	if (cfg_and_state.is_verbose)
+	{
+		std::cout << "Loading up to " << prefetch_depth << " batch" << (prefetch_depth == 1 ? "" : "es") << " of images ahead of training" << std::endl;
+	}
+
+	return;
+}
+
+
+data Darknet::get_prefetched_images()
+{
+	TAT(TATPARMS);
+
+	const auto wait_start = std::chrono::high_resolution_clock::now();
+
+	std::unique_lock lock(prefetch_mutex);
+
+	while (prefetched_batches.empty())
+	{
+		if (data_loading_must_exit() or not prefetch_thread.joinable())
+		{
+			// we're exiting, or nobody is loading images
+			return data{0};
+		}
+
+		prefetch_cv.wait_for(lock, exit_check_interval);
+	}
+
+	data d = prefetched_batches.front();
+	prefetched_batches.pop_front();
+	prefetch_cv.notify_all();
+
+	stats_wait_ns += nanoseconds_since(wait_start);
+
+	return d;
+}
+
+
+void Darknet::stop_image_prefetching()
+{
+	TAT(TATPARMS);
+
+	if (prefetch_thread.joinable())
+	{
+		{
+			std::lock_guard lock(prefetch_mutex);
+			prefetch_must_stop = true;
+		}
+		prefetch_cv.notify_all();
+
+		prefetch_thread.join();
+	}
+
+	std::lock_guard lock(prefetch_mutex);
+	for (auto & d : prefetched_batches)
+	{
+		Darknet::free_data(d);
+	}
+	prefetched_batches.clear();
+
+	return;
+}
+
+
+Darknet::ImageLoadingStats Darknet::get_image_loading_stats(const bool reset)
+{
+	TAT(TATPARMS);
+
+	const auto to_seconds = [&](std::atomic<uint64_t> & ns)
+	{
+		return (reset ? ns.exchange(0) : ns.load()) / 1000000000.0;
+	};
+
+	ImageLoadingStats stats;
+	stats.batches			= reset ? stats_batches.exchange(0) : stats_batches.load();
+	stats.images			= reset ? stats_images.exchange(0) : stats_images.load();
+	stats.decode_seconds	= to_seconds(stats_decode_ns);
+	stats.augment_seconds	= to_seconds(stats_augment_ns);
+	stats.pack_seconds		= to_seconds(stats_pack_ns);
+	stats.wait_seconds		= to_seconds(stats_wait_ns);
+
+	return stats;
+}
+
+
 void Darknet::stop_image_loading_threads()
 {
 	TAT(TATPARMS);
 
+	stop_image_prefetching();
+
 	if (not data_loading_threads.empty())
 	{
-		image_data_loading_threads_must_exit = true;
+		{
+			std::lock_guard lock(data_loading_mutex);
+			image_data_loading_threads_must_exit = true;
+		}
+		data_loading_start_cv.notify_all();
 
 		for (auto & t : data_loading_threads)
 		{
@@ -1186,7 +1437,9 @@ void Darknet::stop_image_loading_threads()
 			}
 		}
 		free(args_swap);
+		args_swap = NULL;
 		data_loading_threads.clear();
+		data_loading_per_thread_flag.clear();
 
 		image_data_loading_threads_must_exit = false;
 	}
@@ -30,7 +30,8 @@ namespace Darknet
 	void run_image_loading_control_thread(load_args args);
 
 
-	/** Stop and join the image loading threads started in @ref Darknet::run_image_loading_control_thread().
+	/** Stop and join the image loading threads started in @ref Darknet::run_image_loading_control_thread().  This also
+	 * calls @ref stop_image_prefetching().
 	 *
 	 * This was originally called @p free_load_threads() and used @p pthread, but has since been re-written to use C++11.
 	 *
@@ -39,6 +40,61 @@ namespace Darknet
 	void stop_image_loading_threads();
 
 
+	/** Load one batch of images using the permanent image loading threads, which are started the first time this is
+	 * called.  The @p args.n images are split between the @p args.threads loading threads.  This blocks until all the
+	 * images have been loaded.  The @p args.d pointer is ignored.
+	 *
+	 * @since 2026-10-17
+	 */
+	data load_batch_of_images(load_args args);
+
+
+	/** Start a thread which keeps up to @p depth batches of images loaded ahead of time, so training does not have to
+	 * wait for the next batch.  Each batch uses as much memory as the one being trained, so a large depth with large
+	 * mosaic batches needs a lot of RAM.  Any batches already waiting in the queue are discarded, so call this again
+	 * whenever @p args change, such as when the network is resized.
+	 *
+	 * @see @ref get_prefetched_images()
+	 * @see @ref stop_image_prefetching()
+	 *
+	 * @since 2026-10-17
+	 */
+	void start_image_prefetching(load_args args, const int depth);
+
+
+	/** Get the next batch of images loaded by the thread started with @ref start_image_prefetching().  Blocks until a
+	 * batch is available.  The caller owns the batch and must call @ref free_data().  An empty batch is returned if
+	 * %Darknet is exiting.
+	 *
+	 * @since 2026-10-17
+	 */
+	data get_prefetched_images();
+
+
+	/// Stop the thread started with @ref start_image_prefetching() and free the batches it loaded.  @since 2026-10-17
+	void stop_image_prefetching();
+
+
+	/** The time spent in each stage of loading the training images.  The decode and augment times are added up across
+	 * all of the loading threads, so they can be much larger than the wall-clock time.
+	 *
+	 * @since 2026-10-17
+	 */
+	struct ImageLoadingStats
+	{
+		size_t batches;			///< number of batches loaded
+		size_t images;			///< number of images decoded, which includes all 4 images of each mosaic
+		double decode_seconds;	///< reading and decoding the image files
+		double augment_seconds;	///< reading the annotations, augmentation, mixup and mosaic
+		double pack_seconds;	///< combining the images from each loading thread into one batch
+		double wait_seconds;	///< time training spent waiting in @ref get_prefetched_images()
+	};
+
+
+	/// Get the image loading statistics.  When @p reset is @p true, the statistics are set back to zero.  @since 2026-10-17
+	ImageLoadingStats get_image_loading_stats(const bool reset);
+
+
 	/** Run the permanent thread image loading loop.  This is started by @ref Darknet::run_image_loading_control_thread(),
 	 * and is stopped by @ref Darknet::stop_image_loading_threads().
 	 *
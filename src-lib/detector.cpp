@@ -50,6 +50,7 @@ void train_detector(const char * datacfg, const char * cfgfile, const char * wei
 	const char *train_images = option_find_str(options, "train", "data/train.txt");
 	const char *valid_images = option_find_str(options, "valid", train_images);
 	const char *backup_directory = option_find_str(options, "backup", "/backup/");
+	Darknet::use_dataset_shards(option_find_str_quiet(options, "shards", ""));
 
 	Darknet::Network net_map;
 	if (calc_map)
@@ -118,7 +119,6 @@ void train_detector(const char * datacfg, const char * cfgfile, const char * wei
 	int imgs = net.batch * net.subdivisions * ngpus;
 	printf("Learning Rate: %g, Momentum: %g, Decay: %g\n", net.learning_rate, net.momentum, net.decay);
 	data train;
-	data buffer;
 
 	Darknet::Layer l = net.layers[net.n - 1];
 	for (int k = 0; k < net.n; ++k)
@@ -158,6 +158,11 @@ void train_detector(const char * datacfg, const char * cfgfile, const char * wei
 	const int init_w = net.w;
 	const int init_h = net.h;
 	const int init_b = net.batch;
+
+	// optional cache of decoded images for datasets which fit in memory, e.g. "image_cache=8192" (MiB) in the .data file
+	const size_t image_cache_mib = std::max(0, option_find_int_quiet(options, "image_cache", 0));
+	const float image_cache_scale = option_find_float_quiet(options, "image_cache_scale", 0.0f);
+	Darknet::ImageCache::get().configure(image_cache_mib * 1024 * 1024, image_cache_scale > 0.0f ? std::lround(image_cache_scale * std::max(init_w, init_h)) : 0);
 	int iter_save, iter_save_last, iter_map;
 	iter_save = get_current_iteration(net);
 	iter_save_last = get_current_iteration(net);
@@ -180,7 +185,6 @@ void train_detector(const char * datacfg, const char * cfgfile, const char * wei
 	args.truth_size = l.truth_size;
 	net.num_boxes = args.num_boxes;
 	net.train_images_num = train_images_num;
-	args.d = &buffer;
 	args.type = DETECTION_DATA; // this is the only place in the code where this type is used
 	args.threads = 64;    // 16 or 64 -- see several lines below where this is set to 6 * GPUs
 
@@ -228,7 +232,9 @@ void train_detector(const char * datacfg, const char * cfgfile, const char * wei
 		printf("\n Tracking! batch = %d, subdiv = %d, time_steps = %d, mini_batch = %d \n", net.batch, net.subdivisions, net.time_steps, args.mini_batch);
 	}
 
-	std::thread load_thread = std::thread(Darknet::run_image_loading_control_thread, args);
+	// the number of batches which are loaded while the GPU is busy training
+	const int prefetch_batches = cfg_and_state.get("prefetchbatches", 2);
+	Darknet::start_image_prefetching(args, prefetch_batches);
 
 	int count = 0;
 
@@ -303,11 +309,8 @@ void train_detector(const char * datacfg, const char * cfgfile, const char * wei
 				printf("\n %d x %d \n", dim_w, dim_h);
 			}
 
-			load_thread.join();
-			train = buffer;
-			Darknet::free_data(train);
-
-			load_thread = std::thread(Darknet::run_image_loading_control_thread, args);
+			// the images which have already been loaded are the wrong size
+			Darknet::start_image_prefetching(args, prefetch_batches);
 
 			for (int k = 0; k < ngpus; ++k)
 			{
@@ -317,20 +320,42 @@ void train_detector(const char * datacfg, const char * cfgfile, const char * wei
 		} // random=1
 
 		double time = what_time_is_it_now();
-		load_thread.join();
-		train = buffer;
+		train = Darknet::get_prefetched_images();
+		if (train.X.rows == 0)
+		{
+			// nothing was loaded because we're exiting
+			break;
+		}
 		if (net.track)
 		{
 			net.sequential_subdivisions = get_current_seq_subdivisions(net);
-			args.threads = net.sequential_subdivisions * ngpus;
 			printf(" sequential_subdivisions = %d, sequence = %d \n", net.sequential_subdivisions, get_sequence_value(net));
+			if (args.threads != net.sequential_subdivisions * ngpus)
+			{
+				// the loading threads are created for a specific number of threads, so they must be re-created
+				args.threads = net.sequential_subdivisions * ngpus;
+				Darknet::stop_image_loading_threads();
+				Darknet::start_image_prefetching(args, prefetch_batches);
+			}
 		}
-		load_thread = std::thread(Darknet::run_image_loading_control_thread, args);
 
 		const double load_time = (what_time_is_it_now() - time);
 		if (cfg_and_state.is_verbose)
 		{
-			std::cout << "loaded " << args.n << " images in " << Darknet::format_time(load_time) << std::endl;
+			std::cout << "waited " << Darknet::format_time(load_time) << " for " << args.n << " images" << std::endl;
+
+			const auto stats = Darknet::get_image_loading_stats(true);
+			if (stats.batches > 0)
+			{
+				std::cout
+					<< "image loading: "	<< stats.batches << " batch" << (stats.batches == 1 ? "" : "es")
+					<< ", "					<< stats.images << " images"
+					<< ", decode="			<< Darknet::format_time(stats.decode_seconds)
+					<< ", augment="			<< Darknet::format_time(stats.augment_seconds)
+					<< ", pack="			<< Darknet::format_time(stats.pack_seconds)
+					<< ", wait="			<< Darknet::format_time(stats.wait_seconds)
+					<< std::endl;
+			}
 		}
 		if (load_time > 0.1 && avg_loss > 0.0f)
 		{
@@ -422,8 +447,15 @@ void train_detector(const char * datacfg, const char * cfgfile, const char * wei
 			<< ", " << Darknet::format_time(what_time_is_it_now() - time)
 			<< ", " << iteration * imgs
 			<< " images, time remaining="
-			<< Darknet::format_time_remaining(seconds_remaining)
-			<< std::endl;
+			<< Darknet::format_time_remaining(seconds_remaining);
+
+		if (Darknet::ImageCache::get().enabled())
+		{
+			// the hits and misses since the previous iteration
+			const auto cache = Darknet::ImageCache::get().stats(true);
+			std::cout << ", image cache=" << cache.hits << " hits/" << cache.misses << " misses";
+		}
+		std::cout << std::endl;
 
 		// This is where we decide if we have to do the mAP% calculations.
 		if (calc_map && (iteration >= next_map_calc || iteration == net.max_batches))
@@ -448,10 +480,7 @@ void train_detector(const char * datacfg, const char * cfgfile, const char * wei
 					args.n = imgs;
 					printf("\n %d x %d  (batch = %d) \n", init_w, init_h, init_b);
 				}
-				load_thread.join();
-				Darknet::free_data(train);
-				train = buffer;
-				load_thread = std::thread(Darknet::run_image_loading_control_thread, args);
+				Darknet::start_image_prefetching(args, prefetch_batches);
 
 				for (int k = 0; k < ngpus; ++k)
 				{
@@ -544,10 +573,8 @@ void train_detector(const char * datacfg, const char * cfgfile, const char * wei
 	cv::destroyAllWindows();
 
 	// free memory
-	load_thread.join();
-	Darknet::free_data(buffer);
-
 	Darknet::stop_image_loading_threads();
+	Darknet::ImageCache::get().configure(0, 0);
 
 	free((void*)base);
 	free(paths);
@@ -777,8 +804,7 @@ void validate_detector(char *datacfg, char *cfgfile, char *weightfile, const cha
 		load_weights(&net, weightfile);
 	}
 	//set_batch_network(&net, 1);
-	fuse_conv_batchnorm(net);
-	calculate_binary_weights(&net);
+	prepare_network_for_inference(net);
 	fprintf(stderr, "Learning Rate: %g, Momentum: %g, Decay: %g\n", net.learning_rate, net.momentum, net.decay);
 
 	Darknet::load_names(&net, option_find_str(options, "names", "unknown.names"));
@@ -1000,7 +1026,7 @@ void validate_detector_recall(char *datacfg, char *cfgfile, char *weightfile)
 		load_weights(&net, weightfile);
 	}
 	//set_batch_network(&net, 1);
-	fuse_conv_batchnorm(net);
+	prepare_network_for_inference(net);
 
 	//list *plist = get_paths("data/coco_val_5k.list");
 	list *options = read_data_cfg(datacfg);
@@ -1092,6 +1118,7 @@ float validate_detector_map(const char * datacfg, const char * cfgfile, const ch
 	list *options = read_data_cfg(datacfg);
 	const char *valid_images = option_find_str(options, "valid", nullptr);
 	const char *difficult_valid_images = option_find_str(options, "difficult", NULL);
+	Darknet::use_dataset_shards(option_find_str_quiet(options, "shards", ""));
 //	char *name_list = option_find_str(options, "names", nullptr);
 	FILE* reinforcement_fd = NULL;
 
@@ -1111,8 +1138,7 @@ float validate_detector_map(const char * datacfg, const char * cfgfile, const ch
 			load_weights(&net, weightfile);
 		}
 		//set_batch_network(&net, 1);
-		fuse_conv_batchnorm(net);
-		calculate_binary_weights(&net);
+		prepare_network_for_inference(net);
 		Darknet::load_names(&net, option_find_str(options, "names", "unknown.names"));
 	}
 
@@ -1691,6 +1717,208 @@ float validate_detector_map(const char * datacfg, const char * cfgfile, const ch
 	return mean_average_precision;
 }
 
+void quantize_detector(const char * datacfg, const char * cfgfile, const char * weightfile, const char * outfile, float thresh, float iou_thresh, int map_points, int letter_box)
+{
+	// Example command that calls this function:
+	//
+	//			darknet detector quantize cars.data cars.cfg cars_best.weights -out cars_int8.weights
+	//
+	// The calibration images are the "calibration" list from the .data file, or the "valid" list if there is none.
+
+	TAT(TATPARMS);
+
+	if (weightfile == nullptr or weightfile[0] == '\0')
+	{
+		darknet_fatal_error(DARKNET_LOC, "quantization requires a .weights file");
+	}
+
+	std::string output_filename;
+	if (outfile)
+	{
+		output_filename = outfile;
+	}
+	else
+	{
+		std::filesystem::path path(weightfile);
+		output_filename = (path.parent_path() / (path.stem().string() + "_int8.weights")).string();
+	}
+
+	list *options = read_data_cfg(datacfg);
+	const char *valid_images = option_find_str(options, "valid", nullptr);
+	const char *calibration_images = option_find_str(options, "calibration", valid_images);
+	if (calibration_images == nullptr)
+	{
+		darknet_fatal_error(DARKNET_LOC, "no calibration images (set \"calibration\" or \"valid\" in %s)", datacfg);
+	}
+
+	// no channels-last or Winograd since the calibration reads the planar output of each layer
+	Darknet::Network net = parse_network_cfg_custom(cfgfile, 1, 1); // set batch=1
+	load_weights(&net, weightfile);
+	fuse_conv_batchnorm(net);
+	calculate_binary_weights(&net);
+	if (net.letter_box)
+	{
+		letter_box = 1;
+	}
+
+	/* The outputs of the layers just before YOLO are the box coordinates and class logits.  Those stay in FP32 since
+	 * that is where quantization costs the most mAP.
+	 */
+	std::vector<bool> quantize(net.n, false);
+	for (int idx = 0; idx < net.n; ++idx)
+	{
+		const bool before_output = (idx + 1 == net.n or
+			net.layers[idx + 1].type == Darknet::ELayerType::YOLO or
+			net.layers[idx + 1].type == Darknet::ELayerType::GAUSSIAN_YOLO or
+			net.layers[idx + 1].type == Darknet::ELayerType::REGION);
+
+		quantize[idx] = (not before_output and can_quantize_convolutional_layer(net.layers[idx]));
+	}
+
+	list *plist = get_paths(calibration_images);
+	char **paths = (char **)list_to_array(plist);
+	if (plist->size == 0)
+	{
+		darknet_fatal_error(DARKNET_LOC, "no calibration images available (verify %s)", calibration_images);
+	}
+
+	std::cout << "Calibrating INT8 ranges using " << plist->size << " images from " << calibration_images << std::endl;
+
+	/* The range of each layer's input is the average of the per-image minimum and maximum.  This is less sensitive to
+	 * the occasional extreme value than the absolute minimum and maximum, which would waste most of the 7 bits.
+	 */
+	std::vector<double> sum_min(net.n, 0.0);
+	std::vector<double> sum_max(net.n, 0.0);
+	for (int i = 0; i < plist->size; ++i)
+	{
+		Darknet::Image im = Darknet::load_image(paths[i], 0, 0, net.c);
+		Darknet::Image sized = (letter_box ? Darknet::letterbox_image(im, net.w, net.h) : Darknet::resize_image(im, net.w, net.h));
+
+		network_predict(net, sized.data);
+
+		for (int idx = 0; idx < net.n; ++idx)
+		{
+			if (quantize[idx])
+			{
+				// the input of every layer is the output of the previous one
+				const float * input = (idx == 0 ? sized.data : net.layers[idx - 1].output);
+				const auto range = std::minmax_element(input, input + net.layers[idx].inputs);
+				sum_min[idx] += *range.first;
+				sum_max[idx] += *range.second;
+			}
+		}
+
+		Darknet::free_image(im);
+		Darknet::free_image(sized);
+
+		if ((i + 1) % 100 == 0)
+		{
+			std::cout << "\r" << (i + 1) << "/" << plist->size << std::flush;
+		}
+	}
+	std::cout << "\r" << plist->size << "/" << plist->size << std::endl;
+
+	int count = 0;
+	for (int idx = 0; idx < net.n; ++idx)
+	{
+		if (quantize[idx])
+		{
+			const float input_min = sum_min[idx] / plist->size;
+			const float input_max = sum_max[idx] / plist->size;
+			quantize_convolutional_layer(net.layers[idx], input_min, input_max);
+			count ++;
+
+			if (cfg_and_state.is_verbose)
+			{
+				std::cout << "layer #" << idx << ": input range " << input_min << " to " << input_max << std::endl;
+			}
+		}
+	}
+
+	std::cout << "Quantized " << count << " of " << net.n << " layers to INT8" << std::endl;
+
+	save_int8_weights(net, weightfile, output_filename.c_str());
+
+	free(paths);
+	free_list_contents(plist);
+	free_list(plist);
+	free_list_contents_kvp(options);
+	free_list(options);
+	free_network(net);
+
+	// compare the FP32 and INT8 networks on the validation images
+	const float map_fp32 = validate_detector_map(datacfg, cfgfile, weightfile, thresh, iou_thresh, map_points, letter_box, nullptr);
+	const float map_int8 = validate_detector_map(datacfg, cfgfile, output_filename.c_str(), thresh, iou_thresh, map_points, letter_box, nullptr);
+
+	std::cout
+		<< std::endl
+		<< "mAP@" << std::fixed << std::setprecision(2) << iou_thresh
+		<< ":  FP32=" << (100.0f * map_fp32) << "%"
+		<< ", INT8=" << (100.0f * map_int8) << "%"
+		<< ", change=" << (100.0f * (map_int8 - map_fp32)) << "%" << std::endl;
+
+	return;
+}
+
+
+void pack_detector_dataset(const char * datacfg)
+{
+	// Example command that calls this function:
+	//
+	//			darknet detector pack cars.data
+	//
+	// Each image list ("train" and "valid") is written to a shard file next to the list, such as cars_train.shard.
+
+	TAT(TATPARMS);
+
+	list *options = read_data_cfg(datacfg);
+	const char *train_images = option_find_str(options, "train", nullptr);
+	const char *valid_images = option_find_str(options, "valid", nullptr);
+
+	std::set<std::string> lists;
+	if (train_images) lists.insert(train_images);
+	if (valid_images) lists.insert(valid_images);
+	if (lists.empty())
+	{
+		darknet_fatal_error(DARKNET_LOC, "no \"train\" or \"valid\" image lists in %s", datacfg);
+	}
+
+	std::string shards;
+	for (const auto & list_filename : lists)
+	{
+		list *plist = get_paths(list_filename.c_str());
+		char **paths = (char **)list_to_array(plist);
+
+		Darknet::VStr image_filenames;
+		image_filenames.reserve(plist->size);
+		for (int i = 0; i < plist->size; ++i)
+		{
+			image_filenames.push_back(paths[i]);
+		}
+
+		free(paths);
+		free_list_contents(plist);
+		free_list(plist);
+
+		const std::filesystem::path shard_filename = std::filesystem::path(list_filename).replace_extension(".shard");
+		std::cout << "Packing " << image_filenames.size() << " images from " << list_filename << std::endl;
+		Darknet::DatasetShard::write(shard_filename, image_filenames);
+
+		if (not shards.empty())
+		{
+			shards += ", ";
+		}
+		shards += shard_filename.string();
+	}
+
+	std::cout << "Add this line to " << datacfg << " to use the packed images:" << std::endl << "shards = " << shards << std::endl;
+
+	free_list_contents_kvp(options);
+	free_list(options);
+
+	return;
+}
+
 typedef struct {
 	float w, h;
 } anchors_t;
@@ -1941,8 +2169,7 @@ void test_detector(const char *datacfg, const char *cfgfile, const char *weightf
 	}
 	if (net.letter_box) letter_box = 1;
 	net.benchmark_layers = benchmark_layers;
-	fuse_conv_batchnorm(net);
-	calculate_binary_weights(&net);
+	prepare_network_for_inference(net);
 
 	Darknet::load_names(&net, option_find_str(options, "names", "unknown.names"));
 
@@ -2198,6 +2425,8 @@ void run_detector(int argc, char **argv)
 	else if (cfg_and_state.function == "valid"		) { validate_detector(datacfg, cfg, weights, outfile); }
 	else if (cfg_and_state.function == "recall"		) { validate_detector_recall(datacfg, cfg, weights); }
 	else if (cfg_and_state.function == "map"		) { validate_detector_map(datacfg, cfg, weights, thresh, iou_thresh, map_points, letter_box, NULL); }
+	else if (cfg_and_state.function == "quantize"	) { quantize_detector(datacfg, cfg, weights, outfile, thresh, iou_thresh, map_points, letter_box); }
+	else if (cfg_and_state.function == "pack"		) { pack_detector_dataset(datacfg); }
 	else if (cfg_and_state.function == "calcanchors")
 	{
 		const int show				= cfg_and_state.is_set	("show"			) ? 1 : 0;
@@ -480,303 +480,350 @@ void resize_gaussian_yolo_layer(Darknet::Layer *l, int w, int h)
 }
 
 
-void forward_gaussian_yolo_layer(Darknet::Layer & l, Darknet::NetworkState state)
+/// Sums of the training statistics for one image, see @ref process_gaussian_yolo_image().
+struct gaussian_yolo_sums
+{
+	float avg_iou;
+	float recall;
+	float recall75;
+	float avg_cat;
+	float avg_obj;
+	float avg_anyobj;
+	int count;
+	int class_count;
+};
+
+
+/** Calculate the deltas for image @p b of the batch.  Each image only writes to its own part of @p l.delta, so the
+ * images can be processed at the same time.
+ */
+static void process_gaussian_yolo_image(const Darknet::Layer & l, const Darknet::NetworkState & state, const int b, gaussian_yolo_sums & sums)
 {
 	TAT(TATPARMS);
 
-	int i,j,b,t,n;
-	memcpy(l.output, state.input, l.outputs*l.batch*sizeof(float));
-
-#ifndef GPU
-	for (b = 0; b < l.batch; ++b)
+	int i, j, t, n;
+	float & avg_iou		= sums.avg_iou;
+	float & recall		= sums.recall;
+	float & recall75	= sums.recall75;
+	float & avg_cat		= sums.avg_cat;
+	float & avg_obj		= sums.avg_obj;
+	float & avg_anyobj	= sums.avg_anyobj;
+	int & count			= sums.count;
+	int & class_count	= sums.class_count;
+
+	for (j = 0; j < l.h; ++j)
 	{
-		for(n = 0; n < l.n; ++n)
+		for (i = 0; i < l.w; ++i)
 		{
-			// x : mu, sigma
-			int index = entry_gaussian_index(l, b, n*l.w*l.h, 0);
-			activate_array(l.output + index, 2*l.w*l.h, LOGISTIC);
-			scal_add_cpu(l.w*l.h, l.scale_x_y, -0.5*(l.scale_x_y - 1), l.output + index, 1);    // scale x
-			// y : mu, sigma
-			index = entry_gaussian_index(l, b, n*l.w*l.h, 2);
-			activate_array(l.output + index, 2*l.w*l.h, LOGISTIC);
-			scal_add_cpu(l.w*l.h, l.scale_x_y, -0.5*(l.scale_x_y - 1), l.output + index, 1);    // scale y
-			// w : sigma
-			index = entry_gaussian_index(l, b, n*l.w*l.h, 5);
-			activate_array(l.output + index, l.w*l.h, LOGISTIC);
-			// h : sigma
-			index = entry_gaussian_index(l, b, n*l.w*l.h, 7);
-			activate_array(l.output + index, l.w*l.h, LOGISTIC);
-			// objectness & class
-			index = entry_gaussian_index(l, b, n*l.w*l.h, 8);
-			activate_array(l.output + index, (1+l.classes)*l.w*l.h, LOGISTIC);
-		}
-	}
-#endif
-
-	memset(l.delta, 0, l.outputs * l.batch * sizeof(float));
-	if (!state.train) return;
-	float avg_iou = 0;
-	float recall = 0;
-	float recall75 = 0;
-	float avg_cat = 0;
-	float avg_obj = 0;
-	float avg_anyobj = 0;
-	int count = 0;
-	int class_count = 0;
-	*(l.cost) = 0;
-	for (b = 0; b < l.batch; ++b)
-	{
-		for (j = 0; j < l.h; ++j)
-		{
-			for (i = 0; i < l.w; ++i)
+			for (n = 0; n < l.n; ++n)
 			{
-				for (n = 0; n < l.n; ++n)
+				const int class_index = entry_gaussian_index(l, b, n*l.w*l.h + j*l.w + i, 9);
+				const int obj_index = entry_gaussian_index(l, b, n*l.w*l.h + j*l.w + i, 8);
+				const int box_index = entry_gaussian_index(l, b, n*l.w*l.h + j*l.w + i, 0);
+				const int stride = l.w*l.h;
+				Darknet::Box pred = get_gaussian_yolo_box(l.output, l.biases, l.mask[n], box_index, i, j, l.w, l.h, state.net.w, state.net.h, l.w*l.h, l.yolo_point);
+				float best_match_iou = 0;
+				int best_match_t = 0;
+				float best_iou = 0;
+				int best_t = 0;
+				for(t = 0; t < l.max_boxes; ++t)
 				{
-					const int class_index = entry_gaussian_index(l, b, n*l.w*l.h + j*l.w + i, 9);
-					const int obj_index = entry_gaussian_index(l, b, n*l.w*l.h + j*l.w + i, 8);
-					const int box_index = entry_gaussian_index(l, b, n*l.w*l.h + j*l.w + i, 0);
-					const int stride = l.w*l.h;
-					Darknet::Box pred = get_gaussian_yolo_box(l.output, l.biases, l.mask[n], box_index, i, j, l.w, l.h, state.net.w, state.net.h, l.w*l.h, l.yolo_point);
-					float best_match_iou = 0;
-					int best_match_t = 0;
-					float best_iou = 0;
-					int best_t = 0;
-					for(t = 0; t < l.max_boxes; ++t)
+					Darknet::Box truth = float_to_box_stride(state.truth + t*l.truth_size + b*l.truths, 1);
+					int class_id = state.truth[t*l.truth_size + b*l.truths + 4];
+					if (class_id >= l.classes)
 					{
-						Darknet::Box truth = float_to_box_stride(state.truth + t*l.truth_size + b*l.truths, 1);
-						int class_id = state.truth[t*l.truth_size + b*l.truths + 4];
-						if (class_id >= l.classes)
-						{
-							darknet_fatal_error(DARKNET_LOC, "invalid class ID #%d", class_id);
-						}
-
-						if(!truth.x)
-						{
-							break;
-						}
-
-						float objectness = l.output[obj_index];
-						int class_id_match = compare_gaussian_yolo_class(l.output, l.classes, class_index, l.w*l.h, objectness, class_id, 0.25f);
+						darknet_fatal_error(DARKNET_LOC, "invalid class ID #%d", class_id);
+					}
 
-						float iou = box_iou(pred, truth);
-						if (iou > best_match_iou && class_id_match == 1)
-						{
-							best_match_iou = iou;
-							best_match_t = t;
-						}
-						if (iou > best_iou)
-						{
-							best_iou = iou;
-							best_t = t;
-						}
+					if(!truth.x)
+					{
+						break;
 					}
 
-					avg_anyobj += l.output[obj_index];
-					l.delta[obj_index] = l.obj_normalizer * (0 - l.output[obj_index]);
-					if (best_match_iou > l.ignore_thresh)
+					float objectness = l.output[obj_index];
+					int class_id_match = compare_gaussian_yolo_class(l.output, l.classes, class_index, l.w*l.h, objectness, class_id, 0.25f);
+
+					float iou = box_iou(pred, truth);
+					if (iou > best_match_iou && class_id_match == 1)
 					{
-						const float iou_multiplier = best_match_iou*best_match_iou;// (best_match_iou - l.ignore_thresh) / (1.0 - l.ignore_thresh);
-						if (l.objectness_smooth)
-						{
-							l.delta[obj_index] = l.obj_normalizer * (iou_multiplier - l.output[obj_index]);
-
-							int class_id = state.truth[best_match_t*l.truth_size + b*l.truths + 4];
-							if (l.map)
-							{
-								class_id = l.map[class_id];
-							}
-							delta_gaussian_yolo_class(l.output, l.delta, class_index, class_id, l.classes, l.w*l.h, 0, l.label_smooth_eps, l.classes_multipliers, l.cls_normalizer);
-						}
-						else
-						{
-							l.delta[obj_index] = 0;
-						}
+						best_match_iou = iou;
+						best_match_t = t;
 					}
-					else if (state.net.adversarial)
+					if (iou > best_iou)
 					{
-						float scale = pred.w * pred.h;
-						if (scale > 0) scale = sqrt(scale);
-						l.delta[obj_index] = scale * l.obj_normalizer * (0 - l.output[obj_index]);
-						int cl_id;
-						for (cl_id = 0; cl_id < l.classes; ++cl_id)
-						{
-							if (l.output[class_index + stride*cl_id] * l.output[obj_index] > 0.25)
-							{
-								l.delta[class_index + stride*cl_id] = scale * (0 - l.output[class_index + stride*cl_id]);
-							}
-						}
+						best_iou = iou;
+						best_t = t;
 					}
-					if (best_iou > l.truth_thresh)
+				}
+
+				avg_anyobj += l.output[obj_index];
+				l.delta[obj_index] = l.obj_normalizer * (0 - l.output[obj_index]);
+				if (best_match_iou > l.ignore_thresh)
+				{
+					const float iou_multiplier = best_match_iou*best_match_iou;// (best_match_iou - l.ignore_thresh) / (1.0 - l.ignore_thresh);
+					if (l.objectness_smooth)
 					{
-						const float iou_multiplier = best_iou*best_iou;// (best_iou - l.truth_thresh) / (1.0 - l.truth_thresh);
-						if (l.objectness_smooth)
-						{
-							l.delta[obj_index] = l.obj_normalizer * (iou_multiplier - l.output[obj_index]);
-						}
-						else
-						{
-							l.delta[obj_index] = l.obj_normalizer * (1 - l.output[obj_index]);
-						}
-						//l.delta[obj_index] = l.obj_normalizer * (1 - l.output[obj_index]);
+						l.delta[obj_index] = l.obj_normalizer * (iou_multiplier - l.output[obj_index]);
 
-						int class_id = state.truth[best_t*l.truth_size + b*l.truths + 4];
+						int class_id = state.truth[best_match_t*l.truth_size + b*l.truths + 4];
 						if (l.map)
 						{
 							class_id = l.map[class_id];
 						}
 						delta_gaussian_yolo_class(l.output, l.delta, class_index, class_id, l.classes, l.w*l.h, 0, l.label_smooth_eps, l.classes_multipliers, l.cls_normalizer);
-						const float class_multiplier = (l.classes_multipliers) ? l.classes_multipliers[class_id] : 1.0f;
-						if (l.objectness_smooth)
+					}
+					else
+					{
+						l.delta[obj_index] = 0;
+					}
+				}
+				else if (state.net.adversarial)
+				{
+					float scale = pred.w * pred.h;
+					if (scale > 0) scale = sqrt(scale);
+					l.delta[obj_index] = scale * l.obj_normalizer * (0 - l.output[obj_index]);
+					int cl_id;
+					for (cl_id = 0; cl_id < l.classes; ++cl_id)
+					{
+						if (l.output[class_index + stride*cl_id] * l.output[obj_index] > 0.25)
 						{
-							l.delta[class_index + stride*class_id] = class_multiplier * (iou_multiplier - l.output[class_index + stride*class_id]);
+							l.delta[class_index + stride*cl_id] = scale * (0 - l.output[class_index + stride*cl_id]);
 						}
-						Darknet::Box truth = float_to_box_stride(state.truth + best_t*l.truth_size + b*l.truths, 1);
-						delta_gaussian_yolo_box(truth, l.output, l.biases, l.mask[n], box_index, i, j, l.w, l.h, state.net.w, state.net.h, l.delta, (2-truth.w*truth.h), l.w*l.h, l.iou_normalizer * class_multiplier, l.iou_loss, l.uc_normalizer, 1, l.yolo_point, l.max_delta);
 					}
 				}
+				if (best_iou > l.truth_thresh)
+				{
+					const float iou_multiplier = best_iou*best_iou;// (best_iou - l.truth_thresh) / (1.0 - l.truth_thresh);
+					if (l.objectness_smooth)
+					{
+						l.delta[obj_index] = l.obj_normalizer * (iou_multiplier - l.output[obj_index]);
+					}
+					else
+					{
+						l.delta[obj_index] = l.obj_normalizer * (1 - l.output[obj_index]);
+					}
+					//l.delta[obj_index] = l.obj_normalizer * (1 - l.output[obj_index]);
+
+					int class_id = state.truth[best_t*l.truth_size + b*l.truths + 4];
+					if (l.map)
+					{
+						class_id = l.map[class_id];
+					}
+					delta_gaussian_yolo_class(l.output, l.delta, class_index, class_id, l.classes, l.w*l.h, 0, l.label_smooth_eps, l.classes_multipliers, l.cls_normalizer);
+					const float class_multiplier = (l.classes_multipliers) ? l.classes_multipliers[class_id] : 1.0f;
+					if (l.objectness_smooth)
+					{
+						l.delta[class_index + stride*class_id] = class_multiplier * (iou_multiplier - l.output[class_index + stride*class_id]);
+					}
+					Darknet::Box truth = float_to_box_stride(state.truth + best_t*l.truth_size + b*l.truths, 1);
+					delta_gaussian_yolo_box(truth, l.output, l.biases, l.mask[n], box_index, i, j, l.w, l.h, state.net.w, state.net.h, l.delta, (2-truth.w*truth.h), l.w*l.h, l.iou_normalizer * class_multiplier, l.iou_loss, l.uc_normalizer, 1, l.yolo_point, l.max_delta);
+				}
 			}
 		}
-		for(t = 0; t < l.max_boxes; ++t)
+	}
+	for(t = 0; t < l.max_boxes; ++t)
+	{
+		Darknet::Box truth = float_to_box_stride(state.truth + t*l.truth_size + b*l.truths, 1);
+
+		if(!truth.x)
 		{
-			Darknet::Box truth = float_to_box_stride(state.truth + t*l.truth_size + b*l.truths, 1);
+			break;
+		}
 
-			if(!truth.x)
-			{
-				break;
-			}
+		float best_iou = 0;
+		int best_n = 0;
+		i = (truth.x * l.w);
+		j = (truth.y * l.h);
 
-			float best_iou = 0;
-			int best_n = 0;
-			i = (truth.x * l.w);
-			j = (truth.y * l.h);
+		if (l.yolo_point == YOLO_CENTER)
+		{
+		}
+		else if (l.yolo_point == YOLO_LEFT_TOP)
+		{
+			i = min_val_cmp(l.w-1, max_val_cmp(0, ((truth.x - truth.w / 2) * l.w)));
+			j = min_val_cmp(l.h-1, max_val_cmp(0, ((truth.y - truth.h / 2) * l.h)));
+		}
+		else if (l.yolo_point == YOLO_RIGHT_BOTTOM)
+		{
+			i = min_val_cmp(l.w-1, max_val_cmp(0, ((truth.x + truth.w / 2) * l.w)));
+			j = min_val_cmp(l.h-1, max_val_cmp(0, ((truth.y + truth.h / 2) * l.h)));
+		}
 
-			if (l.yolo_point == YOLO_CENTER)
-			{
-			}
-			else if (l.yolo_point == YOLO_LEFT_TOP)
-			{
-				i = min_val_cmp(l.w-1, max_val_cmp(0, ((truth.x - truth.w / 2) * l.w)));
-				j = min_val_cmp(l.h-1, max_val_cmp(0, ((truth.y - truth.h / 2) * l.h)));
-			}
-			else if (l.yolo_point == YOLO_RIGHT_BOTTOM)
+		Darknet::Box truth_shift = truth;
+		truth_shift.x = truth_shift.y = 0;
+		for(n = 0; n < l.total; ++n)
+		{
+			Darknet::Box pred = {0};
+			pred.w = l.biases[2*n]/ state.net.w;
+			pred.h = l.biases[2*n+1]/ state.net.h;
+			float iou = box_iou(pred, truth_shift);
+			if (iou > best_iou)
 			{
-				i = min_val_cmp(l.w-1, max_val_cmp(0, ((truth.x + truth.w / 2) * l.w)));
-				j = min_val_cmp(l.h-1, max_val_cmp(0, ((truth.y + truth.h / 2) * l.h)));
+				best_iou = iou;
+				best_n = n;
 			}
+		}
 
-			Darknet::Box truth_shift = truth;
-			truth_shift.x = truth_shift.y = 0;
-			for(n = 0; n < l.total; ++n)
+		int mask_n2 = int_index(l.mask, best_n, l.n);
+		if(mask_n2 >= 0)
+		{
+			int class_id = state.truth[t*l.truth_size + b*l.truths + 4];
+			if (l.map)
 			{
-				Darknet::Box pred = {0};
-				pred.w = l.biases[2*n]/ state.net.w;
-				pred.h = l.biases[2*n+1]/ state.net.h;
-				float iou = box_iou(pred, truth_shift);
-				if (iou > best_iou)
-				{
-					best_iou = iou;
-					best_n = n;
-				}
+				class_id = l.map[class_id];
 			}
 
-			int mask_n2 = int_index(l.mask, best_n, l.n);
-			if(mask_n2 >= 0)
-			{
-				int class_id = state.truth[t*l.truth_size + b*l.truths + 4];
-				if (l.map)
-				{
-					class_id = l.map[class_id];
-				}
-
-				int box_index = entry_gaussian_index(l, b, mask_n2*l.w*l.h + j*l.w + i, 0);
-				const float class_multiplier = (l.classes_multipliers) ? l.classes_multipliers[class_id] : 1.0f;
-				float iou = delta_gaussian_yolo_box(truth, l.output, l.biases, best_n, box_index, i, j, l.w, l.h, state.net.w, state.net.h, l.delta, (2-truth.w*truth.h), l.w*l.h, l.iou_normalizer * class_multiplier, l.iou_loss, l.uc_normalizer, 1, l.yolo_point, l.max_delta);
+			int box_index = entry_gaussian_index(l, b, mask_n2*l.w*l.h + j*l.w + i, 0);
+			const float class_multiplier = (l.classes_multipliers) ? l.classes_multipliers[class_id] : 1.0f;
+			float iou = delta_gaussian_yolo_box(truth, l.output, l.biases, best_n, box_index, i, j, l.w, l.h, state.net.w, state.net.h, l.delta, (2-truth.w*truth.h), l.w*l.h, l.iou_normalizer * class_multiplier, l.iou_loss, l.uc_normalizer, 1, l.yolo_point, l.max_delta);
 
-				int obj_index = entry_gaussian_index(l, b, mask_n2*l.w*l.h + j*l.w + i, 8);
-				avg_obj += l.output[obj_index];
-				l.delta[obj_index] = class_multiplier * l.obj_normalizer * (1 - l.output[obj_index]);
+			int obj_index = entry_gaussian_index(l, b, mask_n2*l.w*l.h + j*l.w + i, 8);
+			avg_obj += l.output[obj_index];
+			l.delta[obj_index] = class_multiplier * l.obj_normalizer * (1 - l.output[obj_index]);
 
-				int class_index = entry_gaussian_index(l, b, mask_n2*l.w*l.h + j*l.w + i, 9);
-				delta_gaussian_yolo_class(l.output, l.delta, class_index, class_id, l.classes, l.w*l.h, &avg_cat, l.label_smooth_eps, l.classes_multipliers, l.cls_normalizer);
+			int class_index = entry_gaussian_index(l, b, mask_n2*l.w*l.h + j*l.w + i, 9);
+			delta_gaussian_yolo_class(l.output, l.delta, class_index, class_id, l.classes, l.w*l.h, &avg_cat, l.label_smooth_eps, l.classes_multipliers, l.cls_normalizer);
 
-				++count;
-				++class_count;
-				if(iou > 0.5f)
-				{
-					recall += 1;
-				}
-				if(iou > 0.75f)
-				{
-					recall75 += 1;
-				}
-				avg_iou += iou;
+			++count;
+			++class_count;
+			if(iou > 0.5f)
+			{
+				recall += 1;
 			}
+			if(iou > 0.75f)
+			{
+				recall75 += 1;
+			}
+			avg_iou += iou;
+		}
 
 
-			// iou_thresh
-			for (n = 0; n < l.total; ++n)
+		// iou_thresh
+		for (n = 0; n < l.total; ++n)
+		{
+			int mask_n = int_index(l.mask, n, l.n);
+			if (mask_n >= 0 && n != best_n && l.iou_thresh < 1.0f)
 			{
-				int mask_n = int_index(l.mask, n, l.n);
-				if (mask_n >= 0 && n != best_n && l.iou_thresh < 1.0f)
-				{
-					Darknet::Box pred = { 0 };
-					pred.w = l.biases[2 * n] / state.net.w;
-					pred.h = l.biases[2 * n + 1] / state.net.h;
-					float box_iou = box_iou_kind(pred, truth_shift, l.iou_thresh_kind); // IOU, GIOU, MSE, DIOU, CIOU
-					// iou, n
+				Darknet::Box pred = { 0 };
+				pred.w = l.biases[2 * n] / state.net.w;
+				pred.h = l.biases[2 * n + 1] / state.net.h;
+				float box_iou = box_iou_kind(pred, truth_shift, l.iou_thresh_kind); // IOU, GIOU, MSE, DIOU, CIOU
+				// iou, n
 
-					if (box_iou > l.iou_thresh)
+				if (box_iou > l.iou_thresh)
+				{
+					int class_id = state.truth[t*l.truth_size + b*l.truths + 4];
+					if (l.map)
 					{
-						int class_id = state.truth[t*l.truth_size + b*l.truths + 4];
-						if (l.map)
-						{
-							class_id = l.map[class_id];
-						}
+						class_id = l.map[class_id];
+					}
 
-						int box_index = entry_gaussian_index(l, b, mask_n*l.w*l.h + j*l.w + i, 0);
-						const float class_multiplier = (l.classes_multipliers) ? l.classes_multipliers[class_id] : 1.0f;
-						float iou = delta_gaussian_yolo_box(truth, l.output, l.biases, n, box_index, i, j, l.w, l.h, state.net.w, state.net.h, l.delta, (2 - truth.w*truth.h), l.w*l.h, l.iou_normalizer * class_multiplier, l.iou_loss, l.uc_normalizer, 1, l.yolo_point, l.max_delta);
+					int box_index = entry_gaussian_index(l, b, mask_n*l.w*l.h + j*l.w + i, 0);
+					const float class_multiplier = (l.classes_multipliers) ? l.classes_multipliers[class_id] : 1.0f;
+					float iou = delta_gaussian_yolo_box(truth, l.output, l.biases, n, box_index, i, j, l.w, l.h, state.net.w, state.net.h, l.delta, (2 - truth.w*truth.h), l.w*l.h, l.iou_normalizer * class_multiplier, l.iou_loss, l.uc_normalizer, 1, l.yolo_point, l.max_delta);
 
-						int obj_index = entry_gaussian_index(l, b, mask_n*l.w*l.h + j*l.w + i, 8);
-						avg_obj += l.output[obj_index];
-						l.delta[obj_index] = class_multiplier * l.obj_normalizer * (1 - l.output[obj_index]);
+					int obj_index = entry_gaussian_index(l, b, mask_n*l.w*l.h + j*l.w + i, 8);
+					avg_obj += l.output[obj_index];
+					l.delta[obj_index] = class_multiplier * l.obj_normalizer * (1 - l.output[obj_index]);
 
-						int class_index = entry_gaussian_index(l, b, mask_n*l.w*l.h + j*l.w + i, 9);
-						delta_gaussian_yolo_class(l.output, l.delta, class_index, class_id, l.classes, l.w*l.h, &avg_cat, l.label_smooth_eps, l.classes_multipliers, l.cls_normalizer);
+					int class_index = entry_gaussian_index(l, b, mask_n*l.w*l.h + j*l.w + i, 9);
+					delta_gaussian_yolo_class(l.output, l.delta, class_index, class_id, l.classes, l.w*l.h, &avg_cat, l.label_smooth_eps, l.classes_multipliers, l.cls_normalizer);
 
-						++count;
-						++class_count;
-						if (iou > 0.5f)
-						{
-							recall += 1;
-						}
-						if (iou > 0.75f)
-						{
-							recall75 += 1;
-						}
-						avg_iou += iou;
+					++count;
+					++class_count;
+					if (iou > 0.5f)
+					{
+						recall += 1;
+					}
+					if (iou > 0.75f)
+					{
+						recall75 += 1;
 					}
+					avg_iou += iou;
 				}
 			}
 		}
+	}
 
-		// averages the deltas obtained by the function: delta_yolo_box()_accumulate
-		for (j = 0; j < l.h; ++j)
+	// averages the deltas obtained by the function: delta_yolo_box()_accumulate
+	for (j = 0; j < l.h; ++j)
+	{
+		for (i = 0; i < l.w; ++i)
 		{
-			for (i = 0; i < l.w; ++i)
+			for (n = 0; n < l.n; ++n)
 			{
-				for (n = 0; n < l.n; ++n)
-				{
-					int box_index = entry_gaussian_index(l, b, n*l.w*l.h + j*l.w + i, 0);
-					int class_index = entry_gaussian_index(l, b, n*l.w*l.h + j*l.w + i, 9);
-					const int stride = l.w*l.h;
+				int box_index = entry_gaussian_index(l, b, n*l.w*l.h + j*l.w + i, 0);
+				int class_index = entry_gaussian_index(l, b, n*l.w*l.h + j*l.w + i, 9);
+				const int stride = l.w*l.h;
 
-					averages_gaussian_yolo_deltas(class_index, box_index, stride, l.classes, l.delta);
-				}
+				averages_gaussian_yolo_deltas(class_index, box_index, stride, l.classes, l.delta);
 			}
 		}
 	}
+}
 
+void forward_gaussian_yolo_layer(Darknet::Layer & l, Darknet::NetworkState state)
+{
+	TAT(TATPARMS);
+
+	int i,j,b,n;
+	memcpy(l.output, state.input, l.outputs*l.batch*sizeof(float));
+
+#ifndef GPU
+	for (b = 0; b < l.batch; ++b)
+	{
+		for(n = 0; n < l.n; ++n)
+		{
+			// x : mu, sigma
+			int index = entry_gaussian_index(l, b, n*l.w*l.h, 0);
+			activate_array(l.output + index, 2*l.w*l.h, LOGISTIC);
+			scal_add_cpu(l.w*l.h, l.scale_x_y, -0.5*(l.scale_x_y - 1), l.output + index, 1);    // scale x
+			// y : mu, sigma
+			index = entry_gaussian_index(l, b, n*l.w*l.h, 2);
+			activate_array(l.output + index, 2*l.w*l.h, LOGISTIC);
+			scal_add_cpu(l.w*l.h, l.scale_x_y, -0.5*(l.scale_x_y - 1), l.output + index, 1);    // scale y
+			// w : sigma
+			index = entry_gaussian_index(l, b, n*l.w*l.h, 5);
+			activate_array(l.output + index, l.w*l.h, LOGISTIC);
+			// h : sigma
+			index = entry_gaussian_index(l, b, n*l.w*l.h, 7);
+			activate_array(l.output + index, l.w*l.h, LOGISTIC);
+			// objectness & class
+			index = entry_gaussian_index(l, b, n*l.w*l.h, 8);
+			activate_array(l.output + index, (1+l.classes)*l.w*l.h, LOGISTIC);
+		}
+	}
+#endif
+
+	memset(l.delta, 0, l.outputs * l.batch * sizeof(float));
+	if (!state.train) return;
+	float avg_iou = 0;
+	float recall = 0;
+	float recall75 = 0;
+	float avg_cat = 0;
+	float avg_obj = 0;
+	float avg_anyobj = 0;
+	int count = 0;
+	int class_count = 0;
+	*(l.cost) = 0;
+
+	std::vector<gaussian_yolo_sums> image_sums(l.batch, gaussian_yolo_sums{});
+	Darknet::WorkerPool::get().run(l.batch, [&](const size_t image)
+	{
+		process_gaussian_yolo_image(l, state, static_cast<int>(image), image_sums[image]);
+	});
+
+	for (const auto & sums : image_sums)
+	{
+		avg_iou		+= sums.avg_iou;
+		recall		+= sums.recall;
+		recall75	+= sums.recall75;
+		avg_cat		+= sums.avg_cat;
+		avg_obj		+= sums.avg_obj;
+		avg_anyobj	+= sums.avg_anyobj;
+		count		+= sums.count;
+		class_count	+= sums.class_count;
+	}
 
 	// calculate: Classification-loss, IoU-loss and Uncertainty-loss
 	const int stride = l.w*l.h;
@@ -17,6 +17,180 @@
 #include <omp.h>
 #endif
 
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#ifdef DARKNET_USE_CBLAS
+#ifdef DARKNET_USE_MKL_CBLAS
+#include <mkl_cblas.h>
+#else
+#include <cblas.h>
+#endif
+#endif
+
+// defined below in either the AVX or the generic section of this file
+void gemm_nn_fast(int M, int N, int K, float ALPHA, float *A, int lda, float *B, int ldb, float *C, int ldc);
+void gemm_nn_packed_half(int M, int N, int K, const uint16_t *A, int lda, bool bf16, float *B, int ldb, float *C, int ldc, const Gemm_Epilogue & epilogue);
+bool fp16_to_float_f16c(const uint16_t *src, float *dst, size_t n);
+bool float_to_fp16_f16c(const float *src, uint16_t *dst, size_t n);
+
+namespace
+{
+	/** Apply the bias and activation of @p epilogue to a block of C which starts at row @p first_row and column
+	 * @p first_col.  Only element-wise activations can be used here, not the ones which normalize across channels.
+	 */
+	static inline void apply_gemm_epilogue(const int rows, const int cols, const int first_row, const int first_col, float * C, const int ldc, const Gemm_Epilogue & epilogue)
+	{
+		TAT_COMMENT(TATPARMS, "hot loop");
+
+		for (int i = 0; i < rows; ++i)
+		{
+			float * c = C + static_cast<size_t>(i) * ldc;
+
+			if (epilogue.bias and epilogue.bias_per_column)
+			{
+				const float * bias = epilogue.bias + first_col;
+				for (int j = 0; j < cols; ++j)
+				{
+					c[j] += bias[j];
+				}
+			}
+			else if (epilogue.bias)
+			{
+				const float bias = epilogue.bias[first_row + i];
+				for (int j = 0; j < cols; ++j)
+				{
+					c[j] += bias;
+				}
+			}
+
+			switch (epilogue.activation)
+			{
+				case LINEAR:
+				{
+					break;
+				}
+				case LEAKY:
+				{
+					for (int j = 0; j < cols; ++j)
+					{
+						c[j] = (c[j] > 0.0f) ? c[j] : 0.1f * c[j];
+					}
+					break;
+				}
+				case RELU:
+				{
+					for (int j = 0; j < cols; ++j)
+					{
+						c[j] = (c[j] > 0.0f) ? c[j] : 0.0f;
+					}
+					break;
+				}
+				case MISH:
+				{
+					for (int j = 0; j < cols; ++j)
+					{
+						c[j] = c[j] * tanh_activate(softplus_activate(c[j], 20.0f));
+					}
+					break;
+				}
+				case SWISH:
+				{
+					for (int j = 0; j < cols; ++j)
+					{
+						c[j] = c[j] * logistic_activate(c[j]);
+					}
+					break;
+				}
+				case HARD_MISH:
+				{
+					for (int j = 0; j < cols; ++j)
+					{
+						const float x = c[j];
+						c[j] = (x > 0.0f) ? x : (x > -2.0f) ? x * x / 2.0f + x : 0.0f;
+					}
+					break;
+				}
+				default:
+				{
+					for (int j = 0; j < cols; ++j)
+					{
+						c[j] = activate(c[j], epilogue.activation);
+					}
+					break;
+				}
+			}
+		}
+	}
+
+	/** Signature of the 8-bit dot product kernels used by @ref gemm_int8_fused():  the 4 x 2 dot products between 4 rows
+	 * of signed 8-bit values in @p a and 2 rows of unsigned 7-bit values in @p b, each @p K bytes long, are written to
+	 * @p c as 32-bit integers.  K is a multiple of 32.
+	 */
+	typedef void (*int8_dot_kernel)(const int K, const int8_t * const * a, const uint8_t * const * b, int32_t * c);
+
+	/// Portable version of the 8-bit dot product kernel.
+	static void int8_dot_generic_4x2(const int K, const int8_t * const * a, const uint8_t * const * b, int32_t * c)
+	{
+		for (int r = 0; r < 4; ++r)
+		{
+			for (int col = 0; col < 2; ++col)
+			{
+				int32_t sum = 0;
+				for (int k = 0; k < K; ++k)
+				{
+					sum += static_cast<int32_t>(a[r][k]) * static_cast<int32_t>(b[col][k]);
+				}
+				c[r * 2 + col] = sum;
+			}
+		}
+	}
+
+	/// Fallback for FP16 and BF16 weights when the packed kernels cannot be used:  A is converted to floats first.
+	static inline void gemm_nn_half_with_epilogue(int M, int N, int K, const uint16_t * A, int lda, bool bf16, float *B, int ldb, float *C, int ldc, const Gemm_Epilogue & epilogue);
+
+	/// Fallback used when the packed kernels cannot be used:  a plain GEMM followed by a separate epilogue pass.
+	static inline void gemm_nn_fast_with_epilogue(int M, int N, int K, float ALPHA, float *A, int lda, float *B, int ldb, float *C, int ldc, const Gemm_Epilogue * epilogue)
+	{
+		TAT(TATPARMS);
+
+		if (epilogue and epilogue->overwrite)
+		{
+			for (int i = 0; i < M; ++i)
+			{
+				std::fill_n(C + static_cast<size_t>(i) * ldc, N, 0.0f);
+			}
+		}
+
+		gemm_nn_fast(M, N, K, ALPHA, A, lda, B, ldb, C, ldc);
+
+		if (epilogue)
+		{
+			#pragma omp parallel for
+			for (int i = 0; i < M; ++i)
+			{
+				apply_gemm_epilogue(1, N, i, 0, C + static_cast<size_t>(i) * ldc, ldc, *epilogue);
+			}
+		}
+	}
+
+	static inline void gemm_nn_half_with_epilogue(int M, int N, int K, const uint16_t * A, int lda, bool bf16, float *B, int ldb, float *C, int ldc, const Gemm_Epilogue & epilogue)
+	{
+		TAT(TATPARMS);
+
+		static thread_local std::vector<float> weights;
+		weights.resize(static_cast<size_t>(M) * K);
+		for (int i = 0; i < M; ++i)
+		{
+			half_to_float(A + static_cast<size_t>(i) * lda, weights.data() + static_cast<size_t>(i) * K, K, bf16);
+		}
+
+		gemm_nn_fast_with_epilogue(M, N, K, 1.0f, weights.data(), K, B, ldb, C, ldc, &epilogue);
+	}
+}
+
 #if defined(_MSC_VER)
 #if defined(_M_ARM) || defined(_M_ARM64)
 static inline uint32_t popcnt(uint32_t v)
@@ -494,7 +668,7 @@ static int HW_ABM;      // Advanced Bit Manipulation
 static int HW_SSE, HW_SSE2, HW_SSE3, HW_SSSE3, HW_SSE41, HW_SSE42, HW_SSE4a, HW_AES, HW_SHA;
 
 //  SIMD: 256-bit
-static int HW_AVX, HW_XOP, HW_FMA3, HW_FMA4, HW_AVX2;
+static int HW_AVX, HW_XOP, HW_FMA3, HW_FMA4, HW_AVX2, HW_F16C;
 
 //  SIMD: 512-bit
 static int HW_AVX512F;    //  AVX512 Foundation
@@ -506,6 +680,7 @@ static int HW_AVX512BW;   //  AVX512 Byte + Word
 static int HW_AVX512DQ;   //  AVX512 Doubleword + Quadword
 static int HW_AVX512IFMA; //  AVX512 Integer 52-bit Fused Multiply-Add
 static int HW_AVX512VBMI; //  AVX512 Vector Byte Manipulation Instructions
+static int HW_AVX512VNNI; //  AVX512 Vector Neural Network Instructions
 
 // https://stackoverflow.com/questions/6121792/how-to-check-if-a-cpu-supports-the-sse3-instruction-set
 void check_cpu_features(void)
@@ -534,6 +709,7 @@ void check_cpu_features(void)
 
 		HW_AVX = (info[2] & ((uint32_t)1 << 28)) != 0;
 		HW_FMA3 = (info[2] & ((uint32_t)1 << 12)) != 0;
+		HW_F16C = (info[2] & ((uint32_t)1 << 29)) != 0;
 
 		HW_RDRAND = (info[2] & ((uint32_t)1 << 30)) != 0;
 	}
@@ -556,6 +732,7 @@ void check_cpu_features(void)
 		HW_AVX512DQ = (info[1] & ((uint32_t)1 << 17)) != 0;
 		HW_AVX512IFMA = (info[1] & ((uint32_t)1 << 21)) != 0;
 		HW_AVX512VBMI = (info[2] & ((uint32_t)1 << 1)) != 0;
+		HW_AVX512VNNI = (info[2] & ((uint32_t)1 << 11)) != 0;
 	}
 	if (nExIds >= 0x80000001) {
 		cpuid(info, 0x80000001);
@@ -590,6 +767,76 @@ int is_avx()
 	return result;
 }
 
+int is_avx512()
+{
+	TAT(TATPARMS);
+
+	static int result = -1;
+
+	if (result == -1)
+	{
+		check_cpu_features();
+
+		// the CPU flag is not enough, the OS must also save the upper halves of the ZMM registers on context switch
+		int os_support = 0;
+		int info[4];
+		cpuid(info, 0x00000001);
+		const bool osxsave = (info[2] & ((uint32_t)1 << 27)) != 0;
+		if (osxsave)
+		{
+#ifdef _WIN32
+			const uint64_t xcr0 = _xgetbv(0);
+#else
+			uint32_t eax = 0;
+			uint32_t edx = 0;
+			__asm__ volatile ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+			const uint64_t xcr0 = ((uint64_t)edx << 32) | eax;
+#endif
+			os_support = ((xcr0 & 0xE6) == 0xE6);
+		}
+
+		result = HW_AVX512F && HW_FMA3 && os_support;
+		if (result == 1)
+		{
+			std::cout << "AVX-512 detected." << std::endl;
+		}
+	}
+
+	return result;
+}
+
+int is_f16c()
+{
+	TAT(TATPARMS);
+
+	static int result = -1;
+
+	if (result == -1)
+	{
+		result = is_avx() && HW_F16C;
+	}
+
+	return result;
+}
+
+int is_avx512_vnni()
+{
+	TAT(TATPARMS);
+
+	static int result = -1;
+
+	if (result == -1)
+	{
+		result = is_avx512() && HW_AVX512VNNI && HW_AVX512VL && HW_AVX512BW;
+		if (result == 1)
+		{
+			std::cout << "AVX-512 VNNI detected." << std::endl;
+		}
+	}
+
+	return result;
+}
+
 int is_fma_avx2()
 {
 	TAT(TATPARMS);
@@ -813,6 +1060,579 @@ void gemm_nn_fast(int M, int N, int K, float ALPHA,
 
 
 
+#if defined(__GNUC__)
+#define DARKNET_TARGET_AVX2_FMA	__attribute__((target("avx2,fma")))
+#define DARKNET_TARGET_AVX512	__attribute__((target("avx512f,fma")))
+#define DARKNET_TARGET_AVX512_VNNI	__attribute__((target("avx512f,avx512vl,avx512bw,avx512vnni")))
+#define DARKNET_TARGET_F16C	__attribute__((target("avx,f16c")))
+#else
+#define DARKNET_TARGET_AVX2_FMA
+#define DARKNET_TARGET_AVX512
+#define DARKNET_TARGET_AVX512_VNNI
+#define DARKNET_TARGET_F16C
+#endif
+
+namespace
+{
+	/* Blocking used by gemm_nn_packed(), in the style of GotoBLAS/BLIS.  A panel of B which is KC x NR floats is sized
+	 * to stay in L1, a block of A which is MC x KC floats is sized to stay in L2, and NC bounds the amount of B which
+	 * is packed at once.  MC must be a multiple of MR, and NC a multiple of every NR.
+	 */
+	constexpr int GEMM_MR = 6;
+	constexpr int GEMM_KC = 256;
+	constexpr int GEMM_MC = 144;
+	constexpr int GEMM_NC = 4096;
+
+	/** Signature of the register-tiled micro-kernels:  C[MR x NR] += packed A[MR x kc] * packed B[kc x NR].  When
+	 * @p accumulate is @p false the tile of C is overwritten instead, so it does not need to be initialized.
+	 */
+	typedef void (*sgemm_micro_kernel)(const int kc, const float * a, const float * b, float * c, const int ldc, const bool accumulate);
+
+	/// 6x16 micro-kernel using 12 of the 16 YMM registers as accumulators.
+	DARKNET_TARGET_AVX2_FMA
+	static void sgemm_kernel_avx2_6x16(const int kc, const float * a, const float * b, float * c, const int ldc, const bool accumulate)
+	{
+		TAT(TATPARMS);
+
+		__m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+		__m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+		__m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+		__m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+		__m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+		__m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+
+		for (int p = 0; p < kc; ++p)
+		{
+			const __m256 b0 = _mm256_loadu_ps(b);
+			const __m256 b1 = _mm256_loadu_ps(b + 8);
+			__m256 ai;
+
+			ai = _mm256_broadcast_ss(a + 0);	c00 = _mm256_fmadd_ps(ai, b0, c00);	c01 = _mm256_fmadd_ps(ai, b1, c01);
+			ai = _mm256_broadcast_ss(a + 1);	c10 = _mm256_fmadd_ps(ai, b0, c10);	c11 = _mm256_fmadd_ps(ai, b1, c11);
+			ai = _mm256_broadcast_ss(a + 2);	c20 = _mm256_fmadd_ps(ai, b0, c20);	c21 = _mm256_fmadd_ps(ai, b1, c21);
+			ai = _mm256_broadcast_ss(a + 3);	c30 = _mm256_fmadd_ps(ai, b0, c30);	c31 = _mm256_fmadd_ps(ai, b1, c31);
+			ai = _mm256_broadcast_ss(a + 4);	c40 = _mm256_fmadd_ps(ai, b0, c40);	c41 = _mm256_fmadd_ps(ai, b1, c41);
+			ai = _mm256_broadcast_ss(a + 5);	c50 = _mm256_fmadd_ps(ai, b0, c50);	c51 = _mm256_fmadd_ps(ai, b1, c51);
+
+			a += GEMM_MR;
+			b += 16;
+		}
+
+		if (accumulate)
+		{
+			float * r;
+			r = c + 0 * ldc;	_mm256_storeu_ps(r, _mm256_add_ps(_mm256_loadu_ps(r), c00));	_mm256_storeu_ps(r + 8, _mm256_add_ps(_mm256_loadu_ps(r + 8), c01));
+			r = c + 1 * ldc;	_mm256_storeu_ps(r, _mm256_add_ps(_mm256_loadu_ps(r), c10));	_mm256_storeu_ps(r + 8, _mm256_add_ps(_mm256_loadu_ps(r + 8), c11));
+			r = c + 2 * ldc;	_mm256_storeu_ps(r, _mm256_add_ps(_mm256_loadu_ps(r), c20));	_mm256_storeu_ps(r + 8, _mm256_add_ps(_mm256_loadu_ps(r + 8), c21));
+			r = c + 3 * ldc;	_mm256_storeu_ps(r, _mm256_add_ps(_mm256_loadu_ps(r), c30));	_mm256_storeu_ps(r + 8, _mm256_add_ps(_mm256_loadu_ps(r + 8), c31));
+			r = c + 4 * ldc;	_mm256_storeu_ps(r, _mm256_add_ps(_mm256_loadu_ps(r), c40));	_mm256_storeu_ps(r + 8, _mm256_add_ps(_mm256_loadu_ps(r + 8), c41));
+			r = c + 5 * ldc;	_mm256_storeu_ps(r, _mm256_add_ps(_mm256_loadu_ps(r), c50));	_mm256_storeu_ps(r + 8, _mm256_add_ps(_mm256_loadu_ps(r + 8), c51));
+		}
+		else
+		{
+			float * r;
+			r = c + 0 * ldc;	_mm256_storeu_ps(r, c00);	_mm256_storeu_ps(r + 8, c01);
+			r = c + 1 * ldc;	_mm256_storeu_ps(r, c10);	_mm256_storeu_ps(r + 8, c11);
+			r = c + 2 * ldc;	_mm256_storeu_ps(r, c20);	_mm256_storeu_ps(r + 8, c21);
+			r = c + 3 * ldc;	_mm256_storeu_ps(r, c30);	_mm256_storeu_ps(r + 8, c31);
+			r = c + 4 * ldc;	_mm256_storeu_ps(r, c40);	_mm256_storeu_ps(r + 8, c41);
+			r = c + 5 * ldc;	_mm256_storeu_ps(r, c50);	_mm256_storeu_ps(r + 8, c51);
+		}
+	}
+
+	/// 6x32 micro-kernel using 12 of the 32 ZMM registers as accumulators.
+	DARKNET_TARGET_AVX512
+	static void sgemm_kernel_avx512_6x32(const int kc, const float * a, const float * b, float * c, const int ldc, const bool accumulate)
+	{
+		TAT(TATPARMS);
+
+		__m512 c00 = _mm512_setzero_ps(), c01 = _mm512_setzero_ps();
+		__m512 c10 = _mm512_setzero_ps(), c11 = _mm512_setzero_ps();
+		__m512 c20 = _mm512_setzero_ps(), c21 = _mm512_setzero_ps();
+		__m512 c30 = _mm512_setzero_ps(), c31 = _mm512_setzero_ps();
+		__m512 c40 = _mm512_setzero_ps(), c41 = _mm512_setzero_ps();
+		__m512 c50 = _mm512_setzero_ps(), c51 = _mm512_setzero_ps();
+
+		for (int p = 0; p < kc; ++p)
+		{
+			const __m512 b0 = _mm512_loadu_ps(b);
+			const __m512 b1 = _mm512_loadu_ps(b + 16);
+			__m512 ai;
+
+			ai = _mm512_set1_ps(a[0]);	c00 = _mm512_fmadd_ps(ai, b0, c00);	c01 = _mm512_fmadd_ps(ai, b1, c01);
+			ai = _mm512_set1_ps(a[1]);	c10 = _mm512_fmadd_ps(ai, b0, c10);	c11 = _mm512_fmadd_ps(ai, b1, c11);
+			ai = _mm512_set1_ps(a[2]);	c20 = _mm512_fmadd_ps(ai, b0, c20);	c21 = _mm512_fmadd_ps(ai, b1, c21);
+			ai = _mm512_set1_ps(a[3]);	c30 = _mm512_fmadd_ps(ai, b0, c30);	c31 = _mm512_fmadd_ps(ai, b1, c31);
+			ai = _mm512_set1_ps(a[4]);	c40 = _mm512_fmadd_ps(ai, b0, c40);	c41 = _mm512_fmadd_ps(ai, b1, c41);
+			ai = _mm512_set1_ps(a[5]);	c50 = _mm512_fmadd_ps(ai, b0, c50);	c51 = _mm512_fmadd_ps(ai, b1, c51);
+
+			a += GEMM_MR;
+			b += 32;
+		}
+
+		if (accumulate)
+		{
+			float * r;
+			r = c + 0 * ldc;	_mm512_storeu_ps(r, _mm512_add_ps(_mm512_loadu_ps(r), c00));	_mm512_storeu_ps(r + 16, _mm512_add_ps(_mm512_loadu_ps(r + 16), c01));
+			r = c + 1 * ldc;	_mm512_storeu_ps(r, _mm512_add_ps(_mm512_loadu_ps(r), c10));	_mm512_storeu_ps(r + 16, _mm512_add_ps(_mm512_loadu_ps(r + 16), c11));
+			r = c + 2 * ldc;	_mm512_storeu_ps(r, _mm512_add_ps(_mm512_loadu_ps(r), c20));	_mm512_storeu_ps(r + 16, _mm512_add_ps(_mm512_loadu_ps(r + 16), c21));
+			r = c + 3 * ldc;	_mm512_storeu_ps(r, _mm512_add_ps(_mm512_loadu_ps(r), c30));	_mm512_storeu_ps(r + 16, _mm512_add_ps(_mm512_loadu_ps(r + 16), c31));
+			r = c + 4 * ldc;	_mm512_storeu_ps(r, _mm512_add_ps(_mm512_loadu_ps(r), c40));	_mm512_storeu_ps(r + 16, _mm512_add_ps(_mm512_loadu_ps(r + 16), c41));
+			r = c + 5 * ldc;	_mm512_storeu_ps(r, _mm512_add_ps(_mm512_loadu_ps(r), c50));	_mm512_storeu_ps(r + 16, _mm512_add_ps(_mm512_loadu_ps(r + 16), c51));
+		}
+		else
+		{
+			float * r;
+			r = c + 0 * ldc;	_mm512_storeu_ps(r, c00);	_mm512_storeu_ps(r + 16, c01);
+			r = c + 1 * ldc;	_mm512_storeu_ps(r, c10);	_mm512_storeu_ps(r + 16, c11);
+			r = c + 2 * ldc;	_mm512_storeu_ps(r, c20);	_mm512_storeu_ps(r + 16, c21);
+			r = c + 3 * ldc;	_mm512_storeu_ps(r, c30);	_mm512_storeu_ps(r + 16, c31);
+			r = c + 4 * ldc;	_mm512_storeu_ps(r, c40);	_mm512_storeu_ps(r + 16, c41);
+			r = c + 5 * ldc;	_mm512_storeu_ps(r, c50);	_mm512_storeu_ps(r + 16, c51);
+		}
+	}
+
+	/** Copy a @p kc x @p nc block of B into panels which are @p nr columns wide.  Within each panel the values are
+	 * stored row by row so the micro-kernel reads B sequentially.  The last panel is padded with zeros.
+	 */
+	static inline void pack_b(const int kc, const int nc, const int nr, const float * B, const int ldb, float * packed)
+	{
+		TAT(TATPARMS);
+
+		const int panels = (nc + nr - 1) / nr;
+
+		#pragma omp parallel for
+		for (int jp = 0; jp < panels; ++jp)
+		{
+			const int j = jp * nr;
+			const int cols = std::min(nr, nc - j);
+			float * dst = packed + static_cast<size_t>(jp) * kc * nr;
+
+			for (int p = 0; p < kc; ++p)
+			{
+				const float * src = B + static_cast<size_t>(p) * ldb + j;
+				int jj = 0;
+				for (; jj < cols; ++jj)
+				{
+					dst[jj] = src[jj];
+				}
+				for (; jj < nr; ++jj)
+				{
+					dst[jj] = 0.0f;
+				}
+				dst += nr;
+			}
+		}
+	}
+
+	/** Copy a @p mc x @p kc block of A into panels which are @ref GEMM_MR rows high, multiplying by @p alpha.  Within
+	 * each panel the values are stored column by column.  The last panel is padded with zeros.
+	 */
+	static inline void pack_a(const int mc, const int kc, const float alpha, const float * A, const int lda, float * packed)
+	{
+		TAT(TATPARMS);
+
+		const int panels = (mc + GEMM_MR - 1) / GEMM_MR;
+
+		#pragma omp parallel for
+		for (int ip = 0; ip < panels; ++ip)
+		{
+			const int i = ip * GEMM_MR;
+			const int rows = std::min(GEMM_MR, mc - i);
+			float * dst = packed + static_cast<size_t>(ip) * kc * GEMM_MR;
+
+			for (int p = 0; p < kc; ++p)
+			{
+				int ii = 0;
+				for (; ii < rows; ++ii)
+				{
+					dst[ii] = alpha * A[static_cast<size_t>(i + ii) * lda + p];
+				}
+				for (; ii < GEMM_MR; ++ii)
+				{
+					dst[ii] = 0.0f;
+				}
+				dst += GEMM_MR;
+			}
+		}
+	}
+
+	/** Same as @ref pack_a() but for weights stored as FP16 or BF16.  Each row is converted to floats while it is
+	 * packed, so the half-size weights are what gets read from memory.
+	 */
+	static inline void pack_a_half(const int mc, const int kc, const float alpha, const uint16_t * A, const int lda, const bool bf16, float * packed)
+	{
+		TAT(TATPARMS);
+
+		const int panels = (mc + GEMM_MR - 1) / GEMM_MR;
+
+		#pragma omp parallel for
+		for (int ip = 0; ip < panels; ++ip)
+		{
+			const int i = ip * GEMM_MR;
+			const int rows = std::min(GEMM_MR, mc - i);
+			float * panel = packed + static_cast<size_t>(ip) * kc * GEMM_MR;
+
+			float row[GEMM_KC];
+			for (int ii = 0; ii < GEMM_MR; ++ii)
+			{
+				if (ii < rows)
+				{
+					half_to_float(A + static_cast<size_t>(i + ii) * lda, row, kc, bf16);
+				}
+				else
+				{
+					std::fill_n(row, kc, 0.0f);
+				}
+
+				for (int p = 0; p < kc; ++p)
+				{
+					panel[p * GEMM_MR + ii] = alpha * row[p];
+				}
+			}
+		}
+	}
+
+	/** The blocked GEMM behind @ref gemm_nn_packed() and @ref gemm_nn_fused_half().  @p T is the type used to store A,
+	 * either @p float or @p uint16_t for FP16 and BF16 weights.
+	 */
+	template <typename T>
+	static void gemm_nn_packed_blocked(int M, int N, int K, float ALPHA,
+		const T *A, int lda, const bool bf16,
+		float *B, int ldb,
+		float *C, int ldc,
+		const Gemm_Epilogue * epilogue)
+	{
+		TAT(TATPARMS);
+
+		const bool overwrite = (epilogue and epilogue->overwrite);
+
+		const bool use_avx512 = (is_avx512() == 1);
+		const sgemm_micro_kernel kernel = (use_avx512 ? sgemm_kernel_avx512_6x32 : sgemm_kernel_avx2_6x16);
+		const int nr = (use_avx512 ? 32 : 16);
+
+		// packing buffers are re-used between calls; thread_local since several networks may run at the same time
+		static thread_local std::vector<float> packed_a;
+		static thread_local std::vector<float> packed_b;
+
+		const int m_panels = (M + GEMM_MR - 1) / GEMM_MR;
+		packed_a.resize(static_cast<size_t>(m_panels) * GEMM_MR * GEMM_KC);
+		packed_b.resize(static_cast<size_t>(GEMM_NC) * GEMM_KC);
+
+		const int m_blocks = (M + GEMM_MC - 1) / GEMM_MC;
+
+		for (int jc = 0; jc < N; jc += GEMM_NC)
+		{
+			const int nc = std::min(GEMM_NC, N - jc);
+			const int n_panels = (nc + nr - 1) / nr;
+
+			for (int pc = 0; pc < K; pc += GEMM_KC)
+			{
+				const int kc = std::min(GEMM_KC, K - pc);
+				const bool accumulate	= (pc > 0 or not overwrite);	// with BETA=0 the first block of K overwrites C
+				const bool last_block	= (pc + kc >= K);				// C is final once the last block of K has been added
+
+				pack_b(kc, nc, nr, B + static_cast<size_t>(pc) * ldb + jc, ldb, packed_b.data());
+				if constexpr (std::is_same<T, float>::value)
+				{
+					pack_a(M, kc, ALPHA, A + pc, lda, packed_a.data());
+				}
+				else
+				{
+					pack_a_half(M, kc, ALPHA, A + pc, lda, bf16, packed_a.data());
+				}
+
+				const float * pa = packed_a.data();
+				const float * pb = packed_b.data();
+
+				/* Each task is one block of MC rows combined with one B panel, so there is enough parallelism even when
+				 * M is small, which is common for the first few convolutional layers.  Within a task the B panel stays in
+				 * L1 while the MR x NR tiles of C are computed.
+				 */
+				#pragma omp parallel for schedule(static)
+				for (int task = 0; task < m_blocks * n_panels; ++task)
+				{
+					const int jp	= task / m_blocks;
+					const int ic	= (task % m_blocks) * GEMM_MC;
+					const int mc	= std::min(GEMM_MC, M - ic);
+					const int j		= jc + jp * nr;
+					const int cols	= std::min(nr, N - j);
+					const float * b_panel = pb + static_cast<size_t>(jp) * kc * nr;
+
+					for (int ir = 0; ir < mc; ir += GEMM_MR)
+					{
+						const int rows = std::min(GEMM_MR, mc - ir);
+						const float * a_panel = pa + static_cast<size_t>((ic + ir) / GEMM_MR) * kc * GEMM_MR;
+						float * c_tile = C + static_cast<size_t>(ic + ir) * ldc + j;
+
+						if (rows == GEMM_MR and cols == nr)
+						{
+							kernel(kc, a_panel, b_panel, c_tile, ldc, accumulate);
+						}
+						else
+						{
+							// partial tile at the bottom or right edge of C
+							float tmp[GEMM_MR * 32];
+							kernel(kc, a_panel, b_panel, tmp, nr, false);
+							for (int ii = 0; ii < rows; ++ii)
+							{
+								float * c_row = c_tile + static_cast<size_t>(ii) * ldc;
+								for (int jj = 0; jj < cols; ++jj)
+								{
+									c_row[jj] = (accumulate ? c_row[jj] : 0.0f) + tmp[ii * nr + jj];
+								}
+							}
+						}
+
+						if (epilogue and last_block)
+						{
+							// the tile was just written and is still in L1
+							apply_gemm_epilogue(rows, cols, ic + ir, j, c_tile, ldc, *epilogue);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+
+void gemm_nn_packed(int M, int N, int K, float ALPHA,
+	float *A, int lda,
+	float *B, int ldb,
+	float *C, int ldc,
+	const Gemm_Epilogue * epilogue)
+{
+	TAT(TATPARMS);
+
+	// very small products are faster without the overhead of packing
+	if (static_cast<int64_t>(M) * N * K < 32 * 32 * 32 or not is_fma_avx2())
+	{
+		gemm_nn_fast_with_epilogue(M, N, K, ALPHA, A, lda, B, ldb, C, ldc, epilogue);
+		return;
+	}
+
+	gemm_nn_packed_blocked(M, N, K, ALPHA, A, lda, false, B, ldb, C, ldc, epilogue);
+}
+
+
+void gemm_nn_packed_half(int M, int N, int K, const uint16_t *A, int lda, bool bf16, float *B, int ldb, float *C, int ldc, const Gemm_Epilogue & epilogue)
+{
+	TAT(TATPARMS);
+
+	if (static_cast<int64_t>(M) * N * K < 32 * 32 * 32 or not is_fma_avx2())
+	{
+		gemm_nn_half_with_epilogue(M, N, K, A, lda, bf16, B, ldb, C, ldc, epilogue);
+		return;
+	}
+
+	gemm_nn_packed_blocked(M, N, K, 1.0f, A, lda, bf16, B, ldb, C, ldc, &epilogue);
+}
+
+
+DARKNET_TARGET_F16C
+bool fp16_to_float_f16c(const uint16_t *src, float *dst, size_t n)
+{
+	if (is_f16c() != 1)
+	{
+		return false;
+	}
+
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		_mm256_storeu_ps(dst + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i))));
+	}
+	for (; i < n; ++i)
+	{
+		dst[i] = _cvtsh_ss(src[i]);
+	}
+
+	return true;
+}
+
+
+DARKNET_TARGET_F16C
+bool float_to_fp16_f16c(const float *src, uint16_t *dst, size_t n)
+{
+	if (is_f16c() != 1)
+	{
+		return false;
+	}
+
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+	}
+	for (; i < n; ++i)
+	{
+		dst[i] = _cvtss_sh(src[i], _MM_FROUND_TO_NEAREST_INT);
+	}
+
+	return true;
+}
+
+
+namespace
+{
+	/// Sum of the 8 32-bit integers in @p v.
+	DARKNET_TARGET_AVX2_FMA
+	static inline int32_t horizontal_sum_epi32(const __m256i v)
+	{
+		__m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+		sum = _mm_hadd_epi32(sum, sum);
+		sum = _mm_hadd_epi32(sum, sum);
+		return _mm_cvtsi128_si32(sum);
+	}
+
+	/** 4x2 dot product kernel using AVX2 @p maddubs.  The pairs of 8-bit products are added into 16-bit integers with
+	 * saturation, which cannot happen since the activations are limited to 7 bits:  2 * 127 * 127 < 32767.  The
+	 * accumulators are spelled out so they stay in registers.
+	 */
+	DARKNET_TARGET_AVX2_FMA
+	static void int8_dot_avx2_4x2(const int K, const int8_t * const * a, const uint8_t * const * b, int32_t * c)
+	{
+		TAT_COMMENT(TATPARMS, "hot loop");
+
+		const int8_t * a0 = a[0];
+		const int8_t * a1 = a[1];
+		const int8_t * a2 = a[2];
+		const int8_t * a3 = a[3];
+		const uint8_t * b0 = b[0];
+		const uint8_t * b1 = b[1];
+
+		const __m256i ones = _mm256_set1_epi16(1);
+		__m256i c00 = _mm256_setzero_si256(), c01 = _mm256_setzero_si256();
+		__m256i c10 = _mm256_setzero_si256(), c11 = _mm256_setzero_si256();
+		__m256i c20 = _mm256_setzero_si256(), c21 = _mm256_setzero_si256();
+		__m256i c30 = _mm256_setzero_si256(), c31 = _mm256_setzero_si256();
+
+		for (int k = 0; k < K; k += 32)
+		{
+			const __m256i vb0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b0 + k));
+			const __m256i vb1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b1 + k));
+			__m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a0 + k));
+			c00 = _mm256_add_epi32(c00, _mm256_madd_epi16(_mm256_maddubs_epi16(vb0, va), ones));
+			c01 = _mm256_add_epi32(c01, _mm256_madd_epi16(_mm256_maddubs_epi16(vb1, va), ones));
+			va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a1 + k));
+			c10 = _mm256_add_epi32(c10, _mm256_madd_epi16(_mm256_maddubs_epi16(vb0, va), ones));
+			c11 = _mm256_add_epi32(c11, _mm256_madd_epi16(_mm256_maddubs_epi16(vb1, va), ones));
+			va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a2 + k));
+			c20 = _mm256_add_epi32(c20, _mm256_madd_epi16(_mm256_maddubs_epi16(vb0, va), ones));
+			c21 = _mm256_add_epi32(c21, _mm256_madd_epi16(_mm256_maddubs_epi16(vb1, va), ones));
+			va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a3 + k));
+			c30 = _mm256_add_epi32(c30, _mm256_madd_epi16(_mm256_maddubs_epi16(vb0, va), ones));
+			c31 = _mm256_add_epi32(c31, _mm256_madd_epi16(_mm256_maddubs_epi16(vb1, va), ones));
+		}
+
+		c[0] = horizontal_sum_epi32(c00);	c[1] = horizontal_sum_epi32(c01);
+		c[2] = horizontal_sum_epi32(c10);	c[3] = horizontal_sum_epi32(c11);
+		c[4] = horizontal_sum_epi32(c20);	c[5] = horizontal_sum_epi32(c21);
+		c[6] = horizontal_sum_epi32(c30);	c[7] = horizontal_sum_epi32(c31);
+	}
+
+	/** Sum of the 16 32-bit integers in @p v.  The lanes are stored and added one by one, since the AVX-512 reduction
+	 * and extract intrinsics start from an undefined register and make GCC warn about uninitialized values.
+	 */
+	DARKNET_TARGET_AVX512_VNNI
+	static inline int32_t horizontal_sum_epi32(const __m512i v)
+	{
+		alignas(64) int32_t lanes[16];
+		_mm512_store_si512(lanes, v);
+
+		int32_t sum = 0;
+		for (int i = 0; i < 16; ++i)
+		{
+			sum += lanes[i];
+		}
+
+		return sum;
+	}
+
+	/** 4x2 dot product kernel using the AVX-512 VNNI @p vpdpbusd instruction, on 512-bit registers and then one
+	 * masked 32-byte step when K is an odd multiple of 32.
+	 */
+	DARKNET_TARGET_AVX512_VNNI
+	static void int8_dot_vnni_4x2(const int K, const int8_t * const * a, const uint8_t * const * b, int32_t * c)
+	{
+		TAT_COMMENT(TATPARMS, "hot loop");
+
+		const int8_t * a0 = a[0];
+		const int8_t * a1 = a[1];
+		const int8_t * a2 = a[2];
+		const int8_t * a3 = a[3];
+		const uint8_t * b0 = b[0];
+		const uint8_t * b1 = b[1];
+
+		__m512i c00 = _mm512_setzero_si512(), c01 = _mm512_setzero_si512();
+		__m512i c10 = _mm512_setzero_si512(), c11 = _mm512_setzero_si512();
+		__m512i c20 = _mm512_setzero_si512(), c21 = _mm512_setzero_si512();
+		__m512i c30 = _mm512_setzero_si512(), c31 = _mm512_setzero_si512();
+
+		int k = 0;
+		for (; k + 64 <= K; k += 64)
+		{
+			const __m512i vb0 = _mm512_loadu_si512(b0 + k);
+			const __m512i vb1 = _mm512_loadu_si512(b1 + k);
+			__m512i va = _mm512_loadu_si512(a0 + k);
+			c00 = _mm512_dpbusd_epi32(c00, vb0, va);
+			c01 = _mm512_dpbusd_epi32(c01, vb1, va);
+			va = _mm512_loadu_si512(a1 + k);
+			c10 = _mm512_dpbusd_epi32(c10, vb0, va);
+			c11 = _mm512_dpbusd_epi32(c11, vb1, va);
+			va = _mm512_loadu_si512(a2 + k);
+			c20 = _mm512_dpbusd_epi32(c20, vb0, va);
+			c21 = _mm512_dpbusd_epi32(c21, vb1, va);
+			va = _mm512_loadu_si512(a3 + k);
+			c30 = _mm512_dpbusd_epi32(c30, vb0, va);
+			c31 = _mm512_dpbusd_epi32(c31, vb1, va);
+		}
+
+		if (k < K)
+		{
+			// the remaining 32 bytes, with the upper half of each register zeroed by the mask
+			const __mmask64 tail = 0xFFFFFFFFull;
+			const __m512i vb0 = _mm512_maskz_loadu_epi8(tail, b0 + k);
+			const __m512i vb1 = _mm512_maskz_loadu_epi8(tail, b1 + k);
+			__m512i va = _mm512_maskz_loadu_epi8(tail, a0 + k);
+			c00 = _mm512_dpbusd_epi32(c00, vb0, va);
+			c01 = _mm512_dpbusd_epi32(c01, vb1, va);
+			va = _mm512_maskz_loadu_epi8(tail, a1 + k);
+			c10 = _mm512_dpbusd_epi32(c10, vb0, va);
+			c11 = _mm512_dpbusd_epi32(c11, vb1, va);
+			va = _mm512_maskz_loadu_epi8(tail, a2 + k);
+			c20 = _mm512_dpbusd_epi32(c20, vb0, va);
+			c21 = _mm512_dpbusd_epi32(c21, vb1, va);
+			va = _mm512_maskz_loadu_epi8(tail, a3 + k);
+			c30 = _mm512_dpbusd_epi32(c30, vb0, va);
+			c31 = _mm512_dpbusd_epi32(c31, vb1, va);
+		}
+
+		c[0] = horizontal_sum_epi32(c00);	c[1] = horizontal_sum_epi32(c01);
+		c[2] = horizontal_sum_epi32(c10);	c[3] = horizontal_sum_epi32(c11);
+		c[4] = horizontal_sum_epi32(c20);	c[5] = horizontal_sum_epi32(c21);
+		c[6] = horizontal_sum_epi32(c30);	c[7] = horizontal_sum_epi32(c31);
+	}
+
+	/// Pick the fastest 8-bit dot product kernel supported by this CPU.
+	static int8_dot_kernel select_int8_dot_kernel()
+	{
+		TAT(TATPARMS);
+
+		if (is_avx512_vnni() == 1)
+		{
+			return int8_dot_vnni_4x2;
+		}
+		if (is_fma_avx2() == 1)
+		{
+			return int8_dot_avx2_4x2;
+		}
+		return int8_dot_generic_4x2;
+	}
+}
+
+
 void gemm_nn_bin_32bit_packed(int M, int N, int K, float ALPHA,
 	uint32_t *A, int lda,
 	uint32_t *B, int ldb,
@@ -1914,6 +2734,39 @@ int is_avx()
 	return 0;
 }
 
+int is_avx512()
+{
+	return 0;
+}
+
+int is_avx512_vnni()
+{
+	return 0;
+}
+
+int is_f16c()
+{
+	return 0;
+}
+
+bool fp16_to_float_f16c(const uint16_t *, float *, size_t)
+{
+	return false;
+}
+
+bool float_to_fp16_f16c(const float *, uint16_t *, size_t)
+{
+	return false;
+}
+
+namespace
+{
+	static int8_dot_kernel select_int8_dot_kernel()
+	{
+		return int8_dot_generic_4x2;
+	}
+}
+
 int is_fma_avx2()
 {
 	return 0;
@@ -1956,6 +2809,25 @@ void gemm_nn_fast(int M, int N, int K, float ALPHA,
 	}
 }
 
+void gemm_nn_packed(int M, int N, int K, float ALPHA,
+	float *A, int lda,
+	float *B, int ldb,
+	float *C, int ldc,
+	const Gemm_Epilogue * epilogue)
+{
+	TAT(TATPARMS);
+
+	// the packed kernels require AVX2 and FMA
+	gemm_nn_fast_with_epilogue(M, N, K, ALPHA, A, lda, B, ldb, C, ldc, epilogue);
+}
+
+void gemm_nn_packed_half(int M, int N, int K, const uint16_t *A, int lda, bool bf16, float *B, int ldb, float *C, int ldc, const Gemm_Epilogue & epilogue)
+{
+	TAT(TATPARMS);
+
+	gemm_nn_half_with_epilogue(M, N, K, A, lda, bf16, B, ldb, C, ldc, epilogue);
+}
+
 void gemm_nn_bin_32bit_packed(int M, int N, int K, float ALPHA,
 	uint32_t *A, int lda,
 	uint32_t *B, int ldb,
@@ -2626,6 +3498,16 @@ void gemm_cpu(int TA, int TB, int M, int N, int K, float ALPHA,
 	TAT(TATPARMS);
 
 	//printf("cpu: %d %d %d %d %d %f %d %d %f %d\n",TA, TB, M, N, K, ALPHA, lda, ldb, BETA, ldc);
+
+#ifdef DARKNET_USE_CBLAS
+	// built with ENABLE_EXTERNAL_BLAS, so let the vendor library do all the work (including BETA)
+	cblas_sgemm(CblasRowMajor,
+			TA ? CblasTrans : CblasNoTrans,
+			TB ? CblasTrans : CblasNoTrans,
+			M, N, K, ALPHA, A, lda, B, ldb, BETA, C, ldc);
+	return;
+#endif
+
 	if (BETA != 1){
 		int i, j;
 		for(i = 0; i < M; ++i){
@@ -2637,7 +3519,7 @@ void gemm_cpu(int TA, int TB, int M, int N, int K, float ALPHA,
 
 	is_avx();   // initialize static variable
 	if (is_fma_avx2() && !TA && !TB) {
-		gemm_nn_fast(M, N, K, ALPHA, A, lda, B, ldb, C, ldc);
+		gemm_nn_packed(M, N, K, ALPHA, A, lda, B, ldb, C, ldc);
 	}
 	else {
 		int t;
@@ -2655,6 +3537,234 @@ void gemm_cpu(int TA, int TB, int M, int N, int K, float ALPHA,
 	}
 }
 
+
+void gemm_nn_fused(int M, int N, int K, float ALPHA,
+		float *A, int lda,
+		float *B, int ldb,
+		float *C, int ldc,
+		const Gemm_Epilogue & epilogue)
+{
+	TAT(TATPARMS);
+
+#ifdef DARKNET_USE_CBLAS
+	// the vendor library has no epilogue, so BETA=0 is as much as can be fused
+	cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, M, N, K, ALPHA, A, lda, B, ldb, epilogue.overwrite ? 0.0f : 1.0f, C, ldc);
+
+	#pragma omp parallel for
+	for (int i = 0; i < M; ++i)
+	{
+		apply_gemm_epilogue(1, N, i, 0, C + static_cast<size_t>(i) * ldc, ldc, epilogue);
+	}
+#else
+	is_avx();   // initialize static variable
+	gemm_nn_packed(M, N, K, ALPHA, A, lda, B, ldb, C, ldc, &epilogue);
+#endif
+}
+
+void gemm_nn_fused_half(int M, int N, int K,
+		const uint16_t *A, int lda, bool bf16,
+		float *B, int ldb,
+		float *C, int ldc,
+		const Gemm_Epilogue & epilogue)
+{
+	TAT(TATPARMS);
+
+	// the vendor library only takes floats, so even with DARKNET_USE_CBLAS the half weights go through the packed
+	// kernel which converts them while packing instead of expanding all of them on every call
+	is_avx();   // initialize static variable
+	gemm_nn_packed_half(M, N, K, A, lda, bf16, B, ldb, C, ldc, epilogue);
+}
+
+
+void float_to_half(const float *src, uint16_t *dst, size_t n, bool bf16)
+{
+	TAT(TATPARMS);
+
+	if (bf16)
+	{
+		for (size_t i = 0; i < n; ++i)
+		{
+			uint32_t bits;
+			std::memcpy(&bits, src + i, sizeof(bits));
+			if ((bits & 0x7fffffff) > 0x7f800000)
+			{
+				dst[i] = static_cast<uint16_t>((bits >> 16) | 0x40);	// keep NaN a quiet NaN
+			}
+			else
+			{
+				dst[i] = static_cast<uint16_t>((bits + 0x7fff + ((bits >> 16) & 1)) >> 16);	// round to nearest even
+			}
+		}
+		return;
+	}
+
+	if (float_to_fp16_f16c(src, dst, n))
+	{
+		return;
+	}
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, src + i, sizeof(bits));
+		const uint32_t sign = (bits >> 16) & 0x8000;
+		const uint32_t magnitude = bits & 0x7fffffff;
+		uint32_t h;
+		if (magnitude > 0x7f800000)
+		{
+			h = 0x7e00;													// NaN
+		}
+		else if (magnitude >= 0x477ff000)
+		{
+			h = 0x7c00;													// too large, or infinity
+		}
+		else if (magnitude < 0x38800000)
+		{
+			// subnormal half, or zero
+			const uint32_t shift = 126 - (magnitude >> 23);
+			if (shift > 24)
+			{
+				h = 0;
+			}
+			else
+			{
+				const uint32_t mantissa = (magnitude & 0x7fffff) | 0x800000;
+				h = mantissa >> shift;
+				const uint32_t remainder = mantissa & ((1u << shift) - 1);
+				const uint32_t halfway = 1u << (shift - 1);
+				if (remainder > halfway or (remainder == halfway and (h & 1)))
+				{
+					h ++;
+				}
+			}
+		}
+		else
+		{
+			h = (magnitude - 0x38000000 + 0xfff + ((magnitude >> 13) & 1)) >> 13;
+		}
+		dst[i] = static_cast<uint16_t>(sign | h);
+	}
+}
+
+
+void half_to_float(const uint16_t *src, float *dst, size_t n, bool bf16)
+{
+	TAT_COMMENT(TATPARMS, "hot loop");
+
+	if (bf16)
+	{
+		for (size_t i = 0; i < n; ++i)
+		{
+			const uint32_t bits = static_cast<uint32_t>(src[i]) << 16;
+			std::memcpy(dst + i, &bits, sizeof(bits));
+		}
+		return;
+	}
+
+	if (fp16_to_float_f16c(src, dst, n))
+	{
+		return;
+	}
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		const uint32_t sign = static_cast<uint32_t>(src[i] & 0x8000) << 16;
+		const uint32_t exponent = (src[i] >> 10) & 0x1f;
+		uint32_t mantissa = src[i] & 0x3ff;
+		uint32_t bits;
+		if (exponent == 0x1f)
+		{
+			bits = sign | 0x7f800000 | (mantissa << 13);				// infinity or NaN
+		}
+		else if (exponent != 0)
+		{
+			bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+		}
+		else if (mantissa == 0)
+		{
+			bits = sign;
+		}
+		else
+		{
+			// subnormal half, which is a normal float
+			int e = 113;
+			while ((mantissa & 0x400) == 0)
+			{
+				mantissa <<= 1;
+				e --;
+			}
+			bits = sign | (static_cast<uint32_t>(e) << 23) | ((mantissa & 0x3ff) << 13);
+		}
+		std::memcpy(dst + i, &bits, sizeof(bits));
+	}
+}
+
+
+void gemm_int8_fused(int M, int N, int K,
+		const int8_t *A, int lda,
+		const uint8_t *B, int ldb,
+		float *C, int ldc,
+		const Gemm_Int8_Requantize & requantize,
+		const Gemm_Epilogue & epilogue)
+{
+	TAT(TATPARMS);
+
+	static const int8_dot_kernel kernel = select_int8_dot_kernel();
+
+	/* Each task is a block of rows of A combined with a block of rows of B, which together fit in L2.  The block of C
+	 * is finished by the task, so the bias and activation are applied while it is still in cache.
+	 */
+	constexpr int block_rows = 32;
+	constexpr int block_cols = 64;
+	const int m_blocks = (M + block_rows - 1) / block_rows;
+	const int n_blocks = (N + block_cols - 1) / block_cols;
+
+	#pragma omp parallel for schedule(static)
+	for (int task = 0; task < m_blocks * n_blocks; ++task)
+	{
+		const int i0	= (task % m_blocks) * block_rows;
+		const int j0	= (task / m_blocks) * block_cols;
+		const int rows	= std::min(block_rows, M - i0);
+		const int cols	= std::min(block_cols, N - j0);
+
+		for (int i = i0; i < i0 + rows; i += 4)
+		{
+			// rows and columns past the edge repeat the last one, and those results are discarded
+			const int8_t * a[4];
+			for (int r = 0; r < 4; ++r)
+			{
+				a[r] = A + static_cast<size_t>(std::min(i + r, M - 1)) * lda;
+			}
+
+			for (int j = j0; j < j0 + cols; j += 2)
+			{
+				const uint8_t * b[2] =
+				{
+					B + static_cast<size_t>(j) * ldb,
+					B + static_cast<size_t>(std::min(j + 1, N - 1)) * ldb
+				};
+
+				int32_t dot[8];
+				kernel(K, a, b, dot);
+
+				for (int r = 0; r < 4 and i + r < M; ++r)
+				{
+					const int32_t offset	= requantize.zero_point * requantize.row_sums[i + r];
+					const float scale		= requantize.input_scale * requantize.row_scales[i + r];
+					float * c = C + static_cast<size_t>(i + r) * ldc + j;
+					c[0] = static_cast<float>(dot[r * 2] - offset) * scale;
+					if (j + 1 < N)
+					{
+						c[1] = static_cast<float>(dot[r * 2 + 1] - offset) * scale;
+					}
+				}
+			}
+		}
+
+		apply_gemm_epilogue(rows, cols, i0, j0, C + static_cast<size_t>(i0) * ldc + j0, ldc, epilogue);
+	}
+}
+
 #ifdef GPU
 
 #include <math.h>
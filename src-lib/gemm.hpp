@@ -29,6 +29,23 @@ static inline unsigned char get_bit(unsigned char const*const src, size_t index)
 int is_avx();
 int is_fma_avx2();
 
+/// Whether the CPU and OS both support AVX-512F.  @since 2026-10-17
+int is_avx512();
+
+/// Whether the CPU and OS both support the AVX-512 VNNI 8-bit dot product instructions.  @since 2026-10-17
+int is_avx512_vnni();
+
+/// Whether the CPU supports the F16C half-precision conversion instructions.  @since 2026-10-17
+int is_f16c();
+
+/** Convert floats to FP16 (rounded to nearest even) or to BF16 when @p bf16 is set.  Uses F16C when available.
+ * @since 2026-10-17
+ */
+void float_to_half(const float *src, uint16_t *dst, size_t n, bool bf16);
+
+/// Convert FP16 values, or BF16 when @p bf16 is set, back to floats.  Uses F16C when available.  @since 2026-10-17
+void half_to_float(const uint16_t *src, float *dst, size_t n, bool bf16);
+
 void float_to_bit(float *src, unsigned char *dst, size_t size);
 
 void transpose_block_SSE4x4(float *A, float *B, const int n, const int m,
@@ -101,6 +118,74 @@ void gemm_cpu(int TA, int TB, int M, int N, int K, float ALPHA,
         float BETA,
         float *C, int ldc);
 
+/** Work which @ref gemm_nn_packed() applies to each tile of C once the tile is final, while it is still in cache.
+ * Used by the convolutional layers to avoid separate passes over the output for the bias and activation.
+ * @since 2026-10-17
+ */
+struct Gemm_Epilogue
+{
+	bool overwrite;			///< write C instead of accumulating into it (BETA=0), so C does not need to be zeroed first
+	const float * bias;		///< one value per row of C which is added to that row, or @p nullptr
+	ACTIVATION activation;	///< applied after the bias; must be element-wise, so not one of the @p NORM_CHAN activations
+	bool bias_per_column;	///< @p bias has one value per column of C instead, such as for channels-last outputs
+};
+
+/** C += ALPHA * A * B for row-major matrices, using cache blocking, packed panels of A and B, and an AVX2 or AVX-512
+ * FMA micro-kernel selected at runtime.  Falls back to the older kernels when FMA and AVX2 are not available.
+ * If @p epilogue is set, it is applied to C as part of the same pass.
+ * @since 2026-10-17
+ */
+void gemm_nn_packed(int M, int N, int K, float ALPHA,
+        float *A, int lda,
+        float *B, int ldb,
+        float *C, int ldc,
+        const Gemm_Epilogue * epilogue = nullptr);
+
+/** C = activation(ALPHA * A * B + bias) for row-major matrices, with the bias and activation described by @p epilogue.
+ * @since 2026-10-17
+ */
+void gemm_nn_fused(int M, int N, int K, float ALPHA,
+        float *A, int lda,
+        float *B, int ldb,
+        float *C, int ldc,
+        const Gemm_Epilogue & epilogue);
+
+/** How @ref gemm_int8_fused() converts the 32-bit integer dot products back to floating point.  The rows of A are
+ * signed 8-bit weights quantized per row, and the columns of B are unsigned 7-bit activations quantized per tensor
+ * with a zero point.
+ * @since 2026-10-17
+ */
+struct Gemm_Int8_Requantize
+{
+	float input_scale;			///< B was quantized as @p round(b / input_scale) + zero_point
+	int zero_point;				///< value of B which represents 0.0f, in the range 0 to 127
+	const float * row_scales;	///< one value per row of A, which was quantized as @p round(a / row_scales[i])
+	const int32_t * row_sums;	///< sum of the quantized values in each row of A, used to remove the zero point of B
+};
+
+/** Same as @ref gemm_nn_fused() with ALPHA=1, but A is stored as FP16 (or BF16 when @p bf16 is set) to halve the
+ * memory used by the weights.  A is converted back to floats as it is packed for the micro-kernel.
+ * @since 2026-10-17
+ */
+void gemm_nn_fused_half(int M, int N, int K,
+		const uint16_t *A, int lda, bool bf16,
+		float *B, int ldb,
+		float *C, int ldc,
+		const Gemm_Epilogue & epilogue);
+
+/** C = activation(A * B' + bias) where A is M x K signed 8-bit values, B is N x K unsigned 7-bit values (one row per
+ * column of C), and C is M x N floats.  The dot products are computed exactly in 32-bit integers with AVX-512 VNNI or
+ * AVX2 @p maddubs instructions, then scaled back to floats as described by @p requantize before @p epilogue is applied.
+ * C is always overwritten.  K must be a multiple of 32, where the padding in A must be zero.
+ * @since 2026-10-17
+ */
+void gemm_int8_fused(int M, int N, int K,
+		const int8_t *A, int lda,
+		const uint8_t *B, int ldb,
+		float *C, int ldc,
+		const Gemm_Int8_Requantize & requantize,
+		const Gemm_Epilogue & epilogue);
+
 #ifdef GPU
 void gemm_ongpu(int TA, int TB, int M, int N, int K, float ALPHA,
         float *A_gpu, int lda,
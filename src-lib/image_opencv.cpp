@@ -59,7 +59,17 @@ cv::Mat load_rgb_mat_image(const char * const filename, int channels)
 		darknet_fatal_error(DARKNET_LOC, "OpenCV cannot load an image with %d channels: %s", channels, filename);
 	}
 
-	cv::Mat mat = cv::imread(filename, flag);
+	cv::Mat mat;
+	const Darknet::DatasetShard::Entry * packed = Darknet::find_image_in_dataset_shards(filename);
+	if (packed)
+	{
+		// the image file was stored as-is in a dataset shard, so decode it from memory instead of opening the file
+		mat = cv::imdecode(cv::Mat(1, static_cast<int>(packed->image_size), CV_8UC1, const_cast<uint8_t *>(packed->image)), flag);
+	}
+	else
+	{
+		mat = cv::imread(filename, flag);
+	}
 	if (mat.empty())
 	{
 		darknet_fatal_error(DARKNET_LOC, "failed to load image file \"%s\"", filename);
@@ -71,6 +71,32 @@ namespace
 		return;
 	}
 
+	void static inline free_and_clear(int8_t* & ptr)
+	{
+		TAT(TATPARMS);
+
+		if (ptr)
+		{
+			free(ptr);
+			ptr = nullptr;
+		}
+
+		return;
+	}
+
+	void static inline free_and_clear(uint16_t* & ptr)
+	{
+		TAT(TATPARMS);
+
+		if (ptr)
+		{
+			free(ptr);
+			ptr = nullptr;
+		}
+
+		return;
+	}
+
 	void static inline free_sublayer(Darknet::Layer* & l)
 	{
 		TAT(TATPARMS);
@@ -110,6 +136,148 @@ void free_layer(Darknet::Layer & l)
 }
 
 
+namespace
+{
+	/// Pointers to every sublayer a layer may own.  Used when walking RNN, LSTM, GRU, CRNN, and antialiasing layers.
+	static inline std::vector<Darknet::Layer **> get_sublayers(Darknet::Layer & l)
+	{
+		TAT(TATPARMS);
+
+		return
+		{
+			&l.input_layer, &l.self_layer, &l.output_layer,
+			&l.reset_layer, &l.update_layer, &l.state_layer,
+			&l.input_gate_layer, &l.state_gate_layer, &l.input_save_layer, &l.state_save_layer, &l.input_state_layer, &l.state_state_layer,
+			&l.input_z_layer, &l.state_z_layer, &l.input_r_layer, &l.state_r_layer, &l.input_h_layer, &l.state_h_layer,
+			&l.wz, &l.uz, &l.wr, &l.ur, &l.wh, &l.uh,
+			&l.uo, &l.wo, &l.vo, &l.uf, &l.wf, &l.vf, &l.ui, &l.wi, &l.vi, &l.ug, &l.wg
+		};
+	}
+}
+
+
+void share_layer_weights(Darknet::Layer & dst, const Darknet::Layer & src)
+{
+	TAT(TATPARMS);
+
+	if (dst.type != src.type)
+	{
+		darknet_fatal_error(DARKNET_LOC, "cannot share weights between layers of different types (%s and %s)", Darknet::to_string(dst.type).c_str(), Darknet::to_string(src.type).c_str());
+	}
+
+	// mirror what fuse_conv_batchnorm() did to the source layer
+	if (dst.type == Darknet::ELayerType::CONVOLUTIONAL and dst.batch_normalize and not src.batch_normalize)
+	{
+		free_convolutional_batchnorm(&dst);
+		dst.batch_normalize = 0;
+	}
+	dst.weights_normalization = src.weights_normalization;
+
+	if (dst.share_layer == nullptr)
+	{
+		// this layer allocated its own parameters which are about to be replaced
+		if (dst.weights)			free_and_clear(dst.weights);
+		if (dst.biases)				free_and_clear(dst.biases);
+		if (dst.scales)				free_and_clear(dst.scales);
+		if (dst.rolling_mean)		free_and_clear(dst.rolling_mean);
+		if (dst.rolling_variance)	free_and_clear(dst.rolling_variance);
+		if (dst.winograd_weights)	free_and_clear(dst.winograd_weights);
+		if (dst.weights_nhwc)		free_and_clear(dst.weights_nhwc);
+		if (dst.weights_int8)		free_and_clear(dst.weights_int8);
+		if (dst.weights_int8_scales)	free_and_clear(dst.weights_int8_scales);
+		if (dst.weights_int8_sums)	free_and_clear(dst.weights_int8_sums);
+		if (dst.weights_half)		free_and_clear(dst.weights_half);
+		if (dst.lstm_gate_weights)	free_and_clear(dst.lstm_gate_weights);
+		if (dst.lstm_gate_biases)	free_and_clear(dst.lstm_gate_biases);
+#ifdef GPU
+		if (dst.weights_gpu)			cuda_free_and_clear(dst.weights_gpu);
+		if (dst.weights_gpu16)			cuda_free_and_clear(dst.weights_gpu16);
+		if (dst.biases_gpu)				cuda_free_and_clear(dst.biases_gpu);
+		if (dst.scales_gpu)				cuda_free_and_clear(dst.scales_gpu);
+		if (dst.rolling_mean_gpu)		cuda_free_and_clear(dst.rolling_mean_gpu);
+		if (dst.rolling_variance_gpu)	cuda_free_and_clear(dst.rolling_variance_gpu);
+#endif
+	}
+
+	dst.weights				= src.weights;
+	dst.biases				= src.biases;
+	dst.scales				= src.scales;
+	dst.rolling_mean		= src.rolling_mean;
+	dst.rolling_variance	= src.rolling_variance;
+	dst.winograd_weights	= src.winograd_weights;
+	dst.weights_nhwc		= src.weights_nhwc;
+	dst.weights_int8		= src.weights_int8;
+	dst.weights_int8_scales	= src.weights_int8_scales;
+	dst.weights_int8_sums	= src.weights_int8_sums;
+	dst.input_int8_scale	= src.input_int8_scale;
+	dst.input_int8_zero_point	= src.input_int8_zero_point;
+	dst.weights_half		= src.weights_half;
+	dst.weights_storage		= src.weights_storage;
+	dst.lstm_gate_weights	= src.lstm_gate_weights;
+	dst.lstm_gate_biases	= src.lstm_gate_biases;
+#ifdef GPU
+	dst.weights_gpu				= src.weights_gpu;
+	dst.weights_gpu16			= src.weights_gpu16;
+	dst.biases_gpu				= src.biases_gpu;
+	dst.scales_gpu				= src.scales_gpu;
+	dst.rolling_mean_gpu		= src.rolling_mean_gpu;
+	dst.rolling_variance_gpu	= src.rolling_variance_gpu;
+#endif
+
+	auto dst_sublayers = get_sublayers(dst);
+	auto src_sublayers = get_sublayers(const_cast<Darknet::Layer &>(src));
+	for (size_t idx = 0; idx < dst_sublayers.size(); idx ++)
+	{
+		Darknet::Layer * dst_sublayer = *dst_sublayers[idx];
+		Darknet::Layer * src_sublayer = *src_sublayers[idx];
+		if (dst_sublayer and src_sublayer)
+		{
+			share_layer_weights(*dst_sublayer, *src_sublayer);
+		}
+	}
+
+	return;
+}
+
+
+void release_shared_layer_weights(Darknet::Layer & l)
+{
+	TAT(TATPARMS);
+
+	l.weights			= nullptr;
+	l.biases			= nullptr;
+	l.scales			= nullptr;
+	l.rolling_mean		= nullptr;
+	l.rolling_variance	= nullptr;
+	l.winograd_weights	= nullptr;
+	l.weights_nhwc		= nullptr;
+	l.weights_int8		= nullptr;
+	l.weights_int8_scales	= nullptr;
+	l.weights_int8_sums	= nullptr;
+	l.weights_half		= nullptr;
+	l.lstm_gate_weights	= nullptr;
+	l.lstm_gate_biases	= nullptr;
+#ifdef GPU
+	l.weights_gpu			= nullptr;
+	l.weights_gpu16			= nullptr;
+	l.biases_gpu			= nullptr;
+	l.scales_gpu			= nullptr;
+	l.rolling_mean_gpu		= nullptr;
+	l.rolling_variance_gpu	= nullptr;
+#endif
+
+	for (auto sublayer : get_sublayers(l))
+	{
+		if (*sublayer)
+		{
+			release_shared_layer_weights(**sublayer);
+		}
+	}
+
+	return;
+}
+
+
 void free_layer_custom(Darknet::Layer & l, int keep_cudnn_desc)
 {
 	TAT(TATPARMS);
@@ -119,6 +287,16 @@ void free_layer_custom(Darknet::Layer & l, int keep_cudnn_desc)
 		return;	// don't free shared layers
 	}
 
+	if (l.weights_mapped)
+	{
+		// these belong to the memory-mapped weights file, which is unmapped when the network is deleted
+		l.biases			= nullptr;
+		l.weights			= nullptr;
+		l.scales			= nullptr;
+		l.rolling_mean		= nullptr;
+		l.rolling_variance	= nullptr;
+	}
+
 	if (l.antialiasing)
 	{
 		free_sublayer(l.input_layer);
@@ -185,6 +363,14 @@ void free_layer_custom(Darknet::Layer & l, int keep_cudnn_desc)
 	if (l.weight_updates)				free_and_clear(l.weight_updates);
 	if (l.align_bit_weights)			free_and_clear(l.align_bit_weights);
 	if (l.mean_arr)						free_and_clear(l.mean_arr);
+	if (l.winograd_weights)				free_and_clear(l.winograd_weights);
+	if (l.weights_nhwc)					free_and_clear(l.weights_nhwc);
+	if (l.weights_int8)					free_and_clear(l.weights_int8);
+	if (l.weights_int8_scales)			free_and_clear(l.weights_int8_scales);
+	if (l.weights_int8_sums)			free_and_clear(l.weights_int8_sums);
+	if (l.weights_half)					free_and_clear(l.weights_half);
+	if (l.lstm_gate_weights)			free_and_clear(l.lstm_gate_weights);
+	if (l.lstm_gate_biases)				free_and_clear(l.lstm_gate_biases);
 
 #ifdef GPU
 	if (l.delta && l.delta_pinned)
@@ -240,6 +426,8 @@ void free_layer_custom(Darknet::Layer & l, int keep_cudnn_desc)
 	if (l.stored_c_cpu)					free_and_clear(l.stored_c_cpu);
 	if (l.stored_h_cpu)					free_and_clear(l.stored_h_cpu);
 	if (l.cell_cpu)						free_and_clear(l.cell_cpu);
+	if (l.gates_cpu)					free_and_clear(l.gates_cpu);
+	if (l.gates_input_cpu)				free_and_clear(l.gates_input_cpu);
 
 #ifdef GPU
 	if (l.indexes_gpu)					cuda_free((float *)l.indexes_gpu);
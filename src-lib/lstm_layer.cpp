@@ -1,4 +1,5 @@
 #include "darknet_internal.hpp"
+#include "gemm.hpp"
 
 
 static void increment_layer(Darknet::Layer *l, int steps)
@@ -7,19 +8,116 @@ static void increment_layer(Darknet::Layer *l, int steps)
 
 	int num = l->outputs*l->batch*steps;
 	l->output += num;
-	l->delta += num;
-	l->x += num;
-	l->x_norm += num;
+
+	// these buffers are only allocated when training
+	if (l->delta)	l->delta += num;
+	if (l->x)		l->x += num;
+	if (l->x_norm)	l->x_norm += num;
 
 #ifdef GPU
 	l->output_gpu += num;
-	l->delta_gpu += num;
-	l->x_gpu += num;
-	l->x_norm_gpu += num;
+	if (l->delta_gpu)	l->delta_gpu += num;
+	if (l->x_gpu)		l->x_gpu += num;
+	if (l->x_norm_gpu)	l->x_norm_gpu += num;
 #endif
 }
 
-Darknet::Layer make_lstm_layer(int batch, int inputs, int outputs, int steps, int batch_normalize)
+
+namespace
+{
+	/** Copy the weights of one gate into @p weights, which has @p inputs + @p outputs floats per row.  The input weights
+	 * @p u come first on each row, followed by the recurrent weights @p w.  Batch norm is folded into the weights.
+	 */
+	static inline void pack_lstm_gate(const Darknet::Layer & u, const Darknet::Layer & w, float * weights, float * biases)
+	{
+		TAT(TATPARMS);
+
+		const int inputs	= u.inputs;
+		const int outputs	= u.outputs;
+		const int row_size	= inputs + outputs;
+
+		for (int j = 0; j < outputs; ++j)
+		{
+			float u_scale = 1.0f;
+			float w_scale = 1.0f;
+			biases[j] = u.biases[j] + w.biases[j];
+
+			if (u.batch_normalize)
+			{
+				u_scale = u.scales[j] / std::sqrt(u.rolling_variance[j] + .00001f);
+				biases[j] -= u.rolling_mean[j] * u_scale;
+			}
+			if (w.batch_normalize)
+			{
+				w_scale = w.scales[j] / std::sqrt(w.rolling_variance[j] + .00001f);
+				biases[j] -= w.rolling_mean[j] * w_scale;
+			}
+
+			float * row = weights + j * row_size;
+			for (int k = 0; k < inputs; ++k)
+			{
+				row[k] = u.weights[j * inputs + k] * u_scale;
+			}
+			for (int k = 0; k < outputs; ++k)
+			{
+				row[inputs + k] = w.weights[j * outputs + k] * w_scale;
+			}
+		}
+
+		return;
+	}
+
+
+	/** Inference-only version of @ref forward_lstm_layer().  The four gates are computed with a single GEMM per time
+	 * step from the concatenated input and hidden state, and nothing needed by the backward pass is stored.
+	 */
+	static inline void forward_lstm_layer_fused(Darknet::Layer & l, Darknet::NetworkState & state)
+	{
+		TAT(TATPARMS);
+
+		const int inputs	= l.inputs;
+		const int outputs	= l.outputs;
+		const int row_size	= inputs + outputs;
+		const int gates		= 4 * outputs;
+
+		for (int step = 0; step < l.steps; ++step)
+		{
+			const float * input	= state.input + step * inputs * l.batch;
+			float * output		= l.output + step * outputs * l.batch;
+
+			for (int b = 0; b < l.batch; ++b)
+			{
+				std::memcpy(l.gates_input_cpu + b * row_size			, input + b * inputs		, inputs	* sizeof(float));
+				std::memcpy(l.gates_input_cpu + b * row_size + inputs	, l.h_cpu + b * outputs		, outputs	* sizeof(float));
+				std::memcpy(l.gates_cpu + b * gates						, l.lstm_gate_biases		, gates		* sizeof(float));
+			}
+
+			gemm(0, 1, l.batch, gates, row_size, 1, l.gates_input_cpu, row_size, l.lstm_gate_weights, row_size, 1, l.gates_cpu, gates);
+
+			for (int b = 0; b < l.batch; ++b)
+			{
+				const float * g = l.gates_cpu + b * gates;
+				for (int j = 0; j < outputs; ++j)
+				{
+					const int idx = b * outputs + j;
+					const float forget_gate	= logistic_activate(g[j]);
+					const float input_gate	= logistic_activate(g[outputs + j]);
+					const float cell_gate	= tanh_activate(g[2 * outputs + j]);
+					const float output_gate	= logistic_activate(g[3 * outputs + j]);
+
+					l.c_cpu[idx] = forget_gate * l.c_cpu[idx] + input_gate * cell_gate;
+					l.h_cpu[idx] = output_gate * tanh_activate(l.c_cpu[idx]);
+					output[idx] = l.h_cpu[idx];
+				}
+			}
+		}
+
+		return;
+	}
+}
+
+
+Darknet::Layer make_lstm_layer(int batch, int inputs, int outputs, int steps, int batch_normalize, int train)
 {
 	TAT(TATPARMS);
 
@@ -36,49 +134,49 @@ Darknet::Layer make_lstm_layer(int batch, int inputs, int outputs, int steps, in
 
 	l.uf = (Darknet::Layer*)xcalloc(1, sizeof(Darknet::Layer));
 	fprintf(stderr, "\t\t");
-	*(l.uf) = make_connected_layer(batch, steps, inputs, outputs, LINEAR, batch_normalize);
+	*(l.uf) = make_connected_layer(batch, steps, inputs, outputs, LINEAR, batch_normalize, train);
 	l.uf->batch = batch;
 	if (l.workspace_size < l.uf->workspace_size) l.workspace_size = l.uf->workspace_size;
 
 	l.ui = (Darknet::Layer*)xcalloc(1, sizeof(Darknet::Layer));
 	fprintf(stderr, "\t\t");
-	*(l.ui) = make_connected_layer(batch, steps, inputs, outputs, LINEAR, batch_normalize);
+	*(l.ui) = make_connected_layer(batch, steps, inputs, outputs, LINEAR, batch_normalize, train);
 	l.ui->batch = batch;
 	if (l.workspace_size < l.ui->workspace_size) l.workspace_size = l.ui->workspace_size;
 
 	l.ug = (Darknet::Layer*)xcalloc(1, sizeof(Darknet::Layer));
 	fprintf(stderr, "\t\t");
-	*(l.ug) = make_connected_layer(batch, steps, inputs, outputs, LINEAR, batch_normalize);
+	*(l.ug) = make_connected_layer(batch, steps, inputs, outputs, LINEAR, batch_normalize, train);
 	l.ug->batch = batch;
 	if (l.workspace_size < l.ug->workspace_size) l.workspace_size = l.ug->workspace_size;
 
 	l.uo = (Darknet::Layer*)xcalloc(1, sizeof(Darknet::Layer));
 	fprintf(stderr, "\t\t");
-	*(l.uo) = make_connected_layer(batch, steps, inputs, outputs, LINEAR, batch_normalize);
+	*(l.uo) = make_connected_layer(batch, steps, inputs, outputs, LINEAR, batch_normalize, train);
 	l.uo->batch = batch;
 	if (l.workspace_size < l.uo->workspace_size) l.workspace_size = l.uo->workspace_size;
 
 	l.wf = (Darknet::Layer*)xcalloc(1, sizeof(Darknet::Layer));
 	fprintf(stderr, "\t\t");
-	*(l.wf) = make_connected_layer(batch, steps, outputs, outputs, LINEAR, batch_normalize);
+	*(l.wf) = make_connected_layer(batch, steps, outputs, outputs, LINEAR, batch_normalize, train);
 	l.wf->batch = batch;
 	if (l.workspace_size < l.wf->workspace_size) l.workspace_size = l.wf->workspace_size;
 
 	l.wi = (Darknet::Layer*)xcalloc(1, sizeof(Darknet::Layer));
 	fprintf(stderr, "\t\t");
-	*(l.wi) = make_connected_layer(batch, steps, outputs, outputs, LINEAR, batch_normalize);
+	*(l.wi) = make_connected_layer(batch, steps, outputs, outputs, LINEAR, batch_normalize, train);
 	l.wi->batch = batch;
 	if (l.workspace_size < l.wi->workspace_size) l.workspace_size = l.wi->workspace_size;
 
 	l.wg = (Darknet::Layer*)xcalloc(1, sizeof(Darknet::Layer));
 	fprintf(stderr, "\t\t");
-	*(l.wg) = make_connected_layer(batch, steps, outputs, outputs, LINEAR, batch_normalize);
+	*(l.wg) = make_connected_layer(batch, steps, outputs, outputs, LINEAR, batch_normalize, train);
 	l.wg->batch = batch;
 	if (l.workspace_size < l.wg->workspace_size) l.workspace_size = l.wg->workspace_size;
 
 	l.wo = (Darknet::Layer*)xcalloc(1, sizeof(Darknet::Layer));
 	fprintf(stderr, "\t\t");
-	*(l.wo) = make_connected_layer(batch, steps, outputs, outputs, LINEAR, batch_normalize);
+	*(l.wo) = make_connected_layer(batch, steps, outputs, outputs, LINEAR, batch_normalize, train);
 	l.wo->batch = batch;
 	if (l.workspace_size < l.wo->workspace_size) l.workspace_size = l.wo->workspace_size;
 
@@ -92,8 +190,6 @@ Darknet::Layer make_lstm_layer(int batch, int inputs, int outputs, int steps, in
 	l.update = update_lstm_layer;
 	l.backward = backward_lstm_layer;
 
-	l.prev_state_cpu =  (float*)xcalloc(batch*outputs, sizeof(float));
-	l.prev_cell_cpu =   (float*)xcalloc(batch*outputs, sizeof(float));
 	l.cell_cpu =        (float*)xcalloc(batch*outputs*steps, sizeof(float));
 
 	l.f_cpu =           (float*)xcalloc(batch*outputs, sizeof(float));
@@ -103,10 +199,17 @@ Darknet::Layer make_lstm_layer(int batch, int inputs, int outputs, int steps, in
 	l.c_cpu =           (float*)xcalloc(batch*outputs, sizeof(float));
 	l.h_cpu =           (float*)xcalloc(batch*outputs, sizeof(float));
 	l.temp_cpu =        (float*)xcalloc(batch*outputs, sizeof(float));
-	l.temp2_cpu =       (float*)xcalloc(batch*outputs, sizeof(float));
-	l.temp3_cpu =       (float*)xcalloc(batch*outputs, sizeof(float));
-	l.dc_cpu =          (float*)xcalloc(batch*outputs, sizeof(float));
-	l.dh_cpu =          (float*)xcalloc(batch*outputs, sizeof(float));
+
+	// these are only used by backward_lstm_layer()
+	if (train)
+	{
+		l.prev_state_cpu =  (float*)xcalloc(batch*outputs, sizeof(float));
+		l.prev_cell_cpu =   (float*)xcalloc(batch*outputs, sizeof(float));
+		l.temp2_cpu =       (float*)xcalloc(batch*outputs, sizeof(float));
+		l.temp3_cpu =       (float*)xcalloc(batch*outputs, sizeof(float));
+		l.dc_cpu =          (float*)xcalloc(batch*outputs, sizeof(float));
+		l.dh_cpu =          (float*)xcalloc(batch*outputs, sizeof(float));
+	}
 
 #ifdef GPU
 	l.forward_gpu = forward_lstm_layer_gpu;
@@ -170,6 +273,12 @@ void forward_lstm_layer(Darknet::Layer & l, Darknet::NetworkState state)
 {
 	TAT(TATPARMS);
 
+	if (l.lstm_gate_weights and not state.train)
+	{
+		forward_lstm_layer_fused(l, state);
+		return;
+	}
+
 	Darknet::NetworkState s = { 0 };
 	s.train = state.train;
 	s.workspace = state.workspace;
@@ -184,16 +293,17 @@ void forward_lstm_layer(Darknet::Layer & l, Darknet::NetworkState state)
 	Darknet::Layer & ug = *(l.ug);
 	Darknet::Layer & uo = *(l.uo);
 
-	fill_cpu(l.outputs * l.batch * l.steps, 0, wf.delta, 1);
-	fill_cpu(l.outputs * l.batch * l.steps, 0, wi.delta, 1);
-	fill_cpu(l.outputs * l.batch * l.steps, 0, wg.delta, 1);
-	fill_cpu(l.outputs * l.batch * l.steps, 0, wo.delta, 1);
-
-	fill_cpu(l.outputs * l.batch * l.steps, 0, uf.delta, 1);
-	fill_cpu(l.outputs * l.batch * l.steps, 0, ui.delta, 1);
-	fill_cpu(l.outputs * l.batch * l.steps, 0, ug.delta, 1);
-	fill_cpu(l.outputs * l.batch * l.steps, 0, uo.delta, 1);
 	if (state.train) {
+		fill_cpu(l.outputs * l.batch * l.steps, 0, wf.delta, 1);
+		fill_cpu(l.outputs * l.batch * l.steps, 0, wi.delta, 1);
+		fill_cpu(l.outputs * l.batch * l.steps, 0, wg.delta, 1);
+		fill_cpu(l.outputs * l.batch * l.steps, 0, wo.delta, 1);
+
+		fill_cpu(l.outputs * l.batch * l.steps, 0, uf.delta, 1);
+		fill_cpu(l.outputs * l.batch * l.steps, 0, ui.delta, 1);
+		fill_cpu(l.outputs * l.batch * l.steps, 0, ug.delta, 1);
+		fill_cpu(l.outputs * l.batch * l.steps, 0, uo.delta, 1);
+
 		fill_cpu(l.outputs * l.batch * l.steps, 0, l.delta, 1);
 	}
 
@@ -253,6 +363,20 @@ void forward_lstm_layer(Darknet::Layer & l, Darknet::NetworkState state)
 		increment_layer(&ug, 1);
 		increment_layer(&uo, 1);
 	}
+
+	// the layer and sublayers are references, so rewind them for the next call
+	l.output	-= l.outputs*l.batch*l.steps;
+	l.cell_cpu	-= l.outputs*l.batch*l.steps;
+
+	increment_layer(&wf, -l.steps);
+	increment_layer(&wi, -l.steps);
+	increment_layer(&wg, -l.steps);
+	increment_layer(&wo, -l.steps);
+
+	increment_layer(&uf, -l.steps);
+	increment_layer(&ui, -l.steps);
+	increment_layer(&ug, -l.steps);
+	increment_layer(&uo, -l.steps);
 }
 
 void backward_lstm_layer(Darknet::Layer & l, Darknet::NetworkState state)
@@ -399,6 +523,54 @@ void backward_lstm_layer(Darknet::Layer & l, Darknet::NetworkState state)
 		increment_layer(&ug, -1);
 		increment_layer(&uo, -1);
 	}
+
+	// the loop above stops one step before the start of the buffers
+	l.output	+= l.outputs*l.batch;
+	l.cell_cpu	+= l.outputs*l.batch;
+	l.delta		+= l.outputs*l.batch;
+
+	increment_layer(&wf, 1);
+	increment_layer(&wi, 1);
+	increment_layer(&wg, 1);
+	increment_layer(&wo, 1);
+
+	increment_layer(&uf, 1);
+	increment_layer(&ui, 1);
+	increment_layer(&ug, 1);
+	increment_layer(&uo, 1);
+}
+
+bool prepare_lstm_layer_inference(Darknet::Layer & l)
+{
+	TAT(TATPARMS);
+
+	if (l.type != Darknet::ELayerType::LSTM)
+	{
+		return false;
+	}
+
+	const int row_size	= l.inputs + l.outputs;
+	const int gates		= 4 * l.outputs;
+
+	// a clone which shares the weights of another network already has the packed gates
+	if (l.lstm_gate_weights == nullptr)
+	{
+		l.lstm_gate_weights	= (float*)xcalloc(gates * row_size, sizeof(float));
+		l.lstm_gate_biases	= (float*)xcalloc(gates, sizeof(float));
+
+		pack_lstm_gate(*l.uf, *l.wf, l.lstm_gate_weights + 0 * l.outputs * row_size, l.lstm_gate_biases + 0 * l.outputs);
+		pack_lstm_gate(*l.ui, *l.wi, l.lstm_gate_weights + 1 * l.outputs * row_size, l.lstm_gate_biases + 1 * l.outputs);
+		pack_lstm_gate(*l.ug, *l.wg, l.lstm_gate_weights + 2 * l.outputs * row_size, l.lstm_gate_biases + 2 * l.outputs);
+		pack_lstm_gate(*l.uo, *l.wo, l.lstm_gate_weights + 3 * l.outputs * row_size, l.lstm_gate_biases + 3 * l.outputs);
+	}
+
+	if (l.gates_cpu == nullptr)
+	{
+		l.gates_cpu			= (float*)xcalloc(l.batch * gates, sizeof(float));
+		l.gates_input_cpu	= (float*)xcalloc(l.batch * row_size, sizeof(float));
+	}
+
+	return true;
 }
 
 #ifdef GPU
@@ -5,12 +5,21 @@
 /// @todo what is this?
 #define USET
 
-Darknet::Layer make_lstm_layer(int batch, int inputs, int outputs, int steps, int batch_normalize);
+Darknet::Layer make_lstm_layer(int batch, int inputs, int outputs, int steps, int batch_normalize, int train);
 
 void forward_lstm_layer(Darknet::Layer & l, Darknet::NetworkState state);
 void backward_lstm_layer(Darknet::Layer & l, Darknet::NetworkState state);
 void update_lstm_layer(Darknet::Layer & l, int batch, float learning_rate, float momentum, float decay);
 
+/** Pack the eight gate sublayers of an LSTM layer into a single (4 x outputs) by (inputs + outputs) matrix so CPU
+ * inference can compute every gate with one GEMM per time step.  Batch norm is folded into the packed weights.  The
+ * sublayers are left as-is for training and for saving the weights.  Returns @p false if @p l is not an LSTM layer.
+ *
+ * @see @ref prepare_lstm_inference()
+ * @since 2026-10-17
+ */
+bool prepare_lstm_layer_inference(Darknet::Layer & l);
+
 #ifdef GPU
 void forward_lstm_layer_gpu(Darknet::Layer & l, Darknet::NetworkState state);
 void backward_lstm_layer_gpu(Darknet::Layer & l, Darknet::NetworkState state);
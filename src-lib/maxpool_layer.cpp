@@ -342,6 +342,50 @@ void forward_maxpool_layer(Darknet::Layer & l, Darknet::NetworkState state)
 	}
 }
 
+void forward_maxpool_layer_nhwc(Darknet::Layer & l, Darknet::NetworkState state)
+{
+	TAT(TATPARMS);
+
+	// same window and padding as forward_maxpool_layer(), but the max is taken over all channels of a pixel at once
+	const int w_offset = -l.pad / 2;
+	const int h_offset = -l.pad / 2;
+	const int c = l.c;
+
+	#pragma omp parallel for
+	for (int row = 0; row < l.batch * l.out_h; ++row)
+	{
+		const int b = row / l.out_h;
+		const int i = row % l.out_h;
+		for (int j = 0; j < l.out_w; ++j)
+		{
+			float * out = l.output + (static_cast<size_t>(row) * l.out_w + j) * c;
+			std::fill_n(out, c, -FLT_MAX);
+
+			for (int n = 0; n < l.size; ++n)
+			{
+				const int cur_h = h_offset + i * l.stride_y + n;
+				if (cur_h < 0 || cur_h >= l.h)
+				{
+					continue;
+				}
+				for (int m = 0; m < l.size; ++m)
+				{
+					const int cur_w = w_offset + j * l.stride_x + m;
+					if (cur_w < 0 || cur_w >= l.w)
+					{
+						continue;
+					}
+					const float * in = state.input + ((static_cast<size_t>(b) * l.h + cur_h) * l.w + cur_w) * c;
+					for (int k = 0; k < c; ++k)
+					{
+						out[k] = (in[k] > out[k]) ? in[k] : out[k];
+					}
+				}
+			}
+		}
+	}
+}
+
 void backward_maxpool_layer(Darknet::Layer & l, Darknet::NetworkState state)
 {
 	TAT(TATPARMS);
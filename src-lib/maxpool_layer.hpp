@@ -6,6 +6,7 @@ Darknet::Image get_maxpool_image(Darknet::Layer & l);
 Darknet::Layer make_maxpool_layer(int batch, int h, int w, int c, int size, int stride_x, int stride_y, int padding, int maxpool_depth, int out_channels, int antialiasing, int avgpool, int train);
 void resize_maxpool_layer(Darknet::Layer *l, int w, int h);
 void forward_maxpool_layer(Darknet::Layer & l, Darknet::NetworkState state);
+void forward_maxpool_layer_nhwc(Darknet::Layer & l, Darknet::NetworkState state); ///< @see @ref prepare_channels_last()  @since 2026-10-17
 void backward_maxpool_layer(Darknet::Layer & l, Darknet::NetworkState state);
 
 void forward_local_avgpool_layer(Darknet::Layer & l, Darknet::NetworkState state);
@@ -6,19 +6,21 @@ static void increment_layer(Darknet::Layer *l, int steps)
 
 	int num = l->outputs*l->batch*steps;
 	l->output += num;
-	l->delta += num;
-	l->x += num;
-	l->x_norm += num;
+
+	// these buffers are only allocated when training
+	if (l->delta)	l->delta += num;
+	if (l->x)		l->x += num;
+	if (l->x_norm)	l->x_norm += num;
 
 #ifdef GPU
 	l->output_gpu += num;
-	l->delta_gpu += num;
-	l->x_gpu += num;
-	l->x_norm_gpu += num;
+	if (l->delta_gpu)	l->delta_gpu += num;
+	if (l->x_gpu)		l->x_gpu += num;
+	if (l->x_norm_gpu)	l->x_norm_gpu += num;
 #endif
 }
 
-Darknet::Layer make_rnn_layer(int batch, int inputs, int hidden, int outputs, int steps, ACTIVATION activation, int batch_normalize, int log)
+Darknet::Layer make_rnn_layer(int batch, int inputs, int hidden, int outputs, int steps, ACTIVATION activation, int batch_normalize, int log, int train)
 {
 	TAT(TATPARMS);
 
@@ -38,19 +40,19 @@ Darknet::Layer make_rnn_layer(int batch, int inputs, int hidden, int outputs, in
 
 	l.input_layer = (Darknet::Layer*)xcalloc(1, sizeof(Darknet::Layer));
 	fprintf(stderr, "\t\t");
-	*(l.input_layer) = make_connected_layer(batch, steps, inputs, hidden, activation, batch_normalize);
+	*(l.input_layer) = make_connected_layer(batch, steps, inputs, hidden, activation, batch_normalize, train);
 	l.input_layer->batch = batch;
 	if (l.workspace_size < l.input_layer->workspace_size) l.workspace_size = l.input_layer->workspace_size;
 
 	l.self_layer = (Darknet::Layer*)xcalloc(1, sizeof(Darknet::Layer));
 	fprintf(stderr, "\t\t");
-	*(l.self_layer) = make_connected_layer(batch, steps, hidden, hidden, (log==2)?LOGGY:(log==1?LOGISTIC:activation), batch_normalize);
+	*(l.self_layer) = make_connected_layer(batch, steps, hidden, hidden, (log==2)?LOGGY:(log==1?LOGISTIC:activation), batch_normalize, train);
 	l.self_layer->batch = batch;
 	if (l.workspace_size < l.self_layer->workspace_size) l.workspace_size = l.self_layer->workspace_size;
 
 	l.output_layer = (Darknet::Layer*)xcalloc(1, sizeof(Darknet::Layer));
 	fprintf(stderr, "\t\t");
-	*(l.output_layer) = make_connected_layer(batch, steps, hidden, outputs, activation, batch_normalize);
+	*(l.output_layer) = make_connected_layer(batch, steps, hidden, outputs, activation, batch_normalize, train);
 	l.output_layer->batch = batch;
 	if (l.workspace_size < l.output_layer->workspace_size) l.workspace_size = l.output_layer->workspace_size;
 
@@ -94,10 +96,13 @@ void forward_rnn_layer(Darknet::Layer & l, Darknet::NetworkState state)
 	Darknet::Layer & self_layer = *(l.self_layer);
 	Darknet::Layer & output_layer = *(l.output_layer);
 
-	fill_cpu(l.outputs * l.batch * l.steps, 0, output_layer.delta, 1);
-	fill_cpu(l.hidden * l.batch * l.steps, 0, self_layer.delta, 1);
-	fill_cpu(l.hidden * l.batch * l.steps, 0, input_layer.delta, 1);
-	if(state.train) fill_cpu(l.hidden * l.batch, 0, l.state, 1);
+	if (state.train)
+	{
+		fill_cpu(l.outputs * l.batch * l.steps, 0, output_layer.delta, 1);
+		fill_cpu(l.hidden * l.batch * l.steps, 0, self_layer.delta, 1);
+		fill_cpu(l.hidden * l.batch * l.steps, 0, input_layer.delta, 1);
+		fill_cpu(l.hidden * l.batch, 0, l.state, 1);
+	}
 
 	for (i = 0; i < l.steps; ++i) {
 
@@ -125,6 +130,15 @@ void forward_rnn_layer(Darknet::Layer & l, Darknet::NetworkState state)
 		increment_layer(&self_layer, 1);
 		increment_layer(&output_layer, 1);
 	}
+
+	// the layer and sublayers are references, so rewind them for the next call
+	if (state.train)
+	{
+		l.state -= l.hidden*l.batch*l.steps;
+	}
+	increment_layer(&input_layer, -l.steps);
+	increment_layer(&self_layer, -l.steps);
+	increment_layer(&output_layer, -l.steps);
 }
 
 void backward_rnn_layer(Darknet::Layer & l, Darknet::NetworkState state)
@@ -178,6 +192,11 @@ void backward_rnn_layer(Darknet::Layer & l, Darknet::NetworkState state)
 		increment_layer(&self_layer, -1);
 		increment_layer(&output_layer, -1);
 	}
+
+	// the loop above stops one step before the start of the buffers
+	increment_layer(&input_layer, 1);
+	increment_layer(&self_layer, 1);
+	increment_layer(&output_layer, 1);
 }
 
 #ifdef GPU
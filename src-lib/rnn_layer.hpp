@@ -5,7 +5,7 @@
 /// @todo what is this?
 #define USET
 
-Darknet::Layer make_rnn_layer(int batch, int inputs, int hidden, int outputs, int steps, ACTIVATION activation, int batch_normalize, int log);
+Darknet::Layer make_rnn_layer(int batch, int inputs, int hidden, int outputs, int steps, ACTIVATION activation, int batch_normalize, int log, int train);
 
 void forward_rnn_layer(Darknet::Layer & l, Darknet::NetworkState state);
 void backward_rnn_layer(Darknet::Layer & l, Darknet::NetworkState state);
@@ -99,6 +99,29 @@ void forward_route_layer(Darknet::Layer & l, Darknet::NetworkState state)
 	}
 }
 
+void forward_route_layer_nhwc(Darknet::Layer & l, Darknet::NetworkState state)
+{
+	TAT(TATPARMS);
+
+	// with channels-last data each input contributes a slice of channels to every pixel
+	const int spatial = l.out_w * l.out_h;
+	int offset = 0;
+	for (int i = 0; i < l.n; ++i)
+	{
+		const Darknet::Layer & input_layer = state.net.layers[l.input_layers[i]];
+		const int input_c = input_layer.out_c;
+		const int part_c = input_c / l.groups;
+		const float * input = input_layer.output + part_c * l.group_id;
+
+		#pragma omp parallel for
+		for (int p = 0; p < l.batch * spatial; ++p)
+		{
+			memcpy(l.output + static_cast<size_t>(p) * l.out_c + offset, input + static_cast<size_t>(p) * input_c, part_c * sizeof(float));
+		}
+		offset += part_c;
+	}
+}
+
 void backward_route_layer(Darknet::Layer & l, Darknet::NetworkState state)
 {
 	TAT(TATPARMS);
@@ -4,6 +4,7 @@
 
 Darknet::Layer make_route_layer(int batch, int n, int *input_layers, int *input_size, int groups, int group_id);
 void forward_route_layer(Darknet::Layer & l, Darknet::NetworkState state);
+void forward_route_layer_nhwc(Darknet::Layer & l, Darknet::NetworkState state); ///< @see @ref prepare_channels_last()  @since 2026-10-17
 void backward_route_layer(Darknet::Layer & l, Darknet::NetworkState state);
 void resize_route_layer(Darknet::Layer *l, Darknet::Network *net);
 
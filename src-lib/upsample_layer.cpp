@@ -81,6 +81,31 @@ void forward_upsample_layer(Darknet::Layer & l, Darknet::NetworkState state)
 	}
 }
 
+void forward_upsample_layer_nhwc(Darknet::Layer & l, Darknet::NetworkState state)
+{
+	TAT(TATPARMS);
+
+	// upsampling only (not reverse) -- each input pixel is copied with all its channels at once
+	const int c = l.c;
+	#pragma omp parallel for
+	for (int row = 0; row < l.batch * l.out_h; ++row)
+	{
+		const int b = row / l.out_h;
+		const int y = row % l.out_h;
+		const float * in = state.input + (static_cast<size_t>(b) * l.h + y / l.stride) * l.w * c;
+		float * out = l.output + static_cast<size_t>(row) * l.out_w * c;
+		for (int x = 0; x < l.out_w; ++x)
+		{
+			const float * src = in + static_cast<size_t>(x / l.stride) * c;
+			for (int k = 0; k < c; ++k)
+			{
+				out[k] = l.scale * src[k];
+			}
+			out += c;
+		}
+	}
+}
+
 void backward_upsample_layer(Darknet::Layer & l, Darknet::NetworkState state)
 {
 	TAT(TATPARMS);
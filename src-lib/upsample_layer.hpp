@@ -4,6 +4,7 @@
 
 Darknet::Layer make_upsample_layer(int batch, int w, int h, int c, int stride);
 void forward_upsample_layer(Darknet::Layer & l, Darknet::NetworkState state);
+void forward_upsample_layer_nhwc(Darknet::Layer & l, Darknet::NetworkState state); ///< @see @ref prepare_channels_last()  @since 2026-10-17
 void backward_upsample_layer(Darknet::Layer & l, Darknet::NetworkState state);
 void resize_upsample_layer(Darknet::Layer *l, int w, int h);
 
@@ -1,21 +1,617 @@
 #include "option_list.hpp"
 #include "darknet_internal.hpp"
 
+
+/** A .weights file which is read on a background thread, see @ref prefetch_weights().  Only a small window of the file
+ * is kept in memory:  the reader waits once @ref window_chunks chunks are waiting to be used, and a chunk is freed
+ * once every registered reader has moved past it.
+ */
+struct Weights_Prefetch final
+{
+	~Weights_Prefetch()
+	{
+		if (true)
+		{
+			std::lock_guard lock(mutex);
+			cancelled = true;
+			cv.notify_all();
+		}
+		if (reader.joinable())
+		{
+			reader.join();
+		}
+	}
+
+	/// Register a reader which starts at @p position.  Bytes are kept in memory until every reader has moved past them.
+	size_t add_reader(const size_t position)
+	{
+		std::lock_guard lock(mutex);
+		reader_positions.push_back(position);
+
+		return reader_positions.size() - 1;
+	}
+
+	/// Move a reader to @p position, or pass @p SIZE_MAX once the reader is finished.
+	void move_reader(const size_t id, const size_t position)
+	{
+		std::lock_guard lock(mutex);
+		reader_positions[id] = position;
+
+		// free the chunks which none of the readers need anymore
+		const size_t lowest = *std::min_element(reader_positions.begin(), reader_positions.end());
+		while (not chunks.empty() and (first_chunk + 1) * chunk_size <= lowest)
+		{
+			chunks.pop_front();
+			first_chunk ++;
+		}
+		cv.notify_all();
+
+		return;
+	}
+
+	/** Copy @p bytes starting at @p position into @p dst, blocking until each part of the file has been read.
+	 * @returns @p false if the reader stopped before the end of the range
+	 */
+	bool copy(uint8_t * dst, size_t position, size_t bytes)
+	{
+		while (bytes > 0)
+		{
+			std::unique_lock lock(mutex);
+			cv.wait(lock, [&]() { return done or available > position; });
+			if (available <= position)
+			{
+				return false;
+			}
+
+			const size_t idx = position / chunk_size;
+			if (idx < first_chunk)
+			{
+				darknet_fatal_error(DARKNET_LOC, "part of %s was read after it was released", filename.c_str());
+			}
+
+			// the calling reader is registered at or before this position, so the chunk cannot be freed while it is copied
+			const uint8_t * src = chunks[idx - first_chunk].get() + position % chunk_size;
+			const size_t n = std::min({bytes, (idx + 1) * chunk_size - position, available - position});
+			lock.unlock();
+
+			std::memcpy(dst, src, n);
+			dst			+= n;
+			position	+= n;
+			bytes		-= n;
+		}
+
+		return true;
+	}
+
+	/// Large sequential reads, and each one is handed over as soon as it is available.
+	static constexpr size_t chunk_size = 16 * 1024 * 1024;
+
+	/// Maximum number of chunks kept in memory.
+	static constexpr size_t window_chunks = 4;
+
+	std::string filename;
+	size_t size = 0;						///< size of the file in bytes
+	std::deque<std::unique_ptr<uint8_t[]>> chunks;	///< the part of the file which is in memory
+	size_t first_chunk = 0;					///< index within the file of the first entry in @ref chunks
+	size_t available = 0;					///< number of bytes from the start of the file which have been read
+	std::vector<size_t> reader_positions;	///< see @ref add_reader()
+	bool done = false;						///< set once the reader has stopped, even if the file could not be read
+	bool cancelled = false;
+	std::mutex mutex;
+	std::condition_variable cv;
+	std::thread reader;
+};
+
 namespace
 {
 	static auto & cfg_and_state = Darknet::CfgAndState::get();
 
 
-	inline void xfread(void * dst, const size_t size, const size_t count, std::FILE * fp)
+	/// @p unit describes what is being counted, such as @p "fields" or @p "bytes".
+	static inline void weights_too_short(const size_t expected, const size_t available, const char * unit)
+	{
+		Darknet::display_warning_msg(
+			"The .weights file does not match the .cfg file (not enough fields to read in the weights).\n"
+			"Normally this means the .weights file was corrupted, or you've mixed up which .cfg file goes with which .weights file.\n");
+
+		darknet_fatal_error(DARKNET_LOC, "expected to read %lu %s, but only %lu are available", expected, unit, available);
+	}
+
+
+	/** Where the weights are read from:  either directly from the file, or from part of the buffer which
+	 * @ref Weights_Prefetch is filling in on a background thread.
+	 */
+	class Weights_Source final
+	{
+		public:
+
+			explicit Weights_Source(std::FILE * f) :
+				fp(f),
+				prefetch(nullptr),
+				id(0),
+				start(0),
+				end(0),
+				pos(0)
+			{
+				return;
+			}
+
+			/// Read the bytes in the range [@p first, @p last) of the prefetched file.
+			Weights_Source(Weights_Prefetch & p, const size_t first, const size_t last) :
+				fp(nullptr),
+				prefetch(&p),
+				id(p.add_reader(first)),
+				start(first),
+				end(last),
+				pos(first)
+			{
+				return;
+			}
+
+			~Weights_Source()
+			{
+				if (prefetch)
+				{
+					prefetch->move_reader(id, SIZE_MAX);
+				}
+			}
+
+			Weights_Source(const Weights_Source &) = delete;
+			Weights_Source & operator=(const Weights_Source &) = delete;
+
+			/// Read up to @p count fields.  @returns the number of fields read.
+			size_t read_some(void * dst, const size_t size, const size_t count)
+			{
+				if (fp)
+				{
+					return std::fread(dst, size, count, fp);
+				}
+
+				const size_t items = std::min(count, (end - pos) / size);
+				const size_t bytes = items * size;
+				if (not prefetch->copy(static_cast<uint8_t *>(dst), pos, bytes))
+				{
+					darknet_fatal_error(DARKNET_LOC, "failed to read %s", prefetch->filename.c_str());
+				}
+				pos += bytes;
+				prefetch->move_reader(id, pos);
+
+				return items;
+			}
+
+			/// Read @p count fields, or abort if the file is too short.
+			void read(void * dst, const size_t size, const size_t count)
+			{
+				const auto items_read = read_some(dst, size, count);
+				if (items_read != count)
+				{
+					weights_too_short(count, items_read, "fields");
+				}
+
+				return;
+			}
+
+			/// Position in the file.
+			size_t position() const
+			{
+				return fp ? std::ftell(fp) : pos;
+			}
+
+			void seek(const size_t offset)
+			{
+				if (fp)
+				{
+					std::fseek(fp, offset, SEEK_SET);
+				}
+				else
+				{
+					pos = std::clamp(offset, start, end);
+					prefetch->move_reader(id, pos);
+				}
+
+				return;
+			}
+
+			/// Only files can be read past the end, since the size of the prefetched data is known ahead of time.
+			bool eof() const
+			{
+				return fp and std::feof(fp);
+			}
+
+		private:
+
+			std::FILE * fp;
+			Weights_Prefetch * prefetch;
+			size_t id;	///< see @ref Weights_Prefetch::add_reader()
+			size_t start;
+			size_t end;
+			size_t pos;
+	};
+
+
+	/// Marks the optional INT8 section appended to a .weights file by @ref save_int8_weights().
+	static const char int8_weights_signature[16] = "DARKNET-INT8-V1";
+
+
+	/** Load the INT8 section which follows the normal weights, if there is one.  Otherwise the file position is left
+	 * unchanged and @p false is returned.
+	 */
+	bool load_int8_weights(Darknet::Network & net, Weights_Source & src)
+	{
+		TAT(TATPARMS);
+
+		const auto start = src.position();
+		char signature[sizeof(int8_weights_signature)] = { 0 };
+		if (src.read_some(signature, 1, sizeof(signature)) != sizeof(signature) or
+			std::memcmp(signature, int8_weights_signature, sizeof(signature)) != 0)
+		{
+			src.seek(start);
+			return false;
+		}
+
+		int32_t count = 0;
+		src.read(&count, sizeof(int32_t), 1);
+		for (int32_t i = 0; i < count; ++i)
+		{
+			int32_t idx			= 0;
+			int32_t n			= 0;
+			int32_t row_size	= 0;
+			float input_scale	= 0.0f;
+			int32_t zero_point	= 0;
+			src.read(&idx			, sizeof(int32_t)	, 1);
+			src.read(&n			, sizeof(int32_t)	, 1);
+			src.read(&row_size	, sizeof(int32_t)	, 1);
+			src.read(&input_scale	, sizeof(float)		, 1);
+			src.read(&zero_point	, sizeof(int32_t)	, 1);
+
+			if (idx < 0 or idx >= net.n or net.layers[idx].type != Darknet::ELayerType::CONVOLUTIONAL or n != net.layers[idx].n or row_size <= 0)
+			{
+				darknet_fatal_error(DARKNET_LOC, "INT8 weights for layer #%d do not match the .cfg file", idx);
+			}
+
+			std::vector<float> scales(n);
+			std::vector<int8_t> weights(static_cast<size_t>(n) * row_size);
+			src.read(scales.data()	, sizeof(float)	, scales.size()	);
+			src.read(weights.data()	, sizeof(int8_t), weights.size());
+
+			set_convolutional_layer_int8(net.layers[idx], input_scale, zero_point, scales, weights);
+		}
+
+		if (count > 0 and cfg_and_state.gpu_index < 0)
+		{
+			// the quantized input and columns are stored in the workspace
+			recalculate_workspace_size(&net);
+		}
+
+		if (cfg_and_state.is_verbose)
+		{
+			std::cout << "Loaded INT8 weights for " << count << " convolutional layer" << (count == 1 ? "" : "s") << std::endl;
+		}
+
+		return true;
+	}
+
+
+	/// Marks a memory-mapped weights file written by @ref save_mapped_weights().
+	static const char mapped_weights_signature[16] = "DARKNET-MMAP-V1";
+
+	/// Every tensor in a memory-mapped weights file starts on a 64-byte boundary, which suits AVX-512 and cache lines.
+	static const uint64_t mapped_weights_alignment = 64;
+
+
+	/// The fixed-size header at the start of a memory-mapped weights file.
+	struct Mapped_Weights_Header
+	{
+		char		signature[16];
+		int32_t		major;
+		int32_t		minor;
+		int32_t		revision;
+		int32_t		layers;		///< number of layers in the network which wrote the file
+		uint64_t	seen;
+		uint64_t	tensors;	///< number of entries in the tensor table which immediately follows the header
+	};
+	static_assert(sizeof(Mapped_Weights_Header) == 48);
+
+
+	/// One entry in the tensor table of a memory-mapped weights file.
+	struct Mapped_Weights_Entry
+	{
+		int32_t		layer;		///< index of the layer in the network
+		int32_t		tensor;		///< index of the tensor within the layer, see @ref get_mapped_tensors()
+		uint64_t	count;		///< number of floats
+		uint64_t	offset;		///< position in the file, always a multiple of @ref mapped_weights_alignment
+	};
+	static_assert(sizeof(Mapped_Weights_Entry) == 24);
+
+
+	/// A buffer which can be stored in a memory-mapped weights file.  Sublayers (RNN, LSTM, CRNN) have their own entries.
+	struct Mapped_Tensor
+	{
+		Darknet::Layer * layer;
+		float ** ptr;
+		uint64_t count;
+	};
+
+
+	static inline void add_convolutional_tensors(std::vector<Mapped_Tensor> & tensors, Darknet::Layer & l)
+	{
+		TAT(TATPARMS);
+
+		tensors.push_back({&l, &l.biases, static_cast<uint64_t>(l.n)});
+		if (l.batch_normalize)
+		{
+			tensors.push_back({&l, &l.scales			, static_cast<uint64_t>(l.n)});
+			tensors.push_back({&l, &l.rolling_mean		, static_cast<uint64_t>(l.n)});
+			tensors.push_back({&l, &l.rolling_variance	, static_cast<uint64_t>(l.n)});
+		}
+		tensors.push_back({&l, &l.weights, static_cast<uint64_t>(l.nweights)});
+
+		return;
+	}
+
+
+	static inline void add_connected_tensors(std::vector<Mapped_Tensor> & tensors, Darknet::Layer & l)
+	{
+		TAT(TATPARMS);
+
+		tensors.push_back({&l, &l.biases	, static_cast<uint64_t>(l.outputs)});
+		tensors.push_back({&l, &l.weights	, static_cast<uint64_t>(l.outputs) * l.inputs});
+		if (l.batch_normalize)
+		{
+			tensors.push_back({&l, &l.scales			, static_cast<uint64_t>(l.outputs)});
+			tensors.push_back({&l, &l.rolling_mean		, static_cast<uint64_t>(l.outputs)});
+			tensors.push_back({&l, &l.rolling_variance	, static_cast<uint64_t>(l.outputs)});
+		}
+
+		return;
+	}
+
+
+	/** Get the buffers of a layer which are stored in a memory-mapped weights file, in the same order as the classic
+	 * .weights file.  Only call this once @ref fuse_conv_batchnorm() has removed the batch norm of convolutional layers.
+	 */
+	std::vector<Mapped_Tensor> get_mapped_tensors(Darknet::Layer & l)
+	{
+		TAT(TATPARMS);
+
+		std::vector<Mapped_Tensor> tensors;
+
+		switch (l.type)
+		{
+			case Darknet::ELayerType::CONVOLUTIONAL:
+			{
+				if (l.share_layer == nullptr)
+				{
+					add_convolutional_tensors(tensors, l);
+				}
+				break;
+			}
+			case Darknet::ELayerType::SHORTCUT:
+			{
+				if (l.nweights > 0)
+				{
+					tensors.push_back({&l, &l.weights, static_cast<uint64_t>(l.nweights)});
+				}
+				break;
+			}
+			case Darknet::ELayerType::CONNECTED:
+			{
+				add_connected_tensors(tensors, l);
+				break;
+			}
+			case Darknet::ELayerType::CRNN:
+			{
+				add_convolutional_tensors(tensors, *l.input_layer);
+				add_convolutional_tensors(tensors, *l.self_layer);
+				add_convolutional_tensors(tensors, *l.output_layer);
+				break;
+			}
+			case Darknet::ELayerType::RNN:
+			{
+				add_connected_tensors(tensors, *l.input_layer);
+				add_connected_tensors(tensors, *l.self_layer);
+				add_connected_tensors(tensors, *l.output_layer);
+				break;
+			}
+			case Darknet::ELayerType::LSTM:
+			{
+				for (Darknet::Layer * sublayer : {l.wf, l.wi, l.wg, l.wo, l.uf, l.ui, l.ug, l.uo})
+				{
+					add_connected_tensors(tensors, *sublayer);
+				}
+				break;
+			}
+			default:
+			{
+				// this layer does not have weights
+				break;
+			}
+		}
+
+		return tensors;
+	}
+
+
+#ifdef GPU
+	/// Copy the weights of a layer between the GPU and the CPU.
+	void sync_mapped_tensors(Darknet::Layer & l, const bool push)
+	{
+		TAT(TATPARMS);
+
+		auto sync_convolutional	= (push ? push_convolutional_layer	: pull_convolutional_layer	);
+		auto sync_connected		= (push ? push_connected_layer		: pull_connected_layer		);
+
+		switch (l.type)
+		{
+			case Darknet::ELayerType::CONVOLUTIONAL:	sync_convolutional(l);								break;
+			case Darknet::ELayerType::SHORTCUT:		(push ? push_shortcut_layer : pull_shortcut_layer)(l);	break;
+			case Darknet::ELayerType::CONNECTED:		sync_connected(l);									break;
+			case Darknet::ELayerType::CRNN:
+			{
+				sync_convolutional(*l.input_layer);
+				sync_convolutional(*l.self_layer);
+				sync_convolutional(*l.output_layer);
+				break;
+			}
+			case Darknet::ELayerType::RNN:
+			{
+				sync_connected(*l.input_layer);
+				sync_connected(*l.self_layer);
+				sync_connected(*l.output_layer);
+				break;
+			}
+			case Darknet::ELayerType::LSTM:
+			{
+				for (Darknet::Layer * sublayer : {l.wf, l.wi, l.wg, l.wo, l.uf, l.ui, l.ug, l.uo})
+				{
+					sync_connected(*sublayer);
+				}
+				break;
+			}
+			default:
+			{
+				break;
+			}
+		}
+
+		return;
+	}
+#endif
+
+
+	/** Point the weights of every layer directly into a memory-mapped weights file, replacing the buffers which were
+	 * allocated when the network was created.  The mapping is kept alive by @ref Darknet::NetworkDetails::mapped_weights.
+	 */
+	void load_mapped_weights(Darknet::Network & net, const char * filename, const int cutoff)
 	{
-		const auto items_read = std::fread(dst, size, count, fp);
-		if (items_read != count)
+		TAT(TATPARMS);
+
+		uint64_t size = 0;
+		std::shared_ptr<void> mapping = Darknet::map_file(filename, size);
+		const uint8_t * base = static_cast<const uint8_t *>(mapping.get());
+
+		if (size < sizeof(Mapped_Weights_Header))
+		{
+			darknet_fatal_error(DARKNET_LOC, "the memory-mapped weights file %s is truncated (%lu bytes, the header alone needs %lu)", filename, size, sizeof(Mapped_Weights_Header));
+		}
+
+		const Mapped_Weights_Header & header = *reinterpret_cast<const Mapped_Weights_Header *>(base);
+		if (header.layers != net.n)
+		{
+			darknet_fatal_error(DARKNET_LOC, "the memory-mapped weights file %s does not match the .cfg file (layers=%d, expected %d)", filename, header.layers, net.n);
+		}
+
+		if (header.tensors > (size - sizeof(Mapped_Weights_Header)) / sizeof(Mapped_Weights_Entry))
+		{
+			darknet_fatal_error(DARKNET_LOC, "the memory-mapped weights file %s is truncated (the tensor table needs %lu entries)", filename, header.tensors);
+		}
+
+		*net.seen = header.seen;
+		*net.cur_iteration = get_current_batch(net);
+
+		std::vector<std::vector<Mapped_Tensor>> tensors(net.n);
+		for (int idx = 0; idx < net.n and idx < cutoff; ++idx)
+		{
+			Darknet::Layer & l = net.layers[idx];
+			if (l.dontload)
+			{
+				continue;
+			}
+
+			// the file was written after fuse_conv_batchnorm(), so do the same to the layers before the tensors are matched
+			if (l.type == Darknet::ELayerType::CONVOLUTIONAL and l.batch_normalize)
+			{
+				free_convolutional_batchnorm(&l);
+				l.batch_normalize = 0;
+			}
+			else if (l.type == Darknet::ELayerType::SHORTCUT)
+			{
+				l.weights_normalization = NO_NORMALIZATION;
+			}
+
+			tensors[idx] = get_mapped_tensors(l);
+		}
+
+		// validate the whole table before any of the layers are modified
+		std::vector<std::vector<float *>> mapped(net.n);
+		for (int idx = 0; idx < net.n; ++idx)
+		{
+			mapped[idx].resize(tensors[idx].size(), nullptr);
+		}
+
+		const Mapped_Weights_Entry * table = reinterpret_cast<const Mapped_Weights_Entry *>(base + sizeof(Mapped_Weights_Header));
+		for (uint64_t i = 0; i < header.tensors; ++i)
 		{
-			Darknet::display_warning_msg(
-				"The .weights file does not match the .cfg file (not enough fields to read in the weights).\n"
-				"Normally this means the .weights file was corrupted, or you've mixed up which .cfg file goes with which .weights file.\n");
+			const Mapped_Weights_Entry & entry = table[i];
+			if (entry.layer < 0 or entry.layer >= net.n)
+			{
+				darknet_fatal_error(DARKNET_LOC, "the memory-mapped weights file %s does not match the .cfg file (tensor #%lu references layer #%d)", filename, i, entry.layer);
+			}
+
+			if (tensors[entry.layer].empty())
+			{
+				// layer was skipped due to "cutoff" or "dontload"
+				continue;
+			}
+
+			if (entry.tensor < 0																	or
+				static_cast<size_t>(entry.tensor) >= tensors[entry.layer].size()					or
+				entry.count != tensors[entry.layer][entry.tensor].count								or
+				entry.offset % mapped_weights_alignment != 0										or
+				entry.offset > size																	or
+				entry.count > (size - entry.offset) / sizeof(float)									or
+				mapped[entry.layer][entry.tensor] != nullptr)
+			{
+				darknet_fatal_error(DARKNET_LOC, "the memory-mapped weights file %s does not match the .cfg file (layer #%d, tensor #%d)", filename, entry.layer, entry.tensor);
+			}
+
+			mapped[entry.layer][entry.tensor] = reinterpret_cast<float *>(const_cast<uint8_t *>(base) + entry.offset);
+		}
+
+		size_t layers_with_weights = 0;
+		for (int idx = 0; idx < net.n; ++idx)
+		{
+			if (tensors[idx].empty())
+			{
+				continue;
+			}
+
+			for (size_t i = 0; i < tensors[idx].size(); ++i)
+			{
+				Mapped_Tensor & tensor = tensors[idx][i];
+				if (mapped[idx][i] == nullptr)
+				{
+					darknet_fatal_error(DARKNET_LOC, "the memory-mapped weights file %s is missing tensor #%lu for layer #%d", filename, i, idx);
+				}
+
+				if (not tensor.layer->weights_mapped)
+				{
+					free(*tensor.ptr);
+				}
+				*tensor.ptr = mapped[idx][i];
+			}
+
+			// mark the layer (or sublayers) only once every tensor has been replaced, since they all share the one flag
+			for (Mapped_Tensor & tensor : tensors[idx])
+			{
+				tensor.layer->weights_mapped = true;
+			}
+
+			layers_with_weights ++;
 
-			darknet_fatal_error(DARKNET_LOC, "expected to read %lu fields, but only read %lu", count, items_read);
+#ifdef GPU
+			if (cfg_and_state.gpu_index >= 0)
+			{
+				sync_mapped_tensors(net.layers[idx], true);
+			}
+#endif
+		}
+
+		net.details->mapped_weights = mapping;
+
+		if (cfg_and_state.is_verbose)
+		{
+			std::cout << "Mapped weights for " << layers_with_weights << " of " << net.n << " layers from " << filename << " (" << size_to_IEC_string(size) << ")" << std::endl;
 		}
 
 		return;
@@ -291,23 +887,154 @@ void save_weights_upto(const Darknet::Network & net, char *filename, int cutoff,
 			save_connected_weights(*(l.ug), fp);
 			save_connected_weights(*(l.uo), fp);
 		}
-		if (l.type == Darknet::ELayerType::CRNN)
+		if (l.type == Darknet::ELayerType::CRNN)
+		{
+			save_convolutional_weights(*(l.input_layer), fp);
+			save_convolutional_weights(*(l.self_layer), fp);
+			save_convolutional_weights(*(l.output_layer), fp);
+		}
+	}
+	fclose(fp);
+}
+
+void save_weights(const Darknet::Network & net, char *filename)
+{
+	TAT(TATPARMS);
+
+	save_weights_upto(net, filename, net.n, 0);
+}
+
+void save_int8_weights(const Darknet::Network & net, const char * source_weights, const char * filename)
+{
+	TAT(TATPARMS);
+
+	std::cout << "Saving INT8 weights to " << Darknet::in_colour(Darknet::EColour::kBrightMagenta, filename) << std::endl;
+
+	// the FP32 weights are kept as-is so the file still matches the .cfg, and older code can find the INT8 section
+	std::filesystem::copy_file(source_weights, filename, std::filesystem::copy_options::overwrite_existing);
+
+	FILE *fp = fopen(filename, "ab");
+	if (!fp)
+	{
+		file_error(filename, DARKNET_LOC);
+	}
+
+	int32_t count = 0;
+	for (int idx = 0; idx < net.n; ++idx)
+	{
+		if (net.layers[idx].weights_int8)
+		{
+			count ++;
+		}
+	}
+
+	fwrite(int8_weights_signature, 1, sizeof(int8_weights_signature), fp);
+	fwrite(&count, sizeof(int32_t), 1, fp);
+
+	for (int idx = 0; idx < net.n; ++idx)
+	{
+		const Darknet::Layer & l = net.layers[idx];
+		if (l.weights_int8 == nullptr)
 		{
-			save_convolutional_weights(*(l.input_layer), fp);
-			save_convolutional_weights(*(l.self_layer), fp);
-			save_convolutional_weights(*(l.output_layer), fp);
+			continue;
 		}
+
+		const int32_t row_size = (l.size * l.size * l.c + 31) / 32 * 32;
+		const int32_t zero_point = l.input_int8_zero_point;
+		fwrite(&idx					, sizeof(int32_t)	, 1, fp);
+		fwrite(&l.n					, sizeof(int32_t)	, 1, fp);
+		fwrite(&row_size			, sizeof(int32_t)	, 1, fp);
+		fwrite(&l.input_int8_scale	, sizeof(float)		, 1, fp);
+		fwrite(&zero_point			, sizeof(int32_t)	, 1, fp);
+		fwrite(l.weights_int8_scales, sizeof(float)		, l.n, fp);
+		fwrite(l.weights_int8		, sizeof(int8_t)	, static_cast<size_t>(l.n) * row_size, fp);
 	}
+
 	fclose(fp);
 }
 
-void save_weights(const Darknet::Network & net, char *filename)
+
+void save_mapped_weights(Darknet::Network & net, const char * filename)
 {
 	TAT(TATPARMS);
 
-	save_weights_upto(net, filename, net.n, 0);
+#ifdef GPU
+	if (net.gpu_index >= 0)
+	{
+		cuda_set_device(net.gpu_index);
+	}
+	if (cfg_and_state.gpu_index >= 0)
+	{
+		for (int idx = 0; idx < net.n; ++idx)
+		{
+			sync_mapped_tensors(net.layers[idx], false);
+		}
+	}
+#endif
+
+	std::cout << "Saving memory-mapped weights to " << Darknet::in_colour(Darknet::EColour::kBrightMagenta, filename) << std::endl;
+
+	// the mapped weights are used as-is, so batch norm is folded into the convolutional layers once here
+	fuse_conv_batchnorm(net);
+
+	std::vector<Mapped_Weights_Entry> table;
+	std::vector<const float *> data;
+	for (int idx = 0; idx < net.n; ++idx)
+	{
+		const auto tensors = get_mapped_tensors(net.layers[idx]);
+		for (size_t i = 0; i < tensors.size(); ++i)
+		{
+			table.push_back({idx, static_cast<int32_t>(i), tensors[i].count, 0});
+			data.push_back(*tensors[i].ptr);
+		}
+	}
+
+	uint64_t offset = sizeof(Mapped_Weights_Header) + table.size() * sizeof(Mapped_Weights_Entry);
+	for (auto & entry : table)
+	{
+		offset = (offset + mapped_weights_alignment - 1) / mapped_weights_alignment * mapped_weights_alignment;
+		entry.offset = offset;
+		offset += entry.count * sizeof(float);
+	}
+
+	Mapped_Weights_Header header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.signature, mapped_weights_signature, sizeof(header.signature));
+	header.major	= DARKNET_WEIGHTS_VERSION_MAJOR;
+	header.minor	= DARKNET_WEIGHTS_VERSION_MINOR;
+	header.revision	= DARKNET_WEIGHTS_VERSION_PATCH;
+	header.layers	= net.n;
+	header.seen		= *net.seen;
+	header.tensors	= table.size();
+
+	FILE *fp = fopen(filename, "wb");
+	if (!fp)
+	{
+		file_error(filename, DARKNET_LOC);
+	}
+
+	fwrite(&header, sizeof(header), 1, fp);
+	fwrite(table.data(), sizeof(Mapped_Weights_Entry), table.size(), fp);
+
+	// the position is tracked here since ftell() is limited to 2 GiB on some platforms
+	uint64_t position = sizeof(Mapped_Weights_Header) + table.size() * sizeof(Mapped_Weights_Entry);
+
+	// each tensor is written straight from the layer, so nothing is copied
+	const char padding[mapped_weights_alignment] = { 0 };
+	for (size_t i = 0; i < table.size(); ++i)
+	{
+		fwrite(padding, 1, table[i].offset - position, fp);
+		if (fwrite(data[i], sizeof(float), table[i].count, fp) != table[i].count)
+		{
+			darknet_fatal_error(DARKNET_LOC, "failed to write memory-mapped weights to %s", filename);
+		}
+		position = table[i].offset + table[i].count * sizeof(float);
+	}
+
+	fclose(fp);
 }
 
+
 void transpose_matrix(float *a, int rows, int cols)
 {
 	TAT(TATPARMS);
@@ -325,12 +1052,12 @@ void transpose_matrix(float *a, int rows, int cols)
 	free(transpose);
 }
 
-void load_connected_weights(Darknet::Layer & l, FILE *fp, int transpose)
+void load_connected_weights(Darknet::Layer & l, Weights_Source & src, int transpose)
 {
 	TAT(TATPARMS);
 
-	xfread(l.biases, sizeof(float), l.outputs, fp);
-	xfread(l.weights, sizeof(float), l.outputs*l.inputs, fp);
+	src.read(l.biases, sizeof(float), l.outputs);
+	src.read(l.weights, sizeof(float), l.outputs*l.inputs);
 	if (transpose)
 	{
 		transpose_matrix(l.weights, l.inputs, l.outputs);
@@ -339,9 +1066,9 @@ void load_connected_weights(Darknet::Layer & l, FILE *fp, int transpose)
 	//printf("Weights: %f mean %f variance\n", mean_array(l.weights, l.outputs*l.inputs), variance_array(l.weights, l.outputs*l.inputs));
 	if (l.batch_normalize && (!l.dontloadscales))
 	{
-		xfread(l.scales, sizeof(float), l.outputs, fp);
-		xfread(l.rolling_mean, sizeof(float), l.outputs, fp);
-		xfread(l.rolling_variance, sizeof(float), l.outputs, fp);
+		src.read(l.scales, sizeof(float), l.outputs);
+		src.read(l.rolling_mean, sizeof(float), l.outputs);
+		src.read(l.rolling_variance, sizeof(float), l.outputs);
 		//printf("Scales: %f mean %f variance\n", mean_array(l.scales, l.outputs), variance_array(l.scales, l.outputs));
 		//printf("rolling_mean: %f mean %f variance\n", mean_array(l.rolling_mean, l.outputs), variance_array(l.rolling_mean, l.outputs));
 		//printf("rolling_variance: %f mean %f variance\n", mean_array(l.rolling_variance, l.outputs), variance_array(l.rolling_variance, l.outputs));
@@ -354,106 +1081,248 @@ void load_connected_weights(Darknet::Layer & l, FILE *fp, int transpose)
 #endif
 }
 
-void load_batchnorm_weights(Darknet::Layer & l, FILE *fp)
+void load_convolutional_weights(Darknet::Layer & l, Weights_Source & src)
 {
 	TAT(TATPARMS);
 
-	xfread(l.biases, sizeof(float), l.c, fp);
-	xfread(l.scales, sizeof(float), l.c, fp);
-	xfread(l.rolling_mean, sizeof(float), l.c, fp);
-	xfread(l.rolling_variance, sizeof(float), l.c, fp);
+	int num = l.nweights;
+
+	src.read(l.biases, sizeof(float), l.n);
+	if (l.batch_normalize && (!l.dontloadscales))
+	{
+		src.read(l.scales, sizeof(float), l.n);
+		src.read(l.rolling_mean, sizeof(float), l.n);
+		src.read(l.rolling_variance, sizeof(float), l.n);
+	}
+	src.read(l.weights, sizeof(float), num);
+
+	if (l.flipped)
+	{
+		transpose_matrix(l.weights, (l.c/l.groups)*l.size*l.size, l.n);
+	}
+	//if (l.binary) binarize_weights(l.weights, l.n, (l.c/l.groups)*l.size*l.size, l.weights);
 #ifdef GPU
 	if (cfg_and_state.gpu_index >= 0)
 	{
-		push_batchnorm_layer(l);
+		push_convolutional_layer(l);
 	}
 #endif
 }
 
-void load_convolutional_weights_binary(Darknet::Layer & l, FILE *fp)
+void load_shortcut_weights(Darknet::Layer & l, Weights_Source & src)
 {
 	TAT(TATPARMS);
 
-	xfread(l.biases, sizeof(float), l.n, fp);
-	if (l.batch_normalize && (!l.dontloadscales))
-	{
-		xfread(l.scales, sizeof(float), l.n, fp);
-		xfread(l.rolling_mean, sizeof(float), l.n, fp);
-		xfread(l.rolling_variance, sizeof(float), l.n, fp);
-	}
-	int size = (l.c / l.groups)*l.size*l.size;
-	int i, j, k;
-	for (i = 0; i < l.n; ++i)
-	{
-		float mean = 0;
-		xfread(&mean, sizeof(float), 1, fp);
-		for (j = 0; j < size/8; ++j)
-		{
-			int index = i*size + j*8;
-			unsigned char c = 0;
-			xfread(&c, sizeof(char), 1, fp);
-			for (k = 0; k < 8; ++k)
-			{
-				if (j*8 + k >= size) break;
-				l.weights[index + k] = (c & 1<<k) ? mean : -mean;
-			}
-		}
-	}
+	int num = l.nweights;
+
+	src.read(l.weights, sizeof(float), num);
+
+	//for (int i = 0; i < l.nweights; ++i) printf(" %f, ", l.weights[i]);
+	//printf(" read_bytes = %d \n\n", read_bytes);
 #ifdef GPU
 	if (cfg_and_state.gpu_index >= 0)
 	{
-		push_convolutional_layer(l);
+		push_shortcut_layer(l);
 	}
 #endif
 }
 
-void load_convolutional_weights(Darknet::Layer & l, FILE *fp)
+namespace
 {
-	TAT(TATPARMS);
+	static inline size_t convolutional_weights_size(const Darknet::Layer & l)
+	{
+		const size_t batch_norm = (l.batch_normalize and not l.dontloadscales) ? 3 * l.n : 0;
 
-	int num = l.nweights;
+		return sizeof(float) * (l.n + batch_norm + l.nweights);
+	}
 
-	xfread(l.biases, sizeof(float), l.n, fp);
-	if (l.batch_normalize && (!l.dontloadscales))
+
+	static inline size_t connected_weights_size(const Darknet::Layer & l)
 	{
-		xfread(l.scales, sizeof(float), l.n, fp);
-		xfread(l.rolling_mean, sizeof(float), l.n, fp);
-		xfread(l.rolling_variance, sizeof(float), l.n, fp);
+		const size_t batch_norm = (l.batch_normalize and not l.dontloadscales) ? 3 * l.outputs : 0;
+
+		return sizeof(float) * (l.outputs + static_cast<size_t>(l.outputs) * l.inputs + batch_norm);
 	}
-	xfread(l.weights, sizeof(float), num, fp);
 
-	if (l.flipped)
+
+	/// The number of bytes @ref load_layer_weights() reads for this layer.  This must match the load functions above.
+	size_t get_layer_weights_size(const Darknet::Layer & l)
 	{
-		transpose_matrix(l.weights, (l.c/l.groups)*l.size*l.size, l.n);
+		TAT(TATPARMS);
+
+		switch(l.type)
+		{
+			case Darknet::ELayerType::CONVOLUTIONAL:	return (l.share_layer == nullptr ? convolutional_weights_size(l) : 0);
+			case Darknet::ELayerType::SHORTCUT:		return sizeof(float) * l.nweights;
+			case Darknet::ELayerType::CONNECTED:		return connected_weights_size(l);
+			case Darknet::ELayerType::CRNN:			return convolutional_weights_size(*l.input_layer) + convolutional_weights_size(*l.self_layer) + convolutional_weights_size(*l.output_layer);
+			case Darknet::ELayerType::RNN:			return connected_weights_size(*l.input_layer) + connected_weights_size(*l.self_layer) + connected_weights_size(*l.output_layer);
+			case Darknet::ELayerType::LSTM:
+			{
+				size_t size = 0;
+				for (const Darknet::Layer * sublayer : {l.wf, l.wi, l.wg, l.wo, l.uf, l.ui, l.ug, l.uo})
+				{
+					size += connected_weights_size(*sublayer);
+				}
+				return size;
+			}
+			default:
+			{
+				return 0;
+			}
+		}
 	}
-	//if (l.binary) binarize_weights(l.weights, l.n, (l.c/l.groups)*l.size*l.size, l.weights);
-#ifdef GPU
-	if (cfg_and_state.gpu_index >= 0)
+
+
+	/// Load the weights of one layer.  @returns @p false if the layer does not have weights.
+	bool load_layer_weights(Darknet::Layer & l, Weights_Source & src, const int transpose)
 	{
-		push_convolutional_layer(l);
+		TAT(TATPARMS);
+
+		switch(l.type)
+		{
+			case Darknet::ELayerType::CONVOLUTIONAL:
+			{
+				if (l.share_layer == NULL)
+				{
+					load_convolutional_weights(l, src);
+					return true;
+				}
+				return false;
+			}
+			case Darknet::ELayerType::SHORTCUT:
+			{
+				if (l.nweights > 0)
+				{
+					load_shortcut_weights(l, src);
+					return true;
+				}
+				return false;
+			}
+			case Darknet::ELayerType::CONNECTED:
+			{
+				load_connected_weights(l, src, transpose);
+				return true;
+			}
+			case Darknet::ELayerType::CRNN:
+			{
+				load_convolutional_weights(*(l.input_layer), src);
+				load_convolutional_weights(*(l.self_layer), src);
+				load_convolutional_weights(*(l.output_layer), src);
+				return true;
+			}
+			case Darknet::ELayerType::RNN:
+			{
+				load_connected_weights(*(l.input_layer), src, transpose);
+				load_connected_weights(*(l.self_layer), src, transpose);
+				load_connected_weights(*(l.output_layer), src, transpose);
+				return true;
+			}
+			case Darknet::ELayerType::LSTM:
+			{
+				load_connected_weights(*(l.wf), src, transpose);
+				load_connected_weights(*(l.wi), src, transpose);
+				load_connected_weights(*(l.wg), src, transpose);
+				load_connected_weights(*(l.wo), src, transpose);
+				load_connected_weights(*(l.uf), src, transpose);
+				load_connected_weights(*(l.ui), src, transpose);
+				load_connected_weights(*(l.ug), src, transpose);
+				load_connected_weights(*(l.uo), src, transpose);
+				return true;
+			}
+			default:
+			{
+				// this layer does not have weights to load
+				return false;
+			}
+		}
 	}
-#endif
 }
 
-void load_shortcut_weights(Darknet::Layer & l, FILE *fp)
+
+std::shared_ptr<Weights_Prefetch> prefetch_weights(const char * filename)
 {
 	TAT(TATPARMS);
 
-	int num = l.nweights;
+	if (filename == nullptr or filename[0] == '\0')
+	{
+		return nullptr;
+	}
 
-	xfread(l.weights, sizeof(float), num, fp);
+	// any problems with the file are reported later by load_weights()
+	std::error_code ec;
+	const auto filesize = std::filesystem::file_size(filename, ec);
+	FILE *fp = (ec ? nullptr : fopen(filename, "rb"));
+	if (fp == nullptr)
+	{
+		return nullptr;
+	}
 
-	//for (int i = 0; i < l.nweights; ++i) printf(" %f, ", l.weights[i]);
-	//printf(" read_bytes = %d \n\n", read_bytes);
-#ifdef GPU
-	if (cfg_and_state.gpu_index >= 0)
+	// memory-mapped weights are not read at all
+	char signature[sizeof(mapped_weights_signature)] = { 0 };
+	if (std::fread(signature, 1, sizeof(signature), fp) == sizeof(signature) and
+		std::memcmp(signature, mapped_weights_signature, sizeof(signature)) == 0)
 	{
-		push_shortcut_layer(l);
+		fclose(fp);
+		return nullptr;
 	}
-#endif
+	std::rewind(fp);
+
+	auto prefetch = std::make_shared<Weights_Prefetch>();
+	prefetch->filename	= filename;
+	prefetch->size		= filesize;
+
+	prefetch->reader = std::thread([p = prefetch.get(), fp]()
+	{
+		cfg_and_state.set_thread_name("weights prefetch thread");
+
+		size_t position = 0;
+		while (position < p->size)
+		{
+			if (true)
+			{
+				// wait for the readers to release a chunk once the window is full
+				std::unique_lock lock(p->mutex);
+				p->cv.wait(lock, [&]() { return p->cancelled or p->chunks.size() < Weights_Prefetch::window_chunks; });
+				if (p->cancelled)
+				{
+					break;
+				}
+			}
+
+			std::unique_ptr<uint8_t[]> chunk(new uint8_t[Weights_Prefetch::chunk_size]);
+			const size_t bytes_read = std::fread(chunk.get(), 1, std::min(Weights_Prefetch::chunk_size, p->size - position), fp);
+			if (bytes_read == 0)
+			{
+				break;
+			}
+			position += bytes_read;
+
+			std::lock_guard lock(p->mutex);
+			p->chunks.push_back(std::move(chunk));
+			p->available = position;
+			p->cv.notify_all();
+
+			if (bytes_read < Weights_Prefetch::chunk_size and position < p->size)
+			{
+				// a short read means the rest of the file cannot be read, and the chunks must stay aligned
+				break;
+			}
+		}
+		fclose(fp);
+
+		std::lock_guard lock(p->mutex);
+		p->done = true;
+		p->cv.notify_all();
+
+		cfg_and_state.del_thread_name();
+	});
+
+	return prefetch;
 }
 
-void load_weights_upto(Darknet::Network * net, const char * filename, int cutoff)
+
+void load_weights_upto(Darknet::Network * net, const char * filename, int cutoff, std::shared_ptr<Weights_Prefetch> prefetch)
 {
 	TAT(TATPARMS);
 
@@ -484,31 +1353,52 @@ void load_weights_upto(Darknet::Network * net, const char * filename, int cutoff
 	}
 #endif
 
-	FILE *fp = fopen(filename, "rb");
-	if (!fp)
+	if (prefetch and prefetch->filename != filename)
 	{
-		file_error(filename, DARKNET_LOC);
+		prefetch.reset();
+	}
+
+	FILE *fp = nullptr;
+	if (not prefetch)
+	{
+		fp = fopen(filename, "rb");
+		if (!fp)
+		{
+			file_error(filename, DARKNET_LOC);
+		}
+
+		char signature[sizeof(mapped_weights_signature)] = { 0 };
+		if (std::fread(signature, 1, sizeof(signature), fp) == sizeof(signature) and
+			std::memcmp(signature, mapped_weights_signature, sizeof(signature)) == 0)
+		{
+			fclose(fp);
+			load_mapped_weights(*net, filename, cutoff);
+			return;
+		}
+		std::rewind(fp);
 	}
 
+	Weights_Source src = (fp ? Weights_Source(fp) : Weights_Source(*prefetch, 0, prefetch->size));
+
 	int major;
 	int minor;
 	int revision;
-	xfread(&major	, sizeof(int), 1, fp);
-	xfread(&minor	, sizeof(int), 1, fp);
-	xfread(&revision, sizeof(int), 1, fp);
+	src.read(&major		, sizeof(int), 1);
+	src.read(&minor		, sizeof(int), 1);
+	src.read(&revision	, sizeof(int), 1);
 
 	if ((major * 10 + minor) >= 2)
 	{
 //		printf("\n seen 64");
 		uint64_t iseen = 0;
-		xfread(&iseen, sizeof(uint64_t), 1, fp);
+		src.read(&iseen, sizeof(uint64_t), 1);
 		*net->seen = iseen;
 	}
 	else
 	{
 //		printf("\n seen 32");
 		uint32_t iseen = 0;
-		xfread(&iseen, sizeof(uint32_t), 1, fp);
+		src.read(&iseen, sizeof(uint32_t), 1);
 		*net->seen = iseen;
 	}
 
@@ -518,86 +1408,74 @@ void load_weights_upto(Darknet::Network * net, const char * filename, int cutoff
 
 	size_t layers_with_weights = 0;
 
-	for (int i = 0; i < net->n && i < cutoff; ++i)
+	if (prefetch)
 	{
-		Darknet::Layer & l = net->layers[i];
-		if (l.dontload)
+		// the size of every layer is known, so each layer can be loaded as soon as its part of the file has been read
+		std::vector<int> layers;
+		std::vector<size_t> offsets;
+		size_t offset = src.position();
+		for (int i = 0; i < net->n && i < cutoff; ++i)
 		{
-			continue;
+			const size_t bytes = (net->layers[i].dontload ? 0 : get_layer_weights_size(net->layers[i]));
+			if (bytes > 0)
+			{
+				layers.push_back(i);
+				offsets.push_back(offset);
+				offset += bytes;
+			}
 		}
+		offsets.push_back(offset);
 
-		switch(l.type)
+		if (offset > prefetch->size)
 		{
-			case Darknet::ELayerType::CONVOLUTIONAL:
-			{
-				if (l.share_layer == NULL)
-				{
-					layers_with_weights ++;
-					load_convolutional_weights(l, fp);
-				}
-				break;
-			}
-			case Darknet::ELayerType::SHORTCUT:
-			{
-				if (l.nweights > 0)
-				{
-					layers_with_weights ++;
-					load_shortcut_weights(l, fp);
-				}
-				break;
-			}
-			case Darknet::ELayerType::CONNECTED:
-			{
-				layers_with_weights ++;
-				load_connected_weights(l, fp, transpose);
-				break;
-			}
-			case Darknet::ELayerType::CRNN:
-			{
-				layers_with_weights ++;
-				load_convolutional_weights(*(l.input_layer), fp);
-				load_convolutional_weights(*(l.self_layer), fp);
-				load_convolutional_weights(*(l.output_layer), fp);
-				break;
-			}
-			case Darknet::ELayerType::RNN:
+			weights_too_short(offset, prefetch->size, "bytes");
+		}
+
+		// every layer is registered before the main source moves past them, so no part of the file is released too soon
+		std::vector<std::unique_ptr<Weights_Source>> layer_sources;
+		for (size_t j = 0; j < layers.size(); ++j)
+		{
+			layer_sources.emplace_back(std::make_unique<Weights_Source>(*prefetch, offsets[j], offsets[j + 1]));
+		}
+		src.seek(offset);
+
+		// layers are pushed to the GPU as they are loaded, which must not happen from several threads at once
+		#pragma omp parallel for schedule(dynamic, 1) if (cfg_and_state.gpu_index < 0)
+		for (int j = 0; j < static_cast<int>(layers.size()); ++j)
+		{
+			load_layer_weights(net->layers[layers[j]], *layer_sources[j], transpose);
+			layer_sources[j].reset();
+		}
+
+		layers_with_weights = layers.size();
+	}
+	else
+	{
+		for (int i = 0; i < net->n && i < cutoff; ++i)
+		{
+			Darknet::Layer & l = net->layers[i];
+			if (l.dontload or not load_layer_weights(l, src, transpose))
 			{
-				layers_with_weights ++;
-				load_connected_weights(*(l.input_layer), fp, transpose);
-				load_connected_weights(*(l.self_layer), fp, transpose);
-				load_connected_weights(*(l.output_layer), fp, transpose);
-				break;
+				continue;
 			}
-			case Darknet::ELayerType::LSTM:
+
+			layers_with_weights ++;
+
+			if (src.eof())
 			{
-				layers_with_weights ++;
-				load_connected_weights(*(l.wf), fp, transpose);
-				load_connected_weights(*(l.wi), fp, transpose);
-				load_connected_weights(*(l.wg), fp, transpose);
-				load_connected_weights(*(l.wo), fp, transpose);
-				load_connected_weights(*(l.uf), fp, transpose);
-				load_connected_weights(*(l.ui), fp, transpose);
-				load_connected_weights(*(l.ug), fp, transpose);
-				load_connected_weights(*(l.uo), fp, transpose);
+				Darknet::display_warning_msg("premature end-of-file reached while loading weights " + std::string(filename) + "\n");
 				break;
 			}
-			default:
-			{
-				// this layer does not have weights to load
-				continue;
-			}
-		}
-
-		if (feof(fp))
-		{
-			Darknet::display_warning_msg("premature end-of-file reached while loading weights " + std::string(filename) + "\n");
-			break;
 		}
 	}
 
-	// if everything has gone well, there will be zero bytes left to read at this point
-	const auto position = ftell(fp);
-	const auto filesize = std::filesystem::file_size(filename);
+	// if everything has gone well, there will be zero bytes left to read at this point (or only the INT8 section)
+	auto position = src.position();
+	const auto filesize = (prefetch ? prefetch->size : std::filesystem::file_size(filename));
+	if (position != filesize and cutoff >= net->n and load_int8_weights(*net, src))
+	{
+		position = src.position();
+	}
 	if (position != filesize and cutoff >= net->n)
 	{
 		Darknet::display_warning_msg(
@@ -612,7 +1490,10 @@ void load_weights_upto(Darknet::Network * net, const char * filename, int cutoff
 		std::cout << "Loaded weights for " << layers_with_weights << " of " << net->n << " layers from " << filename << std::endl;
 	}
 
-	fclose(fp);
+	if (fp)
+	{
+		fclose(fp);
+	}
 
 	return;
 }
@@ -636,15 +1517,16 @@ DarknetNetworkPtr load_network_custom(const char * cfg, const char * weights, in
 		std::cout << "Loading configuration from \"" << cfg << "\"" << std::endl;
 	}
 
+	// the weights are read on a background thread while the network is being created
+	auto prefetch = prefetch_weights(weights);
+
 	Darknet::Network * net = (Darknet::Network*)xcalloc(1, sizeof(Darknet::Network));
 	*net = parse_network_cfg_custom(cfg, batch, 1);
-	load_weights(net, weights);
-	fuse_conv_batchnorm(*net);
+	load_weights_upto(net, weights, net->n, prefetch);
+	prefetch.reset();
 
-	/** @todo V3 Some code seems to also call this next function, and some not.  This was not originally called here, but
-	 * I copied it from several other code locations.  Need to invetigate whether or not it should be here.  2024-08-03
-	 */
-	calculate_binary_weights(net);
+	// layer outputs are only shared when the .cfg file asks for it, since callers may read any layer after predicting
+	prepare_network_for_inference(*net, net->details->share_layer_outputs);
 
 	if (clear)
 	{
@@ -666,9 +1548,13 @@ DarknetNetworkPtr load_network(const char * cfg, const char * weights, int clear
 		std::cout << "Loading configuration from \"" << cfg << "\"" << std::endl;
 	}
 
+	// the weights are read on a background thread while the network is being created
+	auto prefetch = prefetch_weights(weights);
+
 	Darknet::Network* net = (Darknet::Network*)xcalloc(1, sizeof(Darknet::Network));
 	*net = parse_network_cfg(cfg);
-	load_weights(net, weights);
+	load_weights_upto(net, weights, net->n, prefetch);
+	prefetch.reset();
 
 	/// @todo V3 why do we not call fuse_conv_batchnorm() here?
 
@@ -9,8 +9,38 @@ Darknet::Network parse_network_cfg_custom(const char * filename, int batch, int
 void save_weights		(const Darknet::Network & net, char *filename);
 void save_weights_upto	(const Darknet::Network & net, char *filename, int cutoff, int save_ema);
 
+struct Weights_Prefetch;
+
+/** Start reading a .weights file on a background thread, using large sequential reads and a small read-ahead window.
+ * Call this before the network is created, and then pass the result to @ref load_weights_upto() so the layers can be
+ * loaded in parallel as soon as their part of the file has been read.  Returns @p nullptr for memory-mapped weights,
+ * which do not need to be read, and when the file cannot be opened (the error is then reported by
+ * @ref load_weights_upto()).
+ *
+ * @since 2026-10-17
+ */
+std::shared_ptr<Weights_Prefetch> prefetch_weights(const char * filename);
+
 void load_weights		(Darknet::Network * net, const char * filename);
-void load_weights_upto	(Darknet::Network * net, const char * filename, int cutoff);
+void load_weights_upto	(Darknet::Network * net, const char * filename, int cutoff, std::shared_ptr<Weights_Prefetch> prefetch = nullptr);
+
+/** Copy the FP32 @p source_weights to @p filename and append the INT8 weights of every quantized convolutional layer,
+ * see @ref quantize_convolutional_layer().  The INT8 section is loaded automatically by @ref load_weights().
+ * @since 2026-10-17
+ */
+void save_int8_weights(const Darknet::Network & net, const char * source_weights, const char * filename);
+
+/** Save the weights in a format which can be memory-mapped.  The file starts with a header and a table of every
+ * tensor, followed by the tensors themselves, each aligned on a 64-byte boundary.  Batch norm is folded into the
+ * convolutional layers before saving, so this modifies @p net.
+ *
+ * The format is detected automatically by @ref load_weights(), which then points the layer weights directly into the
+ * mapped file instead of reading them.  Loading is nearly instant, and processes which use the same file share the
+ * same pages of memory.
+ *
+ * @since 2026-10-17
+ */
+void save_mapped_weights(Darknet::Network & net, const char * filename);
 
 
 namespace Darknet
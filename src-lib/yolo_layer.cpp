@@ -1,5 +1,11 @@
 #include "darknet_internal.hpp"
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 namespace
 {
 	static auto & cfg_and_state = Darknet::CfgAndState::get();
@@ -915,6 +921,13 @@ void forward_yolo_layer(Darknet::Layer & l, Darknet::NetworkState state)
 	memcpy(l.output, state.input, l.outputs * l.batch * sizeof(float));
 
 #ifndef GPU
+	// when inferring, the class values only need to be activated for the few cells which pass the objectness threshold
+	const bool lazy_classes =
+		not state.train			and
+		not l.new_coords		and
+		state.net.details		and
+		state.net.details->lazy_class_activation;
+
 	for (int b = 0; b < l.batch; ++b)
 	{
 		for (int n = 0; n < l.n; ++n)
@@ -928,19 +941,20 @@ void forward_yolo_layer(Darknet::Layer & l, Darknet::NetworkState state)
 			{
 				activate_array(l.output + bbox_index, 2 * l.w*l.h, LOGISTIC);        // x,y,
 				int obj_index = yolo_entry_index(l, b, n*l.w*l.h, 4);
-				activate_array(l.output + obj_index, (1 + l.classes)*l.w*l.h, LOGISTIC);
+				activate_array(l.output + obj_index, (lazy_classes ? 1 : 1 + l.classes)*l.w*l.h, LOGISTIC);
 			}
 			scal_add_cpu(2 * l.w*l.h, l.scale_x_y, -0.5*(l.scale_x_y - 1), l.output + bbox_index, 1);    // scale x,y
 		}
 	}
+	l.yolo_classes_pending = (lazy_classes ? 1 : 0);
 #endif
 
-	// delta is zeroed
-	memset(l.delta, 0, l.outputs * l.batch * sizeof(float));
+	// delta is only used when training
 	if (!state.train)
 	{
 		return;
 	}
+	memset(l.delta, 0, l.outputs * l.batch * sizeof(float));
 
 	for (int i = 0; i < l.batch * l.w*l.h*l.n; ++i)
 	{
@@ -970,10 +984,6 @@ void forward_yolo_layer(Darknet::Layer & l, Darknet::NetworkState state)
 	int class_count = 0;
 	*(l.cost) = 0;
 
-	int num_threads = l.batch;
-	Darknet::VThreads threads;
-	threads.reserve(num_threads);
-
 	struct train_yolo_args * yolo_args = (train_yolo_args*)xcalloc(l.batch, sizeof(struct train_yolo_args));
 
 	for (int b = 0; b < l.batch; b++)
@@ -987,14 +997,16 @@ void forward_yolo_layer(Darknet::Layer & l, Darknet::NetworkState state)
 		yolo_args[b].tot_giou_loss = 0;
 		yolo_args[b].count = 0;
 		yolo_args[b].class_count = 0;
-
-		threads.emplace_back(process_batch, &(yolo_args[b]));
 	}
 
-	for (int b = 0; b < l.batch; b++)
+	// the worker threads are re-used for every YOLO layer and every iteration instead of starting new threads each time
+	Darknet::WorkerPool::get().run(l.batch, [&](const size_t b)
 	{
-		threads[b].join();
+		process_batch(&(yolo_args[b]));
+	});
 
+	for (int b = 0; b < l.batch; b++)
+	{
 		tot_iou += yolo_args[b].tot_iou;
 		tot_iou_loss += yolo_args[b].tot_iou_loss;
 		tot_giou_loss += yolo_args[b].tot_giou_loss;
@@ -1223,6 +1235,44 @@ void forward_yolo_layer(Darknet::Layer & l, Darknet::NetworkState state)
 	}
 }
 
+
+void forward_yolo_layer_nhwc(Darknet::Layer & l, Darknet::NetworkState state)
+{
+	TAT(TATPARMS);
+
+	// the YOLO output and everything which reads it is planar, so this is where channels-last data is converted back
+	static thread_local std::vector<float> planar;
+	planar.resize(static_cast<size_t>(l.inputs) * l.batch);
+	nhwc_to_nchw(state.input, planar.data(), l.batch, l.c, l.h, l.w);
+
+	state.input = planar.data();
+	forward_yolo_layer(l, state);
+}
+
+void activate_yolo_classes(Darknet::Layer & l)
+{
+	TAT(TATPARMS);
+
+	if (l.type != Darknet::ELayerType::YOLO or not l.yolo_classes_pending)
+	{
+		return;
+	}
+
+	for (int b = 0; b < l.batch; ++b)
+	{
+		for (int n = 0; n < l.n; ++n)
+		{
+			const int class_index = yolo_entry_index(l, b, n * l.w * l.h, 4 + 1);
+			activate_array(l.output + class_index, l.classes * l.w * l.h, LOGISTIC);
+		}
+	}
+
+	l.yolo_classes_pending = 0;
+
+	return;
+}
+
+
 void backward_yolo_layer(Darknet::Layer & l, Darknet::NetworkState state)
 {
 	TAT(TATPARMS);
@@ -1329,31 +1379,68 @@ int yolo_num_detections_v3(Darknet::Network * net, const int index, const float
 	// IMPORTANT:  note the object cache is NOT cleared here.  Because there may be multiple YOLO layers within a network,
 	// we only want to append to the cache, not overwrite previous entries from earlier YOLO layers.
 
-	int count = 0;
+	const size_t original_size = cache.size();
 
 	const Darknet::Layer & l = net->layers[index];
+	const int plane_size = l.w * l.h;
 
 	for (int n = 0; n < l.n; ++n)
 	{
-		for (int i = 0; i < l.w * l.h; ++i)
+		// the objectness values for each anchor are stored contiguously, so scan them as a single array
+		const int plane_index = yolo_entry_index(l, 0, n * plane_size, 4);
+		const float * objectness = l.output + plane_index;
+
+		// remember the location of each object so we don't have to walk through the array again
+		const auto remember = [&](const int i)
 		{
-			const int obj_index = yolo_entry_index(l, 0, n * l.w * l.h + i, 4);
-			if (l.output[obj_index] > thresh)
-			{
-				++count;
+			cache.push_back({index, n, i, plane_index + i});
+		};
 
-				// remember the location of this object so we don't have to walk through the array again
-				Darknet::Output_Object oo;
-				oo.layer_index = index;
-				oo.n = n;
-				oo.i = i;
-				oo.obj_index = obj_index;
-				cache.push_back(oo);
+		int i = 0;
+#if defined(__AVX__)
+		const __m256 threshold = _mm256_set1_ps(thresh);
+		for (; i + 8 <= plane_size; i += 8)
+		{
+			// ordered comparison so NaN is never considered to be an object, same as the scalar "objectness > thresh"
+			const int mask = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(objectness + i), threshold, _CMP_GT_OQ));
+			if (mask)
+			{
+				for (int j = 0; j < 8; ++j)
+				{
+					if (mask & (1 << j))
+					{
+						remember(i + j);
+					}
+				}
+			}
+		}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+		const float32x4_t threshold = vdupq_n_f32(thresh);
+		for (; i + 4 <= plane_size; i += 4)
+		{
+			const uint32x4_t gt = vcgtq_f32(vld1q_f32(objectness + i), threshold);
+			if (vmaxvq_u32(gt))
+			{
+				for (int j = 0; j < 4; ++j)
+				{
+					if (objectness[i + j] > thresh)
+					{
+						remember(i + j);
+					}
+				}
+			}
+		}
+#endif
+		for (; i < plane_size; ++i)
+		{
+			if (objectness[i] > thresh)
+			{
+				remember(i);
 			}
 		}
 	}
 
-	return count;
+	return static_cast<int>(cache.size() - original_size);
 }
 
 
@@ -1460,7 +1547,8 @@ int get_yolo_detections_v3(Darknet::Network * net, int w, int h, int netw, int n
 		for (int j = 0; j < l.classes; ++j)
 		{
 			const int class_index = yolo_entry_index(l, 0, n * l.w * l.h + i, 4 + 1 + j);
-			const float prob = objectness * predictions[class_index];
+			const float confidence = l.yolo_classes_pending ? logistic_activate(predictions[class_index]) : predictions[class_index];
+			const float prob = objectness * confidence;
 			dets[count].prob[j] = (prob > thresh) ? prob : 0.0f;
 		}
 		++count;
@@ -1627,13 +1715,15 @@ Darknet::MMats Darknet::create_yolo_heatmaps(Darknet::NetworkPtr ptr, const floa
 	// look through all the layers to find the YOLO ones
 	for (int layer_index = 0; layer_index < net->n; layer_index ++)
 	{
-		const Darknet::Layer & l = net->layers[layer_index];
+		Darknet::Layer & l = net->layers[layer_index];
 		if (l.type != Darknet::ELayerType::YOLO)
 		{
 			// not YOLO...keep looking for another layer
 			continue;
 		}
 
+		activate_yolo_classes(l);
+
 //		Darknet::dump(l);
 
 		for (int n = 0; n < l.n; ++n) // anchors?
@@ -4,7 +4,17 @@
 
 Darknet::Layer make_yolo_layer(int batch, int w, int h, int n, int total, int *mask, int classes, int max_boxes);
 void forward_yolo_layer(Darknet::Layer & l, Darknet::NetworkState state);
+void forward_yolo_layer_nhwc(Darknet::Layer & l, Darknet::NetworkState state); ///< @see @ref prepare_channels_last()  @since 2026-10-17
 void backward_yolo_layer(Darknet::Layer & l, Darknet::NetworkState state);
+
+/** When the network has @p lazy_class_activation=1, the CPU forward pass of a @p [yolo] layer leaves the class values
+ * in @p l.output as they came from the previous layer.  Call this before reading the class values of every cell, such
+ * as when all the detections are extracted without the objectness cache used by @p get_yolo_detections_v3().  Nothing
+ * is done if the classes have already been activated.
+ *
+ * @since 2026-10-17
+ */
+void activate_yolo_classes(Darknet::Layer & l);
 void resize_yolo_layer(Darknet::Layer *l, int w, int h);
 int yolo_num_detections(const Darknet::Layer & l, float thresh);
 int yolo_num_detections_batch(const Darknet::Layer & l, float thresh, int batch);
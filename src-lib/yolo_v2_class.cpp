@@ -151,7 +151,7 @@ Detector::Detector(std::string cfg_filename, std::string weight_filename, int gp
 	}
 	set_batch_network(&net, batch_size);
 	net.gpu_index = cur_gpu_id;
-	fuse_conv_batchnorm(net);
+	prepare_network_for_inference(net);
 
 	Darknet::Layer & l = net.layers[net.n - 1];
 	int j;